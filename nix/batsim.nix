@@ -2,6 +2,7 @@
 , cppMesonDevBase
 , meson, ninja, pkg-config
 , simgrid, intervalset, boost, rapidjson, zeromq, pugixml, batprotocol-cpp, cli11, gtest
+, zlib, zstd
 , doInternalTests ? true
 , debug ? false
 , werror ? false
@@ -37,6 +38,8 @@
     pugixml
     batprotocol-cpp
     cli11
+    zlib
+    zstd
   ];
   buildInputs = [
     boost
@@ -40,11 +40,13 @@
 #include "jobs.hpp"
 #include "jobs_execution.hpp"
 #include "machines.hpp"
+#include "object_pool.hpp"
 #include "profiles.hpp"
 #include "protocol.hpp"
 #include "server.hpp"
 #include "task_execution.hpp"
 #include "workload.hpp"
+#include "workload_cache.hpp"
 #include "workflow.hpp"
 
 using namespace std;
@@ -76,6 +78,7 @@ void configure_batsim_logging_output(const MainArguments & main_args)
     vector<string> log_categories_to_set = {
         "batsim",
         "edc",
+        "edc_record",
         "events",
         "event_submitter",
         "export",
@@ -84,13 +87,17 @@ void configure_batsim_logging_output(const MainArguments & main_args)
         "jobs_execution",
         "job_submitter",
         "machines",
+        "object_pool",
         "profiles",
+        "progress",
         "protocol",
         "pstate",
         "server",
+        "server_profiler",
         "task_execution",
         "workflow",
-        "workload"
+        "workload",
+        "workload_cache"
     };
     string log_threshold_to_set = "critical";
 
@@ -133,6 +140,7 @@ void load_workloads_and_workflows(const MainArguments & main_args, BatsimContext
     {
         XBT_INFO("Workload '%s' corresponds to workload file '%s'.", desc.name.c_str(), desc.filename.c_str());
         Workload * workload = Workload::new_static_workload(desc.name, desc.filename);
+        workload->job_materialization_window = static_cast<long double>(main_args.job_materialization_window);
 
         int nb_machines_in_workload = -1;
         workload->load_from_json(desc.filename, nb_machines_in_workload);
@@ -266,7 +274,7 @@ int main(int argc, char * argv[])
 
     parse_main_args(argc, argv, main_args, return_code, run_simulation, only_print_information);
 
-    // Print the requested information and exit if this is requested by user
+    // Print the requested information (or compile workloads) and exit if this is requested by user
     if (only_print_information)
     {
         if (main_args.print_simgrid_version)
@@ -294,6 +302,14 @@ int main(int argc, char * argv[])
             printf("Printing SimGrid git commit is not implemented.\n");
             return_code = 1;
         }
+        else if (main_args.compile_workloads)
+        {
+            configure_batsim_logging_output(main_args);
+            for (const auto & desc : main_args.workload_descriptions)
+            {
+                WorkloadCache::compile(desc.filename, WorkloadCache::cache_filename(desc.filename), desc.name);
+            }
+        }
 
         fflush(stdout);
     }
@@ -304,11 +320,15 @@ int main(int argc, char * argv[])
     // Let's configure how Batsim should be logged
     configure_batsim_logging_output(main_args);
 
-    // Initialize the energy plugin before creating the engine
+    // Initialize the energy plugins before creating the engine
     if (main_args.host_energy_used)
     {
         sg_host_energy_plugin_init();
     }
+    if (main_args.link_energy_used)
+    {
+        sg_link_energy_plugin_init();
+    }
 
     // Instantiate SimGrid
     simgrid::s4u::Engine engine(&argc, argv);
@@ -364,8 +384,19 @@ int main(int argc, char * argv[])
 
     if (main_args.program_type == ProgramType::BATSIM)
     {
-        context.edc_json_format = main_args.edc_json_format;
-        if (!main_args.edc_socket_endpoint.empty())
+        if (!main_args.edc_replay_filename.empty())
+        {
+            // Serve the decisions of a previous simulation, in the message format they have been recorded in
+            auto replayer = new EDCDecisionReplayer(main_args.edc_replay_filename);
+            main_args.edc_json_format = replayer->json_format();
+            context.edc = ExternalDecisionComponent::new_replay(replayer);
+        }
+        else if (edc_shm::is_shm_endpoint(main_args.edc_socket_endpoint))
+        {
+            // Connect to a local EDC process via shared memory
+            context.edc = ExternalDecisionComponent::new_shared_memory_process(main_args.edc_socket_endpoint);
+        }
+        else if (!main_args.edc_socket_endpoint.empty())
         {
             // Create a ZeroMQ context
             context.zmq_context = zmq_ctx_new();
@@ -379,6 +410,8 @@ int main(int argc, char * argv[])
             context.edc = ExternalDecisionComponent::new_library(main_args.edc_library_path, main_args.edc_library_load_method);
         }
 
+        context.edc_json_format = main_args.edc_json_format;
+
         // Generate initialization flags
         uint8_t flags = 0;
         if (main_args.edc_json_format)
@@ -387,6 +420,11 @@ int main(int argc, char * argv[])
             flags |= 0x1;
         context.edc->init((const uint8_t*)main_args.edc_init_buffer.data(), main_args.edc_init_buffer.size(), flags);
 
+        if (!main_args.edc_record_filename.empty())
+        {
+            context.edc_recorder = new EDCDecisionRecorder(main_args.edc_record_filename, flags);
+        }
+
         // Create the protocol message manager
         context.proto_msg_builder = new batprotocol::MessageBuilder(true);
 
@@ -402,6 +440,12 @@ int main(int argc, char * argv[])
     // Simulation main loop, handled by s4u
     engine.run();
 
+    // Show how many allocations have been saved by recycling inter-actor messages
+    log_object_pool_statistics();
+
+    delete context.edc_recorder;
+    context.edc_recorder = nullptr;
+
     delete context.edc;
     context.edc = nullptr;
 
@@ -444,11 +488,22 @@ void set_configuration(BatsimContext *context,
     context->export_prefix = main_args.export_prefix;
     context->workflow_nb_concurrent_jobs_limit = main_args.workflow_nb_concurrent_jobs_limit;
     context->energy_used = main_args.host_energy_used;
+    context->link_energy_used = main_args.link_energy_used;
     context->allow_compute_sharing = false;
     context->allow_storage_sharing = false;
     context->trace_schedule = main_args.enable_schedule_tracing;
     context->trace_machine_states = main_args.enable_machine_state_tracing;
+    context->trace_jobs = !main_args.disable_jobs_tracing;
+    context->trace_server_profile = main_args.enable_server_profile_tracing;
+    context->async_outputs = main_args.enable_async_outputs;
+    context->columnar_outputs = main_args.enable_columnar_outputs;
+    context->output_compression = main_args.output_compression;
     context->simulation_start_time = chrono::high_resolution_clock::now();
+    context->log_sampler.set_period(main_args.log_sampling_period);
+    if (main_args.progress_period > 0)
+    {
+        context->progress_reporter.enable(main_args.progress_period);
+    }
     context->terminate_with_last_workflow = main_args.terminate_with_last_workflow;
 
     // **************************************************************************************
@@ -200,6 +200,16 @@ void parse_main_args(int argc, char * argv[], MainArguments & main_args, int & r
         ->option_text("<file>...")
         ->check(CLI::ExistingFile);
 
+    app.add_option("--job-materialization-window", main_args.job_materialization_window, "")
+        ->group(input_group_name)
+        ->option_text("<duration>")
+        ->description("Read workload jobs during the simulation, <duration> seconds of simulated time before their submission, instead of building them all at startup\nJobs must be sorted by 'subtime' in workload files, up to <duration>\nWithout an up-to-date workload cache, startup still reads the whole workload file once to load its profiles\nNegative values (default) disable this");
+
+    app.add_flag("--compile-workload", main_args.compile_workloads, "")
+        ->group(input_group_name)
+        ->configurable(false)
+        ->description("Compile the workloads given with -w into binary caches (<file>.cache) and exit\nUp-to-date caches are then automatically used instead of their JSON workload");
+
     // Output
     const std::string output_group_name = "Output options";
     app.add_option("-e,--export", main_args.export_prefix, "The export filename prefix used to generate simulation outputs. Default: out/")
@@ -212,6 +222,25 @@ void parse_main_args(int argc, char * argv[], MainArguments & main_args, int & r
     app.add_flag("--trace-pstate-change", main_args.enable_pstate_change_tracing, "Enable the generation of output file that traces machine pstate changes over time")
         ->group(output_group_name);
 
+    app.add_flag("--disable-jobs-tracing", main_args.disable_jobs_tracing, "Disable the generation of the jobs output file. Schedule metrics (including quantiles) are still computed")
+        ->group(output_group_name);
+
+    app.add_flag("--trace-server-profile", main_args.enable_server_profile_tracing, "Enable the generation of output file that profiles the wall-clock time spent in each server message handler and phase")
+        ->group(output_group_name);
+
+    app.add_flag("--async-outputs", main_args.enable_async_outputs, "Write output files from dedicated I/O threads, so that disk writes do not stall the simulation")
+        ->group(output_group_name);
+
+    app.add_flag("--columnar-outputs", main_args.enable_columnar_outputs, "Write the jobs, machine states and energy outputs as columnar binary files (.batcol) instead of CSV files. tools/batcol.py reads them")
+        ->group(output_group_name);
+
+    std::map<std::string, CompressionCodec> compression_map{{"none", CompressionCodec::NONE}, {"gzip", CompressionCodec::GZIP}, {"zstd", CompressionCodec::ZSTD}};
+    app.add_option("--output-compression", main_args.output_compression, "")
+        ->group(output_group_name)
+        ->option_text("<codec>")
+        ->description("Compress the output traces on the fly (schedule.trace and CSV traces, except schedule.csv). Accepted values: {none, gzip, zstd}\nCompressed files get the .gz or .zst extension. Default: none")
+        ->transform(CLI::CheckedTransformer(compression_map, CLI::ignore_case));
+
     ProbeTracingStrategy probe_tracing_strategy = ProbeTracingStrategy::AS_PROBE_REQUESTED;
     std::map<std::string, ProbeTracingStrategy> pts_map{{"always", ProbeTracingStrategy::ALWAYS}, {"never", ProbeTracingStrategy::NEVER}, {"auto", ProbeTracingStrategy::AS_PROBE_REQUESTED}};
     app.add_option("--trace-probe-data", probe_tracing_strategy, "")
@@ -238,7 +267,7 @@ void parse_main_args(int argc, char * argv[], MainArguments & main_args, int & r
     app.add_option("-s,--edc-socket-str", edc_socket_strings, "")
         ->group(edc_group_name)
         ->option_text("(<socket-endpoint> <json-format-bool> <init-str>)...")
-        ->description("Same as --edc-library-str but the EDC is a process called through RPC via ZeroMQ\nBatsim does not run the process, this should be done by the user\nExample <socket-endpoint> value: 'tcp://localhost:28000'");
+        ->description("Same as --edc-library-str but the EDC is a process called through RPC via ZeroMQ\nBatsim does not run the process, this should be done by the user\nExample <socket-endpoint> value: 'tcp://localhost:28000'\nEndpoints of the form 'shm://<segment-name>' use a shared-memory ring buffer instead of ZeroMQ (the EDC must be hosted by a program such as edc-shm-host)");
 
     std::vector<std::tuple<std::string, bool, std::string> > edc_socket_files;
     app.add_option("-S,--edc-socket-file", edc_socket_files, "")
@@ -246,6 +275,17 @@ void parse_main_args(int argc, char * argv[], MainArguments & main_args, int & r
         ->option_text("(<socket-endpoint> <json-format-bool> <init-file>)...")
         ->description("Same as --edc-library-file but the EDC is added as a process called through RPC via ZeroMQ");
 
+    app.add_option("--edc-replay", main_args.edc_replay_filename, "")
+        ->group(edc_group_name)
+        ->option_text("<log-file>")
+        ->check(CLI::ExistingFile)
+        ->description("Replay the decisions recorded into <log-file> by --edc-record instead of calling an EDC\nThe simulation is aborted if it diverges from the recorded one");
+
+    app.add_option("--edc-record", main_args.edc_record_filename, "")
+        ->group(edc_group_name)
+        ->option_text("<log-file>")
+        ->description("Record all the decisions taken by the EDC into <log-file>, so that they can be replayed by --edc-replay");
+
     std::map<std::string, EdcLibraryLoadMethod> ellm_map{{"dlmopen", EdcLibraryLoadMethod::DLMOPEN}, {"dlopen", EdcLibraryLoadMethod::DLOPEN}};
     app.add_option("--edc-library-load-method", main_args.edc_library_load_method, "How to load EDC libraries in memory. Accepted values: {dlmopen, dlopen}. Default: dlopen")
         ->group(edc_group_name)
@@ -302,6 +342,17 @@ void parse_main_args(int argc, char * argv[], MainArguments & main_args, int & r
         ->group(verbosity_group_name)
         ->excludes("--verbosity");
 
+    app.add_option("--log-sampling", main_args.log_sampling_period, "")
+        ->group(verbosity_group_name)
+        ->option_text("<period>")
+        ->description("Only log the lifecycle of 1 job out of <period> jobs (and 1 machine switch out of <period> switches)\n0 disables these log lines. Default: 1 (all are logged)");
+
+    app.add_option("--progress-period", main_args.progress_period, "")
+        ->group(verbosity_group_name)
+        ->option_text("<duration>")
+        ->description("Log the progress of the simulation (jobs completed per second, simulated/wall-clock time ratio) every <duration> seconds of wall-clock time\n0 (default) disables this")
+        ->check(CLI::NonNegativeNumber);
+
     app.add_option("--sg-log", main_args.simgrid_logging, "Set a SimGrid logging value — cf. https://simgrid.org/doc/latest/Configuring_SimGrid.html#logging-configuration")
         ->group(verbosity_group_name)
         ->option_text("<cat.key:value>");
@@ -440,7 +491,7 @@ void parse_main_args(int argc, char * argv[], MainArguments & main_args, int & r
     }
 
     // Platform
-    if (main_args.platform_filename == "")
+    if (main_args.platform_filename == "" && !main_args.compile_workloads)
     {
         fprintf(stderr, "%sThe SimGrid platform has not been set.\n", error_prefix);
         error = true;
@@ -454,21 +505,13 @@ void parse_main_args(int argc, char * argv[], MainArguments & main_args, int & r
         main_args.hosts_roles_map[hostname] = role;
     }
 
-    main_args.host_energy_used = energy_host;
-    if (energy_link)
-    {
-        fprintf(stderr, "%s--energy-link is not implemented.\n", error_prefix);
-        error = true;
-    }
-    if (energy_host_and_link)
-    {
-        fprintf(stderr, "%s--energy is not implemented.\n", error_prefix);
-        error = true;
-    }
+    main_args.host_energy_used = energy_host || energy_host_and_link;
+    main_args.link_energy_used = energy_link || energy_host_and_link;
 
     // EDCs
-    const auto nb_edc = edc_lib_files.size() + edc_lib_strings.size() + edc_socket_files.size() + edc_socket_strings.size();
-    if (nb_edc == 0)
+    const auto nb_edc = edc_lib_files.size() + edc_lib_strings.size() + edc_socket_files.size() + edc_socket_strings.size() +
+        static_cast<size_t>(!main_args.edc_replay_filename.empty());
+    if (nb_edc == 0 && !main_args.compile_workloads)
     {
         fprintf(stderr, "%sAt least one external decision component (EDC) should be set.\n", error_prefix);
         error = true;
@@ -519,12 +562,18 @@ void parse_main_args(int argc, char * argv[], MainArguments & main_args, int & r
         static_cast<int>(main_args.print_batsim_version) +
         static_cast<int>(main_args.print_batsim_commit) +
         static_cast<int>(main_args.print_simgrid_version) +
-        static_cast<int>(main_args.print_simgrid_commit);
+        static_cast<int>(main_args.print_simgrid_commit) +
+        static_cast<int>(main_args.compile_workloads);
     if (nb_stopping_flags > 1)
     {
         fprintf(stderr, "%sOnly one of the flags that print information and exit should be set.\n", error_prefix);
         error = true;
     }
+    if (main_args.compile_workloads && main_args.workload_descriptions.empty())
+    {
+        fprintf(stderr, "%s--compile-workload requires at least one workload (-w).\n", error_prefix);
+        error = true;
+    }
     run_simulation = !error && (nb_stopping_flags == 0);
     only_print_information = (nb_stopping_flags == 1);
 
@@ -10,6 +10,8 @@
 #include <string>
 #include <vector>
 
+#include "compression.hpp"
+
 /** @def STR_HELPER(x)
  *  @brief Helper macro to retrieve the string view of a macro.
  */
@@ -97,10 +99,12 @@ struct MainArguments
     std::list<WorkloadDescription> workload_descriptions;   //!< The workloads descriptions
     std::list<WorkflowDescription> workflow_descriptions;   //!< The workflows descriptions
     std::list<EventListDescription> eventList_descriptions; //!< The descriptions of the eventLists
+    double job_materialization_window = -1;                //!< If non-negative, workload jobs are only built this amount of simulated time (in seconds) before their submission instead of at startup
 
     // Common
     std::string master_host_name = "master_host";           //!< The name of the SimGrid host which runs scheduler processes and not user tasks
     bool host_energy_used = false;                          //!< True if and only if the SimGrid host_energy plugin should be used.
+    bool link_energy_used = false;                          //!< True if and only if the SimGrid link_energy plugin should be used.
     std::map<std::string, std::string> hosts_roles_map;     //!< The hosts/roles mapping to be added to the hosts properties.
 
     // Execution context
@@ -108,12 +112,19 @@ struct MainArguments
     std::string edc_library_path;                           //!< The External Decision Component library path. Empty if unset.
     std::string edc_init_buffer;                            //!< The External Decision Component initializtion buffer. Can be empty.
     bool edc_json_format = false;                           //!< If true, messages to communicate with EDCs should be sent as JSON strings.
+    std::string edc_replay_filename;                        //!< The decision log whose decisions are replayed instead of calling an External Decision Component. Empty if unset.
+    std::string edc_record_filename;                        //!< The decision log into which the decisions of the External Decision Component are recorded. Empty if unset.
 
     // Output
     std::string export_prefix = "out/";                     //!< The filename prefix used to export simulation information
     bool enable_schedule_tracing = false;                   //!< If set to true, the schedule is exported to a Pajé trace file
     bool enable_machine_state_tracing = false;              //!< If set to true, this option enables the tracing of the machine states into a CSV time series.
     bool enable_pstate_change_tracing = false;              //!< If set to true, this option enables the tracing of SimGrid hosts power state changes into a CSV time series.
+    bool disable_jobs_tracing = false;                      //!< If set to true, the jobs output file is not written (schedule metrics are still computed).
+    bool enable_server_profile_tracing = false;             //!< If set to true, the wall-clock time spent in each part of the server loop is measured and written into a CSV file.
+    bool enable_async_outputs = false;                      //!< If set to true, output files are written by dedicated I/O threads instead of the simulation thread.
+    bool enable_columnar_outputs = false;                   //!< If set to true, the jobs, machine states and energy outputs are written as columnar binary files instead of CSV files.
+    CompressionCodec output_compression = CompressionCodec::NONE; //!< How the output traces are compressed.
 
     // Platform size limit
     unsigned int limit_machines_count = 0;                  //!< The number of machines to use to compute jobs. 0 : no limit. > 0 : the number of computation machines
@@ -121,6 +132,8 @@ struct MainArguments
 
     // Verbosity
     VerbosityLevel verbosity = VerbosityLevel::INFORMATION; //!< Sets the Batsim verbosity
+    unsigned int log_sampling_period = 1;                   //!< One job lifecycle (or machine switch) out of this number is logged. 0: none.
+    double progress_period = 0;                             //!< If positive, the wall-clock period (in seconds) of progress log lines
 
     // Workflow
     unsigned int workflow_nb_concurrent_jobs_limit = 0;     //!< Limits the number of concurrent jobs for workflows
@@ -135,6 +148,7 @@ struct MainArguments
     bool print_batsim_commit = false;                       //!< Instead of running the simulation, print Batsim git commit on the standard output.
     bool print_simgrid_version = false;                     //!< Instead of running the simulation, print SimGrid version on the standard output.
     bool print_simgrid_commit = false;                      //!< Instead of running the simulation, print SimGrid git commit on the standard output.
+    bool compile_workloads = false;                         //!< Instead of running the simulation, compile the input workloads into binary caches.
 
     // Other
     std::vector<std::string> simgrid_config;                //!< The list of configuration options to pass to SimGrid.
@@ -0,0 +1,213 @@
+/**
+ * @file columnar.cpp
+ * @brief Contains the writer of Batsim's columnar binary output files
+ */
+
+#include "columnar.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+#include <simgrid/s4u.hpp>
+
+using namespace std;
+
+static const char COLUMNAR_MAGIC[8] = {'B', 'A', 'T', 'C', 'O', 'L', '\0', '\0'}; //!< Identifies columnar files
+static const uint32_t COLUMNAR_FORMAT_VERSION = 1; //!< The version of the columnar format
+static const uint32_t COLUMNAR_BYTE_ORDER_MARK = 0x01020304; //!< Tells readers the byte order of the file
+
+/**
+ * @brief The fixed-size header of a columnar file. The description of each column follows it.
+ */
+struct ColumnarFileHeader
+{
+    char magic[8];              //!< Identifies columnar files
+    uint32_t format_version;    //!< The version of the columnar format
+    uint32_t byte_order_mark;   //!< Tells readers the byte order of the file
+    uint32_t nb_columns;        //!< The number of columns
+    uint32_t padding;           //!< Unused
+};
+
+ColumnarWriter::ColumnarWriter(const std::string & filename,
+                               const std::vector<std::pair<std::string, ColumnType> > & columns,
+                               size_t row_group_size) :
+    _filename(filename),
+    _row_group_size(row_group_size)
+{
+    static_assert(sizeof(ColumnarFileHeader) == 24, "unexpected padding in columnar file header");
+    xbt_assert(!columns.empty(), "Invalid columnar file '%s': no columns", filename.c_str());
+    xbt_assert(row_group_size > 0 && row_group_size <= UINT32_MAX, "Invalid row group size (%zu)", row_group_size);
+
+    _file = fopen(filename.c_str(), "wb");
+    xbt_assert(_file != nullptr, "Cannot write file '%s' (errno=%s)", filename.c_str(), strerror(errno));
+    setvbuf(_file, nullptr, _IOFBF, 1 << 20);
+
+    ColumnarFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, COLUMNAR_MAGIC, sizeof(COLUMNAR_MAGIC));
+    header.format_version = COLUMNAR_FORMAT_VERSION;
+    header.byte_order_mark = COLUMNAR_BYTE_ORDER_MARK;
+    header.nb_columns = static_cast<uint32_t>(columns.size());
+    write(&header, sizeof(header));
+
+    _columns.resize(columns.size());
+    for (size_t i = 0; i < columns.size(); ++i)
+    {
+        const string & name = columns[i].first;
+        xbt_assert(name.size() <= UINT16_MAX, "Invalid columnar file '%s': column name too long", filename.c_str());
+
+        _columns[i].name = name;
+        _columns[i].type = columns[i].second;
+
+        // Column description: type (1 byte), padding (1 byte), name size (2 bytes), name
+        const uint8_t type = static_cast<uint8_t>(columns[i].second);
+        const uint8_t padding = 0;
+        const uint16_t name_size = static_cast<uint16_t>(name.size());
+        write(&type, sizeof(type));
+        write(&padding, sizeof(padding));
+        write(&name_size, sizeof(name_size));
+        write(name.data(), name.size());
+    }
+}
+
+ColumnarWriter::~ColumnarWriter()
+{
+    if (_file != nullptr)
+    {
+        xbt_assert(_next_column == 0, "Columnar file '%s' closed in the middle of a row", _filename.c_str());
+        flush_row_group();
+
+        int rc = fclose(_file);
+        xbt_assert(rc == 0, "Cannot write file '%s'", _filename.c_str());
+        _file = nullptr;
+    }
+}
+
+ColumnarWriter::Column & ColumnarWriter::next_column(ColumnType type)
+{
+    xbt_assert(_next_column < _columns.size(), "Columnar file '%s': too many values in a row", _filename.c_str());
+    Column & column = _columns[_next_column++];
+    xbt_assert(column.type == type ||
+               (type == ColumnType::STRING && column.type == ColumnType::DICTIONARY_STRING),
+               "Columnar file '%s': wrong value type for column '%s'", _filename.c_str(), column.name.c_str());
+    return column;
+}
+
+void ColumnarWriter::append_int64(int64_t value)
+{
+    next_column(ColumnType::INT64).int64_values.push_back(value);
+}
+
+void ColumnarWriter::append_float64(double value)
+{
+    next_column(ColumnType::FLOAT64).float64_values.push_back(value);
+}
+
+void ColumnarWriter::append_string(std::string_view value)
+{
+    Column & column = next_column(ColumnType::STRING);
+    xbt_assert(value.size() <= UINT32_MAX, "Columnar file '%s': string too long", _filename.c_str());
+
+    if (column.type == ColumnType::STRING)
+    {
+        column.lengths_or_codes.push_back(static_cast<uint32_t>(value.size()));
+        column.bytes.append(value.data(), value.size());
+    }
+    else
+    {
+        // Dictionary entries are only stored the first time they appear in the row group
+        auto [it, inserted] = column.dictionary.emplace(string(value), static_cast<uint32_t>(column.dictionary_lengths.size()));
+        if (inserted)
+        {
+            column.dictionary_lengths.push_back(static_cast<uint32_t>(value.size()));
+            column.bytes.append(value.data(), value.size());
+        }
+        column.lengths_or_codes.push_back(it->second);
+    }
+}
+
+void ColumnarWriter::end_row()
+{
+    xbt_assert(_next_column == _columns.size(), "Columnar file '%s': row ended after %zu values while there are %zu columns",
+               _filename.c_str(), _next_column, _columns.size());
+    _next_column = 0;
+    ++_nb_rows;
+
+    if (_nb_rows >= _row_group_size)
+    {
+        flush_row_group();
+    }
+}
+
+void ColumnarWriter::flush_row_group()
+{
+    if (_nb_rows == 0)
+    {
+        return;
+    }
+
+    // Row group: number of rows (4 bytes), padding (4 bytes), then each column as its size in bytes (8 bytes) and its data
+    const uint32_t nb_rows = static_cast<uint32_t>(_nb_rows);
+    const uint32_t padding = 0;
+    write(&nb_rows, sizeof(nb_rows));
+    write(&padding, sizeof(padding));
+
+    for (Column & column : _columns)
+    {
+        uint64_t data_size = 0;
+        switch (column.type)
+        {
+        case ColumnType::INT64:
+            data_size = column.int64_values.size() * sizeof(int64_t);
+            write(&data_size, sizeof(data_size));
+            write(column.int64_values.data(), data_size);
+            column.int64_values.clear();
+            break;
+        case ColumnType::FLOAT64:
+            data_size = column.float64_values.size() * sizeof(double);
+            write(&data_size, sizeof(data_size));
+            write(column.float64_values.data(), data_size);
+            column.float64_values.clear();
+            break;
+        case ColumnType::STRING:
+            // Lengths of the values, then the concatenated values
+            data_size = column.lengths_or_codes.size() * sizeof(uint32_t) + column.bytes.size();
+            write(&data_size, sizeof(data_size));
+            write(column.lengths_or_codes.data(), column.lengths_or_codes.size() * sizeof(uint32_t));
+            write(column.bytes.data(), column.bytes.size());
+            column.lengths_or_codes.clear();
+            column.bytes.clear();
+            break;
+        case ColumnType::DICTIONARY_STRING:
+        {
+            // Number of entries, lengths of the entries, concatenated entries, then the code of each value
+            const uint32_t nb_entries = static_cast<uint32_t>(column.dictionary_lengths.size());
+            data_size = sizeof(nb_entries) + nb_entries * sizeof(uint32_t) + column.bytes.size() +
+                        column.lengths_or_codes.size() * sizeof(uint32_t);
+            write(&data_size, sizeof(data_size));
+            write(&nb_entries, sizeof(nb_entries));
+            write(column.dictionary_lengths.data(), nb_entries * sizeof(uint32_t));
+            write(column.bytes.data(), column.bytes.size());
+            write(column.lengths_or_codes.data(), column.lengths_or_codes.size() * sizeof(uint32_t));
+            column.lengths_or_codes.clear();
+            column.bytes.clear();
+            column.dictionary_lengths.clear();
+            column.dictionary.clear();
+        } break;
+        }
+    }
+
+    _nb_rows = 0;
+}
+
+void ColumnarWriter::write(const void * data, size_t size)
+{
+    if (size == 0)
+    {
+        return;
+    }
+
+    size_t nb_written = fwrite(data, size, 1, _file);
+    (void) nb_written; // Avoids a warning if assertions are ignored
+    xbt_assert(nb_written == 1, "Cannot write file '%s'", _filename.c_str());
+}
@@ -0,0 +1,126 @@
+/**
+ * @file columnar.hpp
+ * @brief Contains the writer of Batsim's columnar binary output files
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief The types of the columns of a columnar output file
+ */
+enum class ColumnType : uint8_t
+{
+    INT64 = 1               //!< 64-bit signed integers
+   ,FLOAT64 = 2             //!< 64-bit floating-point values. Missing values are NaN.
+   ,STRING = 3              //!< Strings of any length
+   ,DICTIONARY_STRING = 4   //!< Strings with few distinct values, stored once per row group and referred to by 32-bit codes
+};
+
+/**
+ * @brief Writes a table into a columnar binary output file (.batcol), row group by row group
+ * @details A columnar file is made of a header that describes the columns (name and type),
+ *          followed by row groups. Each row group stores the number of its rows, then the values of each column contiguously.
+ *          Files are written in the native byte order, which is stored in the header so that readers can detect it.
+ *          The format is described in docs/output-columnar.rst and can be read by tools/batcol.py.
+ *
+ *          Rows are written by appending one value to each column in order, then calling end_row.
+ */
+class ColumnarWriter
+{
+public:
+    /**
+     * @brief Creates a columnar output file and writes its header
+     * @param[in] filename The name of the file
+     * @param[in] columns The name and type of each column
+     * @param[in] row_group_size The number of rows of each row group (except the last one)
+     */
+    ColumnarWriter(const std::string & filename,
+                   const std::vector<std::pair<std::string, ColumnType> > & columns,
+                   size_t row_group_size = 64*1024);
+
+    /**
+     * @brief ColumnarWriter cannot be copied.
+     * @param[in] other Another instance
+     */
+    ColumnarWriter(const ColumnarWriter & other) = delete;
+
+    /**
+     * @brief Writes the last row group and closes the file
+     */
+    ~ColumnarWriter();
+
+    /**
+     * @brief Appends a value to the next column of the current row, which must be an INT64 column
+     * @param[in] value The value
+     */
+    void append_int64(int64_t value);
+
+    /**
+     * @brief Appends a value to the next column of the current row, which must be a FLOAT64 column
+     * @param[in] value The value
+     */
+    void append_float64(double value);
+
+    /**
+     * @brief Appends a value to the next column of the current row, which must be a STRING or DICTIONARY_STRING column
+     * @param[in] value The value
+     */
+    void append_string(std::string_view value);
+
+    /**
+     * @brief Ends the current row. The row group is written into the file if it is full.
+     */
+    void end_row();
+
+    /**
+     * @brief Writes the current row group into the file, even if it is not full
+     */
+    void flush_row_group();
+
+private:
+    /**
+     * @brief The values of one column in the current row group
+     */
+    struct Column
+    {
+        std::string name; //!< The name of the column
+        ColumnType type; //!< The type of the column
+        std::vector<int64_t> int64_values; //!< The values of an INT64 column
+        std::vector<double> float64_values; //!< The values of a FLOAT64 column
+        std::vector<uint32_t> lengths_or_codes; //!< The length of each value of a STRING column, or the code of each value of a DICTIONARY_STRING column
+        std::string bytes; //!< The concatenated values of a STRING column, or the concatenated dictionary entries of a DICTIONARY_STRING column
+        std::vector<uint32_t> dictionary_lengths; //!< The length of each dictionary entry of a DICTIONARY_STRING column
+        std::unordered_map<std::string, uint32_t> dictionary; //!< Maps the dictionary entries of a DICTIONARY_STRING column to their code
+    };
+
+    /**
+     * @brief Returns the column that receives the next value of the current row, checking its type
+     * @param[in] type The type of the value
+     * @return The column that receives the next value
+     */
+    Column & next_column(ColumnType type);
+
+    /**
+     * @brief Writes a buffer into the file
+     * @param[in] data The buffer
+     * @param[in] size The size of the buffer
+     */
+    void write(const void * data, size_t size);
+
+private:
+    std::string _filename; //!< The name of the file
+    FILE * _file = nullptr; //!< The file
+    std::vector<Column> _columns; //!< The columns
+    const size_t _row_group_size; //!< The number of rows of each row group
+    size_t _nb_rows = 0; //!< The number of complete rows in the current row group
+    size_t _next_column = 0; //!< The index of the column that receives the next value of the current row
+};
@@ -0,0 +1,192 @@
+/**
+ * @file compression.cpp
+ * @brief Contains the streaming compression of output files
+ */
+
+#include "compression.hpp"
+
+#include <vector>
+
+#include <zlib.h>
+#include <zstd.h>
+
+#include <simgrid/s4u.hpp>
+
+using namespace std;
+
+/**
+ * @brief Returns whether a string ends with a given suffix
+ * @param[in] str The string
+ * @param[in] suffix The suffix
+ * @return Whether str ends with suffix
+ */
+static bool ends_with(const string & str, const string & suffix)
+{
+    return str.size() >= suffix.size() && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+CompressionCodec compression_codec_from_filename(const std::string & filename)
+{
+    if (ends_with(filename, compression_codec_extension(CompressionCodec::ZSTD)))
+    {
+        return CompressionCodec::ZSTD;
+    }
+    else if (ends_with(filename, compression_codec_extension(CompressionCodec::GZIP)))
+    {
+        return CompressionCodec::GZIP;
+    }
+    return CompressionCodec::NONE;
+}
+
+const char * compression_codec_extension(CompressionCodec codec)
+{
+    switch (codec)
+    {
+    case CompressionCodec::NONE: return "";
+    case CompressionCodec::GZIP: return ".gz";
+    case CompressionCodec::ZSTD: return ".zst";
+    }
+    return "";
+}
+
+/**
+ * @brief Compresses a stream of data in the gzip format (thanks to zlib)
+ */
+class GzipStreamCompressor : public StreamCompressor
+{
+public:
+    /**
+     * @brief Creates a GzipStreamCompressor
+     * @param[in,out] out The output stream into which compressed data is written
+     */
+    explicit GzipStreamCompressor(std::ostream & out) :
+        _out(out),
+        _chunk(64*1024)
+    {
+        _stream.zalloc = Z_NULL;
+        _stream.zfree = Z_NULL;
+        _stream.opaque = Z_NULL;
+        // 15 is the default window size, +16 writes a gzip header and trailer instead of a zlib one
+        int rc = deflateInit2(&_stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);
+        (void) rc; // Avoids a warning if assertions are ignored
+        xbt_assert(rc == Z_OK, "Cannot initialize gzip compression (rc=%d)", rc);
+    }
+
+    ~GzipStreamCompressor() override
+    {
+        deflateEnd(&_stream);
+    }
+
+    void write(const char * data, size_t size) override
+    {
+        _stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+        _stream.avail_in = static_cast<uInt>(size);
+        deflate_all(Z_NO_FLUSH);
+    }
+
+    void finish() override
+    {
+        _stream.next_in = Z_NULL;
+        _stream.avail_in = 0;
+        deflate_all(Z_FINISH);
+    }
+
+private:
+    /**
+     * @brief Compresses all the input data of _stream, writing compressed data into the output stream
+     * @param[in] flush The zlib flush mode
+     */
+    void deflate_all(int flush)
+    {
+        do
+        {
+            _stream.next_out = reinterpret_cast<Bytef *>(_chunk.data());
+            _stream.avail_out = static_cast<uInt>(_chunk.size());
+            int rc = deflate(&_stream, flush);
+            (void) rc; // Avoids a warning if assertions are ignored
+            xbt_assert(rc != Z_STREAM_ERROR, "gzip compression failed");
+            _out.write(_chunk.data(), static_cast<std::streamsize>(_chunk.size() - _stream.avail_out));
+        } while (_stream.avail_out == 0);
+    }
+
+private:
+    std::ostream & _out; //!< The output stream
+    std::vector<char> _chunk; //!< The buffer into which data is compressed before being written into the output stream
+    z_stream _stream; //!< The zlib stream
+};
+
+/**
+ * @brief Compresses a stream of data in the zstd format
+ */
+class ZstdStreamCompressor : public StreamCompressor
+{
+public:
+    /**
+     * @brief Creates a ZstdStreamCompressor
+     * @param[in,out] out The output stream into which compressed data is written
+     */
+    explicit ZstdStreamCompressor(std::ostream & out) :
+        _out(out),
+        _chunk(ZSTD_CStreamOutSize())
+    {
+        _context = ZSTD_createCCtx();
+        xbt_assert(_context != nullptr, "Cannot initialize zstd compression");
+        ZSTD_CCtx_setParameter(_context, ZSTD_c_compressionLevel, ZSTD_CLEVEL_DEFAULT);
+    }
+
+    ~ZstdStreamCompressor() override
+    {
+        ZSTD_freeCCtx(_context);
+    }
+
+    void write(const char * data, size_t size) override
+    {
+        ZSTD_inBuffer input = {data, size, 0};
+        while (input.pos < input.size)
+        {
+            compress_chunk(input, ZSTD_e_continue);
+        }
+    }
+
+    void finish() override
+    {
+        ZSTD_inBuffer input = {nullptr, 0, 0};
+        size_t remaining;
+        do
+        {
+            remaining = compress_chunk(input, ZSTD_e_end);
+        } while (remaining != 0);
+    }
+
+private:
+    /**
+     * @brief Compresses (part of) the input into one output chunk, and writes it into the output stream
+     * @param[in,out] input The input buffer
+     * @param[in] mode The zstd end directive
+     * @return What ZSTD_compressStream2 returns (the minimal amount of data that remains to be flushed in ZSTD_e_end mode)
+     */
+    size_t compress_chunk(ZSTD_inBuffer & input, ZSTD_EndDirective mode)
+    {
+        ZSTD_outBuffer output = {_chunk.data(), _chunk.size(), 0};
+        size_t ret = ZSTD_compressStream2(_context, &output, &input, mode);
+        xbt_assert(!ZSTD_isError(ret), "zstd compression failed: %s", ZSTD_getErrorName(ret));
+        _out.write(_chunk.data(), static_cast<std::streamsize>(output.pos));
+        return ret;
+    }
+
+private:
+    std::ostream & _out; //!< The output stream
+    std::vector<char> _chunk; //!< The buffer into which data is compressed before being written into the output stream
+    ZSTD_CCtx * _context = nullptr; //!< The zstd compression context
+};
+
+std::unique_ptr<StreamCompressor> StreamCompressor::create(CompressionCodec codec, std::ostream & out)
+{
+    switch (codec)
+    {
+    case CompressionCodec::GZIP: return std::make_unique<GzipStreamCompressor>(out);
+    case CompressionCodec::ZSTD: return std::make_unique<ZstdStreamCompressor>(out);
+    case CompressionCodec::NONE: break;
+    }
+    xbt_die("Cannot create a stream compressor without compression codec");
+}
@@ -0,0 +1,67 @@
+/**
+ * @file compression.hpp
+ * @brief Contains the streaming compression of output files
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string>
+
+/**
+ * @brief The compression codecs of output files
+ */
+enum class CompressionCodec
+{
+    NONE    //!< Files are not compressed
+   ,GZIP    //!< Files are compressed in the gzip format (.gz)
+   ,ZSTD    //!< Files are compressed in the zstd format (.zst)
+};
+
+/**
+ * @brief Returns the compression codec that corresponds to the extension of a file name
+ * @param[in] filename The file name
+ * @return ZSTD if filename ends with .zst, GZIP if it ends with .gz, NONE otherwise
+ */
+CompressionCodec compression_codec_from_filename(const std::string & filename);
+
+/**
+ * @brief Returns the file name extension of a compression codec
+ * @param[in] codec The compression codec
+ * @return The file name extension of the codec (e.g., ".zst"), or an empty string for NONE
+ */
+const char * compression_codec_extension(CompressionCodec codec);
+
+/**
+ * @brief Compresses a stream of data into an output stream, chunk by chunk
+ */
+class StreamCompressor
+{
+public:
+    /**
+     * @brief Creates a StreamCompressor
+     * @param[in] codec The compression codec. Must not be NONE.
+     * @param[in,out] out The output stream into which compressed data is written. Must outlive the StreamCompressor.
+     * @return The StreamCompressor
+     */
+    static std::unique_ptr<StreamCompressor> create(CompressionCodec codec, std::ostream & out);
+
+    /**
+     * @brief Destroys a StreamCompressor
+     */
+    virtual ~StreamCompressor() = default;
+
+    /**
+     * @brief Compresses a chunk of data. Compressed data may be buffered until next calls.
+     * @param[in] data The chunk of data
+     * @param[in] size The size of the chunk of data
+     */
+    virtual void write(const char * data, size_t size) = 0;
+
+    /**
+     * @brief Ends the compressed stream, writing all buffered data into the output stream. No data can be written afterwards.
+     */
+    virtual void finish() = 0;
+};
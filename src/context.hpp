@@ -14,18 +14,22 @@
 
 #include <batprotocol.hpp>
 
+#include "compression.hpp"
 #include "edc.hpp"
 #include "events.hpp"
 #include "export.hpp"
 #include "jobs.hpp"
 #include "machines.hpp"
 #include "profiles.hpp"
+#include "progress.hpp"
 #include "protocol.hpp"
 #include "pstate.hpp"
+#include "server_profiler.hpp"
 #include "workflow.hpp"
 #include "workload.hpp"
 
 class ExternalDecisionComponent;
+class EDCDecisionRecorder;
 
 /**
  * @brief Stores a high-resolution timestamp
@@ -40,6 +44,7 @@ struct BatsimContext
     void * zmq_context = nullptr;                   //!< The Zero MQ context
     ExternalDecisionComponent * edc = nullptr;      //!> The External Decision Component
     bool edc_json_format = false;                   //!< Whether JSON format or flatbuffers's binary format should be used to communicate with EDCs.
+    EDCDecisionRecorder * edc_recorder = nullptr;   //!< Records the decisions taken by the EDC into a decision log. nullptr if recording is disabled.
 
     batprotocol::MessageBuilder * proto_msg_builder = nullptr; //!< The batprotocol message builder
     MainArguments * main_args = nullptr;            //!< The arguments received by Batsim's main
@@ -68,6 +73,9 @@ struct BatsimContext
     long double energy_last_job_completion = -1;    //!< The amount of consumed energy (J) when the last job is completed
 
     long double microseconds_used_by_scheduler = 0; //!< The number of microseconds used by the scheduler
+    ServerProfiler server_profiler;                 //!< Profiles the wall-clock time spent in the server loop (disabled by default)
+    LogSampler log_sampler;                         //!< Decides which log lines of frequent events (job lifecycle, machine switches) are written
+    ProgressReporter progress_reporter;             //!< Periodically logs the progress of the simulation (disabled by default)
     my_timestamp simulation_start_time;             //!< The moment in time at which the simulation has started
     my_timestamp simulation_end_time;               //!< The moment in time at which the simulation has ended
 
@@ -75,11 +83,17 @@ struct BatsimContext
     unsigned long long nb_grouped_switches = 0;     //!< The number of switches done in the simulation (should equal to the number of received SET_RESOURCE_STATE events). Does not count transition states.
 
     bool energy_used;                               //!< Stores whether the energy part of Batsim should be used
+    bool link_energy_used;                          //!< Stores whether the SimGrid link_energy plugin is used (required to probe the energy of links)
     bool smpi_used;                                 //!< Stores whether SMPI should be used
     bool allow_compute_sharing;                     //!< Stores whether sharing (using the same machine to run different jobs concurrently) should be allowed on compute machines
     bool allow_storage_sharing;                     //!< Stores whether sharing (using the same machine to run different jobs concurrently) should be allowed on storage machines
     bool trace_schedule;                            //!< Stores whether the resulting schedule should be outputted
     bool trace_machine_states;                      //!< Stores whether the machines states should be outputted
+    bool trace_jobs;                                //!< Stores whether the jobs should be outputted
+    bool trace_server_profile;                      //!< Stores whether the wall-clock profile of the server loop should be outputted
+    bool async_outputs;                             //!< Stores whether output files are written by dedicated I/O threads
+    bool columnar_outputs;                          //!< Stores whether the jobs, machine states and energy outputs are columnar files instead of CSV files
+    CompressionCodec output_compression;            //!< Stores how the output traces are compressed
     std::string platform_filename;                  //!< The name of the platform file
     std::string export_prefix;                      //!< The output export prefix
     int workflow_nb_concurrent_jobs_limit;          //!< Limits the number of concurrent jobs for workflows
@@ -82,6 +82,48 @@ ExternalDecisionComponent *ExternalDecisionComponent::new_process(void *zmq_cont
     return edc;
 }
 
+/**
+ * @brief Allocates a new ExternalDecisionComponent of shared-memory process type and connects it to the desired segment
+ * @details The EDC process must be running on the same machine and must have created the shared-memory segment
+ *          (or create it within a few seconds). test/edc-lib's edc-shm-host is such a process that hosts any EDC library.
+ * @param[in] connection_endpoint The endpoint to connect to, formatted as shm://SEGMENT_NAME
+ * @return The newly allocated ExternalDecisionComponent
+ */
+ExternalDecisionComponent *ExternalDecisionComponent::new_shared_memory_process(const std::string &connection_endpoint)
+{
+    xbt_assert(edc_shm::is_shm_endpoint(connection_endpoint), "Invalid shared-memory endpoint '%s'", connection_endpoint.c_str());
+    const std::string segment_name = connection_endpoint.substr(sizeof(edc_shm::ENDPOINT_PREFIX) - 1);
+
+    auto edc = new ExternalDecisionComponent();
+    edc->_type = EDCType::SHARED_MEMORY_PROCESS;
+    edc->_shm_process = new ExternalSharedMemoryProcess();
+
+    try
+    {
+        edc->_shm_process->channel = edc_shm::Channel::open(segment_name);
+    }
+    catch (const std::runtime_error & e)
+    {
+        xbt_assert(false, "Cannot connect to EDC shared-memory endpoint '%s': %s", connection_endpoint.c_str(), e.what());
+    }
+
+    XBT_INFO("connected to external decision component via shared-memory segment '%s'", segment_name.c_str());
+    return edc;
+}
+
+/**
+ * @brief Allocates a new ExternalDecisionComponent that replays the decisions recorded during a previous simulation
+ * @param[in] replayer The replayer of the recorded decisions. Its ownership is transferred to the ExternalDecisionComponent.
+ * @return The newly allocated ExternalDecisionComponent
+ */
+ExternalDecisionComponent *ExternalDecisionComponent::new_replay(EDCDecisionReplayer * replayer)
+{
+    auto edc = new ExternalDecisionComponent();
+    edc->_type = EDCType::REPLAY;
+    edc->_replayer = replayer;
+    return edc;
+}
+
 /**
  * @brief Call init on the external decision component
  * @param[in] data The initialization data
@@ -125,6 +167,7 @@ void ExternalDecisionComponent::init(const uint8_t *data, uint32_t data_size, ui
         rc = zmq_msg_send(&msg, _process->zmq_socket, 0);
         if (rc != static_cast<int>(msg_size))
         {
+            zmq_msg_close(&msg);
             throw std::runtime_error(std::string("Cannot send initialization message on socket (errno=") + strerror(errno) + ")");
         }
 
@@ -132,11 +175,36 @@ void ExternalDecisionComponent::init(const uint8_t *data, uint32_t data_size, ui
         zmq_msg_t msg2;
         zmq_msg_init(&msg2);
         if (zmq_msg_recv(&msg2, _process->zmq_socket, 0) == -1)
+        {
+            zmq_msg_close(&msg2);
             throw std::runtime_error(std::string("Cannot read message on socket (errno=") + strerror(errno) + ")");
+        }
 
-        if (zmq_msg_size(&msg2) > 0)
+        const size_t reply_size = zmq_msg_size(&msg2);
+        zmq_msg_close(&msg2);
+        if (reply_size > 0)
             throw std::runtime_error(std::string("Non-empty ZeroMQ message received as acknowledgement of initialization message"));
     } break;
+    case EDCType::SHARED_MEMORY_PROCESS: {
+        // Same initialization message as process EDCs: flags(uint32), data_size(uint32), data(data_size octets)
+        std::vector<uint8_t> & msg = _shm_process->decisions;
+        msg.resize(sizeof(uint32_t) + sizeof(uint32_t) + data_size * sizeof(uint8_t));
+        memcpy(msg.data(), &flags, sizeof(uint32_t));
+        memcpy(msg.data() + sizeof(uint32_t), &data_size, sizeof(uint32_t));
+        if (data_size > 0)
+        {
+            memcpy(msg.data() + 2 * sizeof(uint32_t), data, data_size * sizeof(uint8_t));
+        }
+        _shm_process->channel->send(msg.data(), static_cast<uint32_t>(msg.size()));
+
+        // Wait & read the reply (that should be empty)
+        if (_shm_process->channel->receive(msg) > 0)
+            throw std::runtime_error(std::string("Non-empty message received as acknowledgement of initialization message"));
+    } break;
+    case EDCType::REPLAY: {
+        // The recorded decisions already depend on the initialization data, only the message format matters
+        _replayer->check_init(flags);
+    } break;
     }
 }
 
@@ -157,11 +225,22 @@ ExternalDecisionComponent::~ExternalDecisionComponent()
         }
     } break;
     case EDCType::PROCESS: {
+        release_decisions();
         zmq_close(_process->zmq_socket);
         _process->zmq_socket = nullptr;
         delete _process;
         _process = nullptr;
     } break;
+    case EDCType::SHARED_MEMORY_PROCESS: {
+        // Destroying the channel closes it, which tells the EDC process to stop
+        delete _shm_process->channel;
+        delete _shm_process;
+        _shm_process = nullptr;
+    } break;
+    case EDCType::REPLAY: {
+        delete _replayer;
+        _replayer = nullptr;
+    } break;
     }
 }
 
@@ -196,19 +275,63 @@ void ExternalDecisionComponent::take_decisions(uint8_t *what_happened_buffer, ui
     } break;
 
     case EDCType::PROCESS: {
-        // Send the message on the socket
-        if (zmq_send(_process->zmq_socket, what_happened_buffer, what_happened_buffer_size, 0) == -1)
+        // The previous decisions should have been released already, but make sure they do not leak
+        release_decisions();
+
+        // Send the message on the socket, without copying the buffer.
+        // The buffer is owned by the protocol message builder, which is only cleared once the decisions have been received.
+        // As the socket is a REQ one, receiving the reply guarantees that ZeroMQ no longer uses the request buffer.
+        zmq_msg_t request;
+        int rc = zmq_msg_init_data(&request, what_happened_buffer, what_happened_buffer_size, nullptr, nullptr);
+        xbt_assert(rc == 0, "Cannot initialize ZeroMQ message");
+        if (zmq_msg_send(&request, _process->zmq_socket, 0) == -1)
+        {
+            zmq_msg_close(&request);
             throw std::runtime_error(std::string("Cannot send message on socket (errno=") + strerror(errno) + ")");
+        }
 
-        // Wait & read the reply on the socket
-        zmq_msg_t msg;
-        zmq_msg_init(&msg);
-        if (zmq_msg_recv(&msg, _process->zmq_socket, 0) == -1)
+        // Wait & read the reply on the socket. Its data is used in place until release_decisions is called.
+        zmq_msg_init(&_process->decisions_msg);
+        _process->decisions_msg_alive = true;
+        if (zmq_msg_recv(&_process->decisions_msg, _process->zmq_socket, 0) == -1)
+        {
+            release_decisions();
             throw std::runtime_error(std::string("Cannot read message on socket (errno=") + strerror(errno) + ")");
+        }
+
+        *decisions_buffer = static_cast<uint8_t *>(zmq_msg_data(&_process->decisions_msg));
+        *decisions_buffer_size = static_cast<uint32_t>(zmq_msg_size(&_process->decisions_msg));
+    } break;
 
-        *decisions_buffer = (uint8_t *)zmq_msg_data(&msg);
-        *decisions_buffer_size = zmq_msg_size(&msg);
+    case EDCType::SHARED_MEMORY_PROCESS: {
+        // The decisions buffer is reused between calls and remains valid until the next call
+        _shm_process->channel->send(what_happened_buffer, what_happened_buffer_size);
+        *decisions_buffer_size = _shm_process->channel->receive(_shm_process->decisions);
+        *decisions_buffer = _shm_process->decisions.data();
     } break;
+
+    case EDCType::REPLAY: {
+        // Recorded decisions are read in place from the decision log, which remains mapped until the end of the simulation
+        const uint8_t * recorded_decisions = nullptr;
+        _replayer->next_decisions(what_happened_buffer, what_happened_buffer_size, &recorded_decisions, decisions_buffer_size);
+        *decisions_buffer = const_cast<uint8_t *>(recorded_decisions);
+    } break;
+    }
+}
+
+/**
+ * @brief Releases the decisions buffer returned by the last take_decisions call
+ * @details The decisions buffer must not be used after this call.
+ *          Buffers of library EDCs are owned by the library, buffers of shared-memory EDCs are reused between calls
+ *          and buffers of replay EDCs point into the decision log,
+ *          so this only releases the messages received from (ZeroMQ) process EDCs.
+ */
+void ExternalDecisionComponent::release_decisions()
+{
+    if (_type == EDCType::PROCESS && _process->decisions_msg_alive)
+    {
+        zmq_msg_close(&_process->decisions_msg);
+        _process->decisions_msg_alive = false;
     }
 }
 
@@ -5,7 +5,11 @@
 #include <string>
 #include <vector>
 
+#include <zmq.h>
+
 #include "batsim.hpp"
+#include "edc_record.hpp"
+#include "edc_shm.hpp"
 #include "context.hpp"
 #include "ipp.hpp"
 
@@ -31,6 +35,17 @@ struct ExternalLibrary
 struct ExternalProcess
 {
     void * zmq_socket = nullptr; //!< The ZeroMQ socket associated with the ExternalProcess
+    zmq_msg_t decisions_msg; //!< The last decisions received on the socket. Its data is used in place (without copy) until release_decisions is called.
+    bool decisions_msg_alive = false; //!< Whether decisions_msg has been received and not released yet
+};
+
+/**
+ * @brief A structure to call an External Decision Component as a local process via shared memory.
+ */
+struct ExternalSharedMemoryProcess
+{
+    edc_shm::Channel * channel = nullptr; //!< The shared-memory channel with the process
+    std::vector<uint8_t> decisions; //!< The last decisions received on the channel, followed by a NUL byte (reused between calls)
 };
 
 /**
@@ -40,6 +55,8 @@ enum class EDCType
 {
     LIBRARY //!< an ExternalLibrary
    ,PROCESS //!< an ExternalProcess
+   ,SHARED_MEMORY_PROCESS //!< an ExternalSharedMemoryProcess
+   ,REPLAY //!< an EDCDecisionReplayer
 };
 
 /**
@@ -50,10 +67,13 @@ class ExternalDecisionComponent
 public:
     static ExternalDecisionComponent * new_library(const std::string & lib_path, const EdcLibraryLoadMethod & load_method);
     static ExternalDecisionComponent * new_process(void * zmq_context, const std::string & connection_endpoint);
+    static ExternalDecisionComponent * new_shared_memory_process(const std::string & connection_endpoint);
+    static ExternalDecisionComponent * new_replay(EDCDecisionReplayer * replayer);
     ~ExternalDecisionComponent();
 
     void init(const uint8_t * data, uint32_t data_size, uint32_t flags);
     void take_decisions(uint8_t * what_happened_buffer, uint32_t what_happened_buffer_size, uint8_t ** decisions_buffer, uint32_t * decisions_buffer_size);
+    void release_decisions();
 
 private:
     ExternalDecisionComponent() = default;
@@ -62,6 +82,8 @@ private:
     EDCType _type; //!< The type of external decision component
     ExternalLibrary * _library = nullptr; //!< The actual data behind a library variant (nullptr otherwise)
     ExternalProcess * _process = nullptr; //!< The actual data behind a process variant (nullptr otherwise)
+    ExternalSharedMemoryProcess * _shm_process = nullptr; //!< The actual data behind a shared-memory process variant (nullptr otherwise)
+    EDCDecisionReplayer * _replayer = nullptr; //!< The actual data behind a replay variant (nullptr otherwise)
 };
 
 void * load_lib_symbol(void * lib_handle, const char * symbol);
@@ -0,0 +1,234 @@
+/**
+ * @file edc_record.cpp
+ * @brief Contains the recording of the decisions taken by external decision components, and their replay
+ */
+
+#include "edc_record.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <simgrid/s4u.hpp>
+
+using namespace std;
+
+XBT_LOG_NEW_DEFAULT_CATEGORY(edc_record, "edc_record"); //!< Logging
+
+static const char LOG_MAGIC[8] = {'B', 'A', 'T', 'E', 'D', 'C', 'R', 'R'}; //!< Identifies decision log files
+static const uint32_t LOG_FORMAT_VERSION = 2; //!< The version of the decision log format
+static const uint32_t LOG_BYTE_ORDER_MARK = 0x01020304; //!< Detects decision logs written with another endianness
+static const size_t RECORD_ALIGNMENT = 8; //!< Records start at offsets multiple of this, so that decisions can be read in place
+static const uint32_t JSON_FORMAT_FLAG = 0x2; //!< The initialization flag that tells decisions are in JSON format
+
+/**
+ * @brief The fixed-size header of a decision log file
+ */
+struct DecisionLogHeader
+{
+    char magic[8];              //!< Identifies decision log files
+    uint32_t format_version;    //!< The version of the decision log format
+    uint32_t byte_order_mark;   //!< Detects decision logs written with another endianness
+    uint32_t init_flags;        //!< The flags the decision component has been initialized with
+    uint32_t padding;           //!< Unused
+};
+
+/**
+ * @brief The fixed-size header of each record of a decision log file.
+ * @details The decisions follow it, then at least one NUL byte (so that JSON decisions can be parsed in place)
+ *          and padding up to the alignment of the next record.
+ */
+struct DecisionLogRecordHeader
+{
+    uint64_t what_happened_hash; //!< The hash of the message sent to the decision component
+    uint32_t what_happened_size; //!< The size of the message sent to the decision component
+    uint32_t decisions_size;     //!< The size of the decisions that follow
+};
+
+/**
+ * @brief Computes the (64-bit FNV-1a) hash of a buffer
+ * @param[in] data The buffer
+ * @param[in] size The size of the buffer
+ * @return The hash of the buffer
+ */
+static uint64_t hash_buffer(const uint8_t * data, uint32_t size)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        hash ^= data[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Returns the number of NUL bytes that follow the decisions of a record so that they are NUL-terminated and the next record is aligned
+ * @param[in] decisions_size The size of the decisions of the record
+ * @return The number of padding bytes (in [1, RECORD_ALIGNMENT])
+ */
+static size_t record_padding(uint32_t decisions_size)
+{
+    return RECORD_ALIGNMENT - (decisions_size % RECORD_ALIGNMENT);
+}
+
+EDCDecisionRecorder::EDCDecisionRecorder(const std::string & filename, uint32_t init_flags) :
+    _filename(filename)
+{
+    static_assert(sizeof(DecisionLogHeader) == 24, "unexpected padding in decision log header");
+    static_assert(sizeof(DecisionLogRecordHeader) == 16, "unexpected padding in decision log records");
+
+    _file = fopen(filename.c_str(), "wb");
+    xbt_assert(_file != nullptr, "Cannot create decision log file '%s' (errno=%s)", filename.c_str(), strerror(errno));
+    setvbuf(_file, nullptr, _IOFBF, 1 << 20);
+
+    DecisionLogHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, LOG_MAGIC, sizeof(LOG_MAGIC));
+    header.format_version = LOG_FORMAT_VERSION;
+    header.byte_order_mark = LOG_BYTE_ORDER_MARK;
+    header.init_flags = init_flags;
+    size_t nb_written = fwrite(&header, sizeof(header), 1, _file);
+    xbt_assert(nb_written == 1, "Cannot write decision log file '%s'", filename.c_str());
+
+    XBT_INFO("Recording the decisions of the external decision component into '%s'", filename.c_str());
+}
+
+EDCDecisionRecorder::~EDCDecisionRecorder()
+{
+    if (_file != nullptr)
+    {
+        int rc = fclose(_file);
+        xbt_assert(rc == 0, "Cannot write decision log file '%s'", _filename.c_str());
+        _file = nullptr;
+        XBT_INFO("%lu take_decisions calls have been recorded into '%s'",
+                 static_cast<unsigned long>(_nb_records), _filename.c_str());
+    }
+}
+
+void EDCDecisionRecorder::record(const uint8_t * what_happened, uint32_t what_happened_size,
+                                 const uint8_t * decisions, uint32_t decisions_size)
+{
+    static const uint8_t padding[RECORD_ALIGNMENT] = {0};
+
+    DecisionLogRecordHeader record;
+    record.what_happened_hash = hash_buffer(what_happened, what_happened_size);
+    record.what_happened_size = what_happened_size;
+    record.decisions_size = decisions_size;
+
+    const size_t padding_size = record_padding(decisions_size);
+    bool success = fwrite(&record, sizeof(record), 1, _file) == 1;
+    if (decisions_size > 0)
+    {
+        success = success && fwrite(decisions, decisions_size, 1, _file) == 1;
+    }
+    success = success && fwrite(padding, padding_size, 1, _file) == 1;
+    xbt_assert(success, "Cannot write decision log file '%s'", _filename.c_str());
+
+    ++_nb_records;
+}
+
+uint64_t EDCDecisionRecorder::nb_records() const
+{
+    return _nb_records;
+}
+
+EDCDecisionReplayer::EDCDecisionReplayer(const std::string & filename) :
+    _filename(filename)
+{
+    int fd = open(filename.c_str(), O_RDONLY);
+    xbt_assert(fd != -1, "Cannot open decision log file '%s' (errno=%s)", filename.c_str(), strerror(errno));
+
+    struct stat file_stat;
+    int rc = fstat(fd, &file_stat);
+    xbt_assert(rc == 0 && static_cast<size_t>(file_stat.st_size) >= sizeof(DecisionLogHeader),
+               "Invalid decision log file '%s': truncated file", filename.c_str());
+
+    _mapping_size = static_cast<size_t>(file_stat.st_size);
+    _mapping = mmap(nullptr, _mapping_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    xbt_assert(_mapping != MAP_FAILED, "Cannot map decision log file '%s' in memory (errno=%s)", filename.c_str(), strerror(errno));
+    madvise(_mapping, _mapping_size, MADV_SEQUENTIAL);
+
+    const DecisionLogHeader * header = static_cast<const DecisionLogHeader *>(_mapping);
+    xbt_assert(memcmp(header->magic, LOG_MAGIC, sizeof(LOG_MAGIC)) == 0,
+               "Invalid decision log file '%s': not a decision log file", filename.c_str());
+    xbt_assert(header->format_version == LOG_FORMAT_VERSION && header->byte_order_mark == LOG_BYTE_ORDER_MARK,
+               "Invalid decision log file '%s': incompatible format (recorded by another Batsim version or on another architecture)",
+               filename.c_str());
+
+    _init_flags = header->init_flags;
+    _offset = sizeof(DecisionLogHeader);
+
+    XBT_INFO("Replaying the decisions recorded into '%s'", filename.c_str());
+}
+
+EDCDecisionReplayer::~EDCDecisionReplayer()
+{
+    if (_mapping != nullptr)
+    {
+        if (_offset != _mapping_size)
+        {
+            XBT_WARN("Only %lu take_decisions calls have been replayed from '%s', which contains more of them",
+                     static_cast<unsigned long>(_nb_replayed), _filename.c_str());
+        }
+
+        munmap(_mapping, _mapping_size);
+        _mapping = nullptr;
+    }
+}
+
+bool EDCDecisionReplayer::json_format() const
+{
+    return (_init_flags & JSON_FORMAT_FLAG) != 0;
+}
+
+void EDCDecisionReplayer::check_init(uint32_t init_flags) const
+{
+    if (init_flags != _init_flags)
+    {
+        throw runtime_error("Cannot replay '" + _filename + "': decisions have been recorded with initialization flags " +
+                            to_string(_init_flags) + ", not " + to_string(init_flags));
+    }
+}
+
+void EDCDecisionReplayer::next_decisions(const uint8_t * what_happened, uint32_t what_happened_size,
+                                         const uint8_t ** decisions, uint32_t * decisions_size)
+{
+    const uint8_t * base = static_cast<const uint8_t *>(_mapping);
+    const size_t remaining_size = _mapping_size - _offset;
+    if (remaining_size < sizeof(DecisionLogRecordHeader))
+    {
+        throw runtime_error("Cannot replay '" + _filename + "': the simulation diverged from the recorded one, which ended after " +
+                            to_string(_nb_replayed) + " take_decisions calls");
+    }
+
+    const DecisionLogRecordHeader * record = reinterpret_cast<const DecisionLogRecordHeader *>(base + _offset);
+    const size_t record_size = sizeof(DecisionLogRecordHeader) + record->decisions_size + record_padding(record->decisions_size);
+    if (record_size > remaining_size)
+    {
+        throw runtime_error("Cannot replay '" + _filename + "': truncated file");
+    }
+
+    if (record->what_happened_size != what_happened_size ||
+        record->what_happened_hash != hash_buffer(what_happened, what_happened_size))
+    {
+        throw runtime_error("Cannot replay '" + _filename + "': the simulation diverged from the recorded one at take_decisions call #" +
+                            to_string(_nb_replayed) + " (the decision component did not receive the same message)");
+    }
+
+    *decisions = base + _offset + sizeof(DecisionLogRecordHeader);
+    *decisions_size = record->decisions_size;
+    if ((*decisions)[*decisions_size] != 0)
+    {
+        throw runtime_error("Cannot replay '" + _filename + "': corrupted file (unterminated decisions at take_decisions call #" +
+                            to_string(_nb_replayed) + ")");
+    }
+
+    _offset += record_size;
+    ++_nb_replayed;
+}
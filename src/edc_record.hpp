@@ -0,0 +1,119 @@
+/**
+ * @file edc_record.hpp
+ * @brief Contains the recording of the decisions taken by external decision components, and their replay
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+/**
+ * @brief Appends the decisions taken by an external decision component to a decision log file
+ * @details A decision log is made of a fixed-size header followed by one record per take_decisions call.
+ *          Each record stores the size and hash of the what_happened message (to detect divergence on replay)
+ *          and the full decisions message, NUL-terminated. Decision logs are not portable across architectures.
+ */
+class EDCDecisionRecorder
+{
+public:
+    /**
+     * @brief Creates a decision log file
+     * @param[in] filename The name of the decision log file
+     * @param[in] init_flags The flags the external decision component has been initialized with
+     */
+    EDCDecisionRecorder(const std::string & filename, uint32_t init_flags);
+
+    /**
+     * @brief EDCDecisionRecorder cannot be copied.
+     * @param[in] other Another instance
+     */
+    EDCDecisionRecorder(const EDCDecisionRecorder & other) = delete;
+
+    /**
+     * @brief Flushes and closes the decision log file
+     */
+    ~EDCDecisionRecorder();
+
+    /**
+     * @brief Appends one take_decisions call to the decision log
+     * @param[in] what_happened The message sent to the external decision component
+     * @param[in] what_happened_size The size of the message sent to the external decision component
+     * @param[in] decisions The message received from the external decision component
+     * @param[in] decisions_size The size of the message received from the external decision component
+     */
+    void record(const uint8_t * what_happened, uint32_t what_happened_size,
+                const uint8_t * decisions, uint32_t decisions_size);
+
+    /**
+     * @brief Returns the number of take_decisions calls that have been recorded
+     * @return The number of take_decisions calls that have been recorded
+     */
+    uint64_t nb_records() const;
+
+private:
+    std::string _filename; //!< The name of the decision log file
+    FILE * _file = nullptr; //!< The decision log file
+    uint64_t _nb_records = 0; //!< The number of take_decisions calls that have been recorded
+};
+
+/**
+ * @brief Serves the decisions stored in a decision log file, as if they were taken by an external decision component
+ * @details The decision log is accessed via mmap and decisions are returned in place, without copy.
+ *          The what_happened messages must match the recorded ones, otherwise the simulation has diverged
+ *          from the recorded one and replaying it cannot go on.
+ */
+class EDCDecisionReplayer
+{
+public:
+    /**
+     * @brief Opens a decision log file
+     * @param[in] filename The name of the decision log file
+     */
+    explicit EDCDecisionReplayer(const std::string & filename);
+
+    /**
+     * @brief EDCDecisionReplayer cannot be copied.
+     * @param[in] other Another instance
+     */
+    EDCDecisionReplayer(const EDCDecisionReplayer & other) = delete;
+
+    /**
+     * @brief Unmaps the decision log file
+     */
+    ~EDCDecisionReplayer();
+
+    /**
+     * @brief Returns whether the decisions have been recorded in JSON format (or in flatbuffers's binary format)
+     * @return Whether the decisions have been recorded in JSON format
+     */
+    bool json_format() const;
+
+    /**
+     * @brief Checks that the replayed decision component is initialized as the recorded one
+     * @param[in] init_flags The initialization flags
+     * @throw std::runtime_error if the flags differ from the recorded ones
+     */
+    void check_init(uint32_t init_flags) const;
+
+    /**
+     * @brief Returns the recorded decisions of the next take_decisions call
+     * @param[in] what_happened The message sent to the decision component
+     * @param[in] what_happened_size The size of the message sent to the decision component
+     * @param[out] decisions The recorded decisions, followed by a NUL byte. They remain valid until the replayer is destroyed.
+     * @param[out] decisions_size The size of the recorded decisions
+     * @throw std::runtime_error if the simulation has diverged from the recorded one
+     */
+    void next_decisions(const uint8_t * what_happened, uint32_t what_happened_size,
+                        const uint8_t ** decisions, uint32_t * decisions_size);
+
+private:
+    std::string _filename; //!< The name of the decision log file
+    void * _mapping = nullptr; //!< The address where the decision log file is mapped
+    size_t _mapping_size = 0; //!< The size of the mapping
+    size_t _offset = 0; //!< The offset of the next record in the mapping
+    uint64_t _nb_replayed = 0; //!< The number of take_decisions calls that have been replayed
+    uint32_t _init_flags = 0; //!< The flags the recorded decision component has been initialized with
+};
@@ -0,0 +1,433 @@
+/**
+ * @file edc_shm.hpp
+ * @brief Shared-memory transport between Batsim and an External Decision Component process running on the same machine
+ * @details This file is header-only and only depends on the C++ standard library and on Linux system calls,
+ *          so that EDC hosts (e.g., edc-shm-host in test/edc-lib) can use it without linking with Batsim.
+ *
+ *          The shared-memory segment contains two byte ring buffers (one per direction).
+ *          Messages are framed as a 32-bit size followed by the message content, and can be bigger than the rings.
+ *          Readers and writers first spin then sleep on futexes, so that round trips cost no system call
+ *          when both processes are active, and no CPU when one of them waits for a long time.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace edc_shm
+{
+
+static const char ENDPOINT_PREFIX[] = "shm://"; //!< The prefix of the EDC endpoints that use this transport
+static const char MAGIC[8] = {'B', 'A', 'T', 'E', 'D', 'C', 'S', 'M'}; //!< Identifies Batsim EDC shared-memory segments
+static const uint32_t VERSION = 1; //!< The version of the segment layout
+static const uint32_t DEFAULT_RING_CAPACITY = 1 << 20; //!< The default capacity of each ring buffer, in bytes
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared-memory atomics must be lock-free");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "shared-memory atomics must be lock-free");
+
+/**
+ * @brief Returns whether an EDC endpoint designates a shared-memory segment
+ * @param[in] endpoint The EDC endpoint
+ * @return Whether the endpoint starts with ENDPOINT_PREFIX
+ */
+inline bool is_shm_endpoint(const std::string & endpoint)
+{
+    return endpoint.compare(0, sizeof(ENDPOINT_PREFIX) - 1, ENDPOINT_PREFIX) == 0;
+}
+
+/**
+ * @brief The control data of one ring buffer (one direction of the channel)
+ */
+struct Ring
+{
+    alignas(64) std::atomic<uint64_t> write_pos; //!< The number of bytes written since the creation of the ring
+    std::atomic<uint32_t> data_seq; //!< Futex word incremented after each write
+    std::atomic<uint32_t> nb_data_waiters; //!< The number of readers sleeping on data_seq
+
+    alignas(64) std::atomic<uint64_t> read_pos; //!< The number of bytes read since the creation of the ring
+    std::atomic<uint32_t> space_seq; //!< Futex word incremented after each read
+    std::atomic<uint32_t> nb_space_waiters; //!< The number of writers sleeping on space_seq
+};
+
+/**
+ * @brief The header of the shared-memory segment. The data of the two rings follows it.
+ */
+struct Header
+{
+    char magic[8]; //!< Must be MAGIC
+    uint32_t version; //!< Must be VERSION
+    uint32_t ring_capacity; //!< The capacity of each ring, in bytes
+    std::atomic<int32_t> host_pid; //!< The process id of the EDC host
+    std::atomic<int32_t> batsim_pid; //!< The process id of Batsim, once connected
+    std::atomic<uint32_t> closed; //!< Set when either side closes the channel
+    std::atomic<uint32_t> ready; //!< Set by the EDC host once the segment is fully initialized
+    Ring to_edc; //!< The ring from Batsim to the EDC
+    Ring to_batsim; //!< The ring from the EDC to Batsim
+};
+
+/**
+ * @brief Sleeps on a futex word while it is equal to an expected value (or until a timeout)
+ * @param[in] word The futex word
+ * @param[in] expected The value the word is expected to have
+ */
+inline void futex_wait(std::atomic<uint32_t> * word, uint32_t expected)
+{
+    // The timeout lets the caller check periodically that its peer is still alive
+    struct timespec timeout = {0, 100 * 1000 * 1000};
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(word), FUTEX_WAIT, expected, &timeout, nullptr, 0);
+}
+
+/**
+ * @brief Wakes up all the processes sleeping on a futex word
+ * @param[in] word The futex word
+ */
+inline void futex_wake(std::atomic<uint32_t> * word)
+{
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+/**
+ * @brief One side of a bidirectional message channel between Batsim and an EDC process
+ * @details Communication failures (peer gone, channel closed, system errors) are reported as std::runtime_error.
+ */
+class Channel
+{
+public:
+    /**
+     * @brief Creates the shared-memory segment of a channel (EDC host side)
+     * @param[in] name The name of the segment (without the shm:// prefix)
+     * @param[in] ring_capacity The capacity of each ring buffer, in bytes
+     * @return The newly allocated channel. The segment is removed when the channel is destroyed.
+     */
+    static Channel * create(const std::string & name, uint32_t ring_capacity = DEFAULT_RING_CAPACITY)
+    {
+        const std::string shm_name = "/" + name;
+        int fd = shm_open(shm_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd == -1)
+            throw std::runtime_error("Cannot create shared-memory segment '" + name + "' (errno=" + strerror(errno) + ")");
+
+        const size_t size = sizeof(Header) + 2 * static_cast<size_t>(ring_capacity);
+        if (ftruncate(fd, static_cast<off_t>(size)) != 0)
+        {
+            int error = errno;
+            close(fd);
+            shm_unlink(shm_name.c_str());
+            throw std::runtime_error("Cannot resize shared-memory segment '" + name + "' (errno=" + strerror(error) + ")");
+        }
+
+        Channel * channel = map(fd, size, name);
+        channel->_shm_name = shm_name;
+        channel->_is_edc_side = true;
+
+        Header * header = new (channel->_header) Header();
+        memcpy(header->magic, MAGIC, sizeof(MAGIC));
+        header->version = VERSION;
+        header->ring_capacity = ring_capacity;
+        header->host_pid = static_cast<int32_t>(getpid());
+        channel->set_rings();
+        header->ready.store(1);
+
+        return channel;
+    }
+
+    /**
+     * @brief Opens the shared-memory segment of a channel created by an EDC host (Batsim side)
+     * @details The segment may not exist yet, as the EDC host may be started after Batsim.
+     * @param[in] name The name of the segment (without the shm:// prefix)
+     * @param[in] timeout_seconds How long to wait for the segment to be created
+     * @return The newly allocated channel
+     */
+    static Channel * open(const std::string & name, double timeout_seconds = 10)
+    {
+        const std::string shm_name = "/" + name;
+        const int nb_tries = static_cast<int>(timeout_seconds * 100);
+        for (int i = 0; ; ++i)
+        {
+            int fd = shm_open(shm_name.c_str(), O_RDWR, 0600);
+            struct stat segment_stat;
+            if (fd != -1 && fstat(fd, &segment_stat) == 0 && static_cast<size_t>(segment_stat.st_size) >= sizeof(Header))
+            {
+                Channel * channel = map(fd, static_cast<size_t>(segment_stat.st_size), name);
+                if (channel->_header->ready.load() == 1)
+                {
+                    if (memcmp(channel->_header->magic, MAGIC, sizeof(MAGIC)) != 0 || channel->_header->version != VERSION ||
+                        channel->_mapping_size != sizeof(Header) + 2 * static_cast<size_t>(channel->_header->ring_capacity))
+                    {
+                        delete channel;
+                        throw std::runtime_error("Shared-memory segment '" + name + "' is not a compatible Batsim EDC channel");
+                    }
+
+                    channel->set_rings();
+                    channel->_header->batsim_pid = static_cast<int32_t>(getpid());
+                    return channel;
+                }
+                delete channel;
+            }
+            else if (fd != -1)
+            {
+                close(fd);
+            }
+
+            if (i >= nb_tries)
+                throw std::runtime_error("Shared-memory segment '" + name + "' has not been created by an EDC host");
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    /**
+     * @brief Channels cannot be copied.
+     * @param[in] other Another instance
+     */
+    Channel(const Channel & other) = delete;
+
+    /**
+     * @brief Closes the channel, unmaps the segment, and removes it on the EDC host side
+     */
+    ~Channel()
+    {
+        if (_header != nullptr && _rings_set)
+            close_channel();
+        if (_mapping != nullptr)
+            munmap(_mapping, _mapping_size);
+        if (!_shm_name.empty())
+            shm_unlink(_shm_name.c_str());
+    }
+
+    /**
+     * @brief Sends one message to the peer
+     * @param[in] data The message content
+     * @param[in] size The message size, in bytes
+     */
+    void send(const uint8_t * data, uint32_t size)
+    {
+        write_bytes(reinterpret_cast<const uint8_t *>(&size), sizeof(uint32_t));
+        write_bytes(data, size);
+    }
+
+    /**
+     * @brief Waits for one message from the peer
+     * @details The buffer holds the message followed by a NUL byte (size+1 octets),
+     *          so that JSON messages can be parsed in place by parsers that expect NUL-terminated strings.
+     * @param[out] buffer The received message, NUL-terminated. The vector is reused between calls to avoid allocations.
+     * @return The size of the message, without its NUL terminator
+     */
+    uint32_t receive(std::vector<uint8_t> & buffer)
+    {
+        uint32_t size = 0;
+        read_bytes(reinterpret_cast<uint8_t *>(&size), sizeof(uint32_t));
+        buffer.resize(static_cast<size_t>(size) + 1);
+        read_bytes(buffer.data(), size);
+        buffer[size] = 0;
+        return size;
+    }
+
+    /**
+     * @brief Tells the peer that no more messages will be sent
+     */
+    void close_channel()
+    {
+        _header->closed.store(1);
+        futex_wake(&_in->data_seq);
+        futex_wake(&_in->space_seq);
+        futex_wake(&_out->data_seq);
+        futex_wake(&_out->space_seq);
+    }
+
+    /**
+     * @brief Returns whether the channel has been closed by either side
+     * @return Whether the channel has been closed
+     */
+    bool is_closed() const
+    {
+        return _header->closed.load() != 0;
+    }
+
+private:
+    /**
+     * @brief Builds an empty Channel. Please refer to create and open.
+     */
+    Channel() = default;
+
+    /**
+     * @brief Maps a shared-memory segment into a new Channel
+     * @param[in] fd The file descriptor of the segment. It is closed by this function.
+     * @param[in] size The size of the segment
+     * @param[in] name The name of the segment
+     * @return The newly allocated channel
+     */
+    static Channel * map(int fd, size_t size, const std::string & name)
+    {
+        void * mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        int error = errno;
+        close(fd);
+        if (mapping == MAP_FAILED)
+            throw std::runtime_error("Cannot map shared-memory segment '" + name + "' (errno=" + strerror(error) + ")");
+
+        Channel * channel = new Channel;
+        channel->_mapping = mapping;
+        channel->_mapping_size = size;
+        channel->_header = static_cast<Header *>(mapping);
+        return channel;
+    }
+
+    /**
+     * @brief Sets the incoming and outgoing rings according to the side of the channel
+     */
+    void set_rings()
+    {
+        uint8_t * base = static_cast<uint8_t *>(_mapping) + sizeof(Header);
+        const uint32_t capacity = _header->ring_capacity;
+        _capacity = capacity;
+        if (_is_edc_side)
+        {
+            _in = &_header->to_edc;
+            _in_data = base;
+            _out = &_header->to_batsim;
+            _out_data = base + capacity;
+        }
+        else
+        {
+            _in = &_header->to_batsim;
+            _in_data = base + capacity;
+            _out = &_header->to_edc;
+            _out_data = base;
+        }
+        _rings_set = true;
+    }
+
+    /**
+     * @brief Throws if the peer has closed the channel or has died
+     */
+    void check_peer() const
+    {
+        if (is_closed())
+            throw std::runtime_error("The EDC shared-memory channel has been closed by the peer");
+
+        const int32_t peer_pid = _is_edc_side ? _header->batsim_pid.load() : _header->host_pid.load();
+        if (peer_pid > 0 && kill(peer_pid, 0) == -1 && errno == ESRCH)
+            throw std::runtime_error("The peer of the EDC shared-memory channel is gone");
+    }
+
+    /**
+     * @brief Waits until a condition holds, spinning first then sleeping on a futex word
+     * @param[in] seq The futex word bumped by the peer when the condition may have changed
+     * @param[in] nb_waiters The counter of processes sleeping on seq
+     * @param[in] condition The condition to wait for
+     */
+    template <typename Condition>
+    void wait_until(std::atomic<uint32_t> & seq, std::atomic<uint32_t> & nb_waiters, const Condition & condition)
+    {
+        for (int i = 0; i < SPIN_ITERATIONS; ++i)
+        {
+            if (condition())
+                return;
+        }
+
+        while (true)
+        {
+            ++nb_waiters;
+            const uint32_t seen_seq = seq.load();
+            if (condition())
+            {
+                --nb_waiters;
+                return;
+            }
+            check_peer();
+            futex_wait(&seq, seen_seq);
+            --nb_waiters;
+        }
+    }
+
+    /**
+     * @brief Writes bytes into the outgoing ring, waiting for free space when needed
+     * @param[in] data The bytes to write
+     * @param[in] size The number of bytes to write
+     */
+    void write_bytes(const uint8_t * data, size_t size)
+    {
+        while (size > 0)
+        {
+            const uint64_t write_pos = _out->write_pos.load(std::memory_order_relaxed);
+            wait_until(_out->space_seq, _out->nb_space_waiters,
+                [&]() { return write_pos - _out->read_pos.load() < _capacity; });
+
+            const uint64_t free_space = _capacity - (write_pos - _out->read_pos.load());
+            const size_t offset = static_cast<size_t>(write_pos % _capacity);
+            const size_t chunk = std::min(std::min(size, static_cast<size_t>(free_space)), _capacity - offset);
+            memcpy(_out_data + offset, data, chunk);
+
+            _out->write_pos.store(write_pos + chunk);
+            ++_out->data_seq;
+            if (_out->nb_data_waiters.load() > 0)
+                futex_wake(&_out->data_seq);
+
+            data += chunk;
+            size -= chunk;
+        }
+    }
+
+    /**
+     * @brief Reads bytes from the incoming ring, waiting for data when needed
+     * @param[out] data Where to write the read bytes
+     * @param[in] size The number of bytes to read
+     */
+    void read_bytes(uint8_t * data, size_t size)
+    {
+        while (size > 0)
+        {
+            const uint64_t read_pos = _in->read_pos.load(std::memory_order_relaxed);
+            wait_until(_in->data_seq, _in->nb_data_waiters,
+                [&]() { return _in->write_pos.load() > read_pos; });
+
+            const uint64_t available = _in->write_pos.load() - read_pos;
+            const size_t offset = static_cast<size_t>(read_pos % _capacity);
+            const size_t chunk = std::min(std::min(size, static_cast<size_t>(available)), _capacity - offset);
+            memcpy(data, _in_data + offset, chunk);
+
+            _in->read_pos.store(read_pos + chunk);
+            ++_in->space_seq;
+            if (_in->nb_space_waiters.load() > 0)
+                futex_wake(&_in->space_seq);
+
+            data += chunk;
+            size -= chunk;
+        }
+    }
+
+private:
+    static const int SPIN_ITERATIONS = 20000; //!< How many times a condition is checked before sleeping
+
+    void * _mapping = nullptr; //!< The address where the segment is mapped
+    size_t _mapping_size = 0; //!< The size of the mapping
+    std::string _shm_name; //!< The name of the segment, only set on the side that removes it
+    bool _is_edc_side = false; //!< Whether this is the EDC host side of the channel
+    bool _rings_set = false; //!< Whether set_rings has been called
+    Header * _header = nullptr; //!< The header of the segment
+    size_t _capacity = 0; //!< The capacity of each ring
+    Ring * _in = nullptr; //!< The incoming ring
+    uint8_t * _in_data = nullptr; //!< The data of the incoming ring
+    Ring * _out = nullptr; //!< The outgoing ring
+    uint8_t * _out_data = nullptr; //!< The data of the outgoing ring
+};
+
+} // end of namespace edc_shm
@@ -7,8 +7,10 @@
 #include "export.hpp"
 
 #include <algorithm>
+#include <charconv>
 #include <filesystem>
 #include <fstream>
+#include <limits>
 
 #include <boost/algorithm/string/join.hpp>
 
@@ -17,6 +19,7 @@
 #include <math.h>
 #include <float.h>
 
+#include "columnar.hpp"
 #include "context.hpp"
 #include "jobs.hpp"
 
@@ -57,9 +60,12 @@ void prepare_batsim_outputs(BatsimContext * context)
         }
     }
 
+    // Traces written through a WriteBuffer are compressed if their name ends with the codec extension
+    const string compressed_extension = compression_codec_extension(context->output_compression);
+
     if (context->trace_schedule)
     {
-        context->paje_tracer.set_filename(export_prefix_path.string() + "schedule.trace");
+        context->paje_tracer.set_filename(export_prefix_path.string() + "schedule.trace" + compressed_extension, context->async_outputs);
         context->machines.set_tracer(&context->paje_tracer);
         context->paje_tracer.initialize(context, simgrid::s4u::Engine::get_clock());
     }
@@ -67,17 +73,31 @@ void prepare_batsim_outputs(BatsimContext * context)
     if (context->trace_machine_states)
     {
         context->machine_state_tracer.set_context(context);
-        context->machine_state_tracer.set_filename(export_prefix_path.string() + "machine_states.csv");
+        if (context->columnar_outputs)
+        {
+            context->machine_state_tracer.set_columnar_filename(export_prefix_path.string() + "machine_states.batcol");
+        }
+        else
+        {
+            context->machine_state_tracer.set_filename(export_prefix_path.string() + "machine_states.csv" + compressed_extension, context->async_outputs);
+        }
     }
 
     if (context->energy_used)
     {
         // Energy consumption tracing
         context->energy_tracer.set_context(context);
-        context->energy_tracer.set_filename(export_prefix_path.string() + "consumed_energy.csv");
+        if (context->columnar_outputs)
+        {
+            context->energy_tracer.set_columnar_filename(export_prefix_path.string() + "consumed_energy.batcol");
+        }
+        else
+        {
+            context->energy_tracer.set_filename(export_prefix_path.string() + "consumed_energy.csv" + compressed_extension, context->async_outputs);
+        }
 
         // Power state tracing
-        context->pstate_tracer.setFilename(export_prefix_path.string() + "pstate_changes.csv");
+        context->pstate_tracer.setFilename(export_prefix_path.string() + "pstate_changes.csv" + compressed_extension, context->async_outputs);
 
         std::map<int, IntervalSet> pstate_to_machine_set;
         for (const Machine * machine : context->machines.machines())
@@ -105,9 +125,21 @@ void prepare_batsim_outputs(BatsimContext * context)
         }
     }
 
+    if (context->trace_server_profile)
+    {
+        context->server_profiler.enable(export_prefix_path.string() + "server_profile.csv");
+    }
+
+    string jobs_filename;
+    if (context->trace_jobs)
+    {
+        jobs_filename = (context->columnar_outputs ? export_prefix_path.string() + "jobs.batcol" : export_prefix_path.string() + "jobs.csv" + compressed_extension);
+    }
     context->jobs_tracer.initialize(context,
-                                    export_prefix_path.string() + "jobs.csv",
-                                    export_prefix_path.string() + "schedule.csv");
+                                    jobs_filename,
+                                    export_prefix_path.string() + "schedule.csv",
+                                    context->async_outputs,
+                                    context->columnar_outputs);
 }
 
 void finalize_batsim_outputs(BatsimContext * context)
@@ -139,17 +171,43 @@ void finalize_batsim_outputs(BatsimContext * context)
 
     // Finalize both jobs and schedule output files
     context->jobs_tracer.finalize();
+
+    // All the I/O threads of asynchronous outputs have been joined when their buffers were closed above
+
+    // Server loop profile
+    context->server_profiler.write_results();
 }
 
 
-WriteBuffer::WriteBuffer(const std::string & filename, size_t buffer_size)
-    : buffer_size(buffer_size)
+WriteBuffer::WriteBuffer(const std::string & filename, size_t buffer_size, bool asynchronous)
+    : filename(filename), buffer_size(buffer_size), asynchronous(asynchronous)
 {
     xbt_assert(buffer_size > 0, "Invalid buffer size (%zu)", buffer_size);
-    buffer = new char[buffer_size];
 
-    f.open(filename, ios_base::trunc);
+    const CompressionCodec codec = compression_codec_from_filename(filename);
+    f.open(filename, codec == CompressionCodec::NONE ? ios_base::trunc : ios_base::trunc | ios_base::binary);
     xbt_assert(f.is_open(), "Cannot write file '%s'", filename.c_str());
+    if (codec != CompressionCodec::NONE)
+    {
+        compressor = StreamCompressor::create(codec, f);
+    }
+
+    if (asynchronous)
+    {
+        async_buffers.resize(nb_async_buffers);
+        async_sizes.resize(nb_async_buffers, 0);
+        for (char * & async_buffer : async_buffers)
+        {
+            async_buffer = new char[buffer_size];
+        }
+        buffer = async_buffers[fill_index];
+
+        io_thread = std::thread(&WriteBuffer::write_pending_buffers, this);
+    }
+    else
+    {
+        buffer = new char[buffer_size];
+    }
 }
 
 WriteBuffer::~WriteBuffer()
@@ -161,17 +219,45 @@ WriteBuffer::~WriteBuffer()
 
     if (buffer != nullptr)
     {
-        delete[] buffer;
+        if (asynchronous)
+        {
+            {
+                std::lock_guard<std::mutex> lock(async_mutex);
+                closing = true;
+            }
+            async_cond.notify_all();
+            io_thread.join();
+
+            for (char * async_buffer : async_buffers)
+            {
+                delete[] async_buffer;
+            }
+            async_buffers.clear();
+        }
+        else
+        {
+            delete[] buffer;
+        }
         buffer = nullptr;
 
+        if (compressor != nullptr)
+        {
+            compressor->finish();
+            compressor.reset();
+        }
+
         f.close();
+        xbt_assert(!f.fail(), "Cannot write file '%s'", filename.c_str());
     }
 }
 
 void WriteBuffer::append_text(const char * text)
 {
-    const size_t text_length = strlen(text);
+    append_text(text, strlen(text));
+}
 
+void WriteBuffer::append_text(const char * text, size_t text_length)
+{
     // Is the buffer big enough?
     if (buffer_pos + text_length < buffer_size)
     {
@@ -191,20 +277,96 @@ void WriteBuffer::append_text(const char * text)
             memcpy(buffer, text, text_length * sizeof(char));
             buffer_pos = text_length;
         }
-        else
+        else if (!asynchronous)
         {
             // Directly write the text into the file
-            f.write(text, static_cast<std::streamsize>(text_length));
+            write_to_file(text, text_length);
+        }
+        else
+        {
+            // Only the I/O thread writes into the file: hand the text over by buffer-sized chunks
+            while (text_length >= buffer_size)
+            {
+                memcpy(buffer, text, buffer_size * sizeof(char));
+                buffer_pos = buffer_size;
+                flush_buffer();
+
+                text += buffer_size;
+                text_length -= buffer_size;
+            }
+
+            memcpy(buffer, text, text_length * sizeof(char));
+            buffer_pos = text_length;
         }
     }
 }
 
 void WriteBuffer::flush_buffer()
 {
-    f.write(buffer, static_cast<std::streamsize>(buffer_pos));
+    if (!asynchronous)
+    {
+        write_to_file(buffer, buffer_pos);
+        buffer_pos = 0;
+        return;
+    }
+
+    if (buffer_pos == 0)
+    {
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(async_mutex);
+        async_sizes[fill_index] = buffer_pos;
+        ++nb_pending;
+        async_cond.notify_all();
+
+        // Backpressure: the next buffer of the ring is free once fewer than all buffers are pending
+        async_cond.wait(lock, [this]{ return nb_pending < nb_async_buffers; });
+    }
+
+    fill_index = (fill_index + 1) % nb_async_buffers;
+    buffer = async_buffers[fill_index];
     buffer_pos = 0;
 }
 
+void WriteBuffer::write_pending_buffers()
+{
+    std::unique_lock<std::mutex> lock(async_mutex);
+    for (;;)
+    {
+        async_cond.wait(lock, [this]{ return nb_pending > 0 || closing; });
+        if (nb_pending == 0)
+        {
+            // Closing and all buffers have been written
+            break;
+        }
+
+        // The buffer is not modified by the simulation thread while it is pending
+        const char * data = async_buffers[write_index];
+        const size_t size = async_sizes[write_index];
+        lock.unlock();
+        write_to_file(data, size);
+        lock.lock();
+
+        write_index = (write_index + 1) % nb_async_buffers;
+        --nb_pending;
+        async_cond.notify_all();
+    }
+}
+
+void WriteBuffer::write_to_file(const char * data, size_t size)
+{
+    if (compressor != nullptr)
+    {
+        compressor->write(data, size);
+    }
+    else
+    {
+        f.write(data, static_cast<std::streamsize>(size));
+    }
+}
+
 
 
 
@@ -216,10 +378,10 @@ PajeTracer::PajeTracer(bool log_launchings) :
     shuffle_colors();
 }
 
-void PajeTracer::set_filename(const string &filename)
+void PajeTracer::set_filename(const string &filename, bool asynchronous)
 {
     xbt_assert(_wbuf == nullptr, "Double call of PajeTracer::set_filename");
-    _wbuf = new WriteBuffer(filename);
+    _wbuf = new WriteBuffer(filename, 64*1024, asynchronous);
 }
 
 PajeTracer::~PajeTracer()
@@ -729,10 +891,10 @@ PStateChangeTracer::PStateChangeTracer()
     xbt_assert(_temporary_buffer != NULL, "Couldn't allocate memory");
 }
 
-void PStateChangeTracer::setFilename(const string &filename)
+void PStateChangeTracer::setFilename(const string &filename, bool asynchronous)
 {
     xbt_assert(_wbuf == nullptr, "Double call of PStateChangeTracer::setFilename");
-    _wbuf = new WriteBuffer(filename);
+    _wbuf = new WriteBuffer(filename, 64*1024, asynchronous);
 
     _wbuf->append_text("time,machine_id,new_pstate\n");
 }
@@ -798,6 +960,12 @@ EnergyConsumptionTracer::~EnergyConsumptionTracer()
         delete _wbuf;
         _wbuf = nullptr;
     }
+
+    if (_columnar != nullptr)
+    {
+        delete _columnar;
+        _columnar = nullptr;
+    }
 }
 
 void EnergyConsumptionTracer::set_context(BatsimContext *context)
@@ -806,14 +974,26 @@ void EnergyConsumptionTracer::set_context(BatsimContext *context)
     _context = context;
 }
 
-void EnergyConsumptionTracer::set_filename(const string &filename)
+void EnergyConsumptionTracer::set_filename(const string &filename, bool asynchronous)
 {
     xbt_assert(_wbuf == nullptr, "Double call of EnergyConsumptionTracer::set_filename");
-    _wbuf = new WriteBuffer(filename);
+    _wbuf = new WriteBuffer(filename, 64*1024, asynchronous);
 
     _wbuf->append_text("time,energy,event_type,wattmin,epower\n");
 }
 
+void EnergyConsumptionTracer::set_columnar_filename(const string &filename)
+{
+    xbt_assert(_wbuf == nullptr && _columnar == nullptr, "Double call of EnergyConsumptionTracer::set_columnar_filename");
+    _columnar = new ColumnarWriter(filename, {
+        {"time", ColumnType::FLOAT64},
+        {"energy", ColumnType::FLOAT64},
+        {"event_type", ColumnType::DICTIONARY_STRING},
+        {"wattmin", ColumnType::FLOAT64},
+        {"epower", ColumnType::FLOAT64}
+    });
+}
+
 void EnergyConsumptionTracer::add_job_start(double date, JobIdentifier job_id)
 {
     (void) job_id;
@@ -835,22 +1015,30 @@ void EnergyConsumptionTracer::add_pstate_change(double date, const IntervalSet &
 
 void EnergyConsumptionTracer::flush()
 {
-    xbt_assert(_wbuf != nullptr, "wrong call: _wbuf is null");
+    xbt_assert(_wbuf != nullptr || _columnar != nullptr, "wrong call: _wbuf is null");
+
+    if (_columnar != nullptr)
+    {
+        _columnar->flush_row_group();
+        return;
+    }
 
     _wbuf->flush_buffer();
 }
 
 void EnergyConsumptionTracer::close_buffer()
 {
-    xbt_assert(_wbuf != nullptr, "wrong call: _wbuf is null");
+    xbt_assert(_wbuf != nullptr || _columnar != nullptr, "wrong call: _wbuf is null");
 
     delete _wbuf;
     _wbuf = nullptr;
+    delete _columnar;
+    _columnar = nullptr;
 }
 
 long double EnergyConsumptionTracer::add_entry(double date, char event_type)
 {
-    xbt_assert(_wbuf != nullptr, "wrong call: _wbuf is null");
+    xbt_assert(_wbuf != nullptr || _columnar != nullptr, "wrong call: _wbuf is null");
 
     long double energy = _context->machines.total_consumed_energy(_context);
     long double wattmin = _context->machines.total_wattmin(_context);
@@ -864,6 +1052,20 @@ long double EnergyConsumptionTracer::add_entry(double date, char event_type)
         epower = energy_diff / time_diff;
     }
 
+    if (_columnar != nullptr)
+    {
+        _columnar->append_float64(date);
+        _columnar->append_float64(static_cast<double>(energy));
+        _columnar->append_string(std::string_view(&event_type, 1));
+        _columnar->append_float64(static_cast<double>(wattmin));
+        _columnar->append_float64(epower != -1 ? static_cast<double>(epower) : std::numeric_limits<double>::quiet_NaN());
+        _columnar->end_row();
+
+        _last_entry_date = static_cast<long double>(date);
+        _last_entry_energy = energy;
+        return energy;
+    }
+
     const int buf_size = 256;
     int nb_printed;
     (void) nb_printed; // Avoids a warning if assertions are ignored
@@ -900,11 +1102,22 @@ long double EnergyConsumptionTracer::add_entry(double date, char event_type)
 
 MachineStateTracer::~MachineStateTracer()
 {
+    if (_wbuf != nullptr || _columnar != nullptr)
+    {
+        write_pending_row();
+    }
+
     if (_wbuf != nullptr)
     {
         delete _wbuf;
         _wbuf = nullptr;
     }
+
+    if (_columnar != nullptr)
+    {
+        delete _columnar;
+        _columnar = nullptr;
+    }
 }
 
 void MachineStateTracer::set_context(BatsimContext *context)
@@ -912,10 +1125,10 @@ void MachineStateTracer::set_context(BatsimContext *context)
     _context = context;
 }
 
-void MachineStateTracer::set_filename(const string &filename)
+void MachineStateTracer::set_filename(const string &filename, bool asynchronous)
 {
     xbt_assert(_wbuf == nullptr, "Double call of MachineStateTracer::set_filename");
-    _wbuf = new WriteBuffer(filename);
+    _wbuf = new WriteBuffer(filename, 64*1024, asynchronous);
 
     vector<string> header_substrings;
     const vector<MachineState> machine_states = {MachineState::SLEEPING,
@@ -934,48 +1147,104 @@ void MachineStateTracer::set_filename(const string &filename)
     _wbuf->flush_buffer();
 }
 
+void MachineStateTracer::set_columnar_filename(const string &filename)
+{
+    xbt_assert(_wbuf == nullptr && _columnar == nullptr, "Double call of MachineStateTracer::set_columnar_filename");
+
+    vector<pair<string, ColumnType> > columns = {{"time", ColumnType::FLOAT64}};
+    const vector<MachineState> machine_states = {MachineState::SLEEPING,
+                                                 MachineState::TRANSITING_FROM_SLEEPING_TO_COMPUTING,
+                                                 MachineState::TRANSITING_FROM_COMPUTING_TO_SLEEPING,
+                                                 MachineState::IDLE,
+                                                 MachineState::COMPUTING};
+    for (const MachineState & state : machine_states)
+    {
+        columns.push_back({"nb_" + machine_state_to_string(state), ColumnType::INT64});
+    }
+
+    _columnar = new ColumnarWriter(filename, columns);
+}
+
 void MachineStateTracer::write_machine_states(double date)
 {
     xbt_assert(_context != nullptr, "wrong call: _context is null");
-    xbt_assert(_wbuf != nullptr, "wrong call: _wbuf is null");
+    xbt_assert(_wbuf != nullptr || _columnar != nullptr, "wrong call: _wbuf is null");
 
-    const std::map<MachineState, int> & numbers = _context->machines.nb_machines_in_each_state();
+    // Coalesce the rows of a same date: only the last state at each date is written
+    if (_has_pending_row && date != _pending_date)
+    {
+        write_pending_row();
+    }
 
-    const int buf_size = 256;
-    int nb_printed;
-    (void) nb_printed; // Avoids a warning if assertions are ignored
-    char * buf = static_cast<char*>(malloc(sizeof(char) * buf_size));
-    xbt_assert(buf != NULL, "Couldn't allocate memory");
+    const Machines & machines = _context->machines;
+    _has_pending_row = true;
+    _pending_date = date;
+    _pending_numbers[0] = machines.nb_machines_in_state(MachineState::SLEEPING);
+    _pending_numbers[1] = machines.nb_machines_in_state(MachineState::TRANSITING_FROM_SLEEPING_TO_COMPUTING);
+    _pending_numbers[2] = machines.nb_machines_in_state(MachineState::TRANSITING_FROM_COMPUTING_TO_SLEEPING);
+    _pending_numbers[3] = machines.nb_machines_in_state(MachineState::IDLE);
+    _pending_numbers[4] = machines.nb_machines_in_state(MachineState::COMPUTING);
+}
 
-    nb_printed = snprintf(buf, buf_size, "%g,%d,%d,%d,%d,%d\n",
-                          date,
-                          numbers.at(MachineState::SLEEPING),
-                          numbers.at(MachineState::TRANSITING_FROM_SLEEPING_TO_COMPUTING),
-                          numbers.at(MachineState::TRANSITING_FROM_COMPUTING_TO_SLEEPING),
-                          numbers.at(MachineState::IDLE),
-                          numbers.at(MachineState::COMPUTING));
-    xbt_assert(nb_printed < buf_size - 1,
+void MachineStateTracer::write_pending_row()
+{
+    if (!_has_pending_row)
+    {
+        return;
+    }
+    _has_pending_row = false;
+
+    if (_columnar != nullptr)
+    {
+        _columnar->append_float64(_pending_date);
+        for (int i = 0; i < NB_TRACED_STATES; ++i)
+        {
+            _columnar->append_int64(_pending_numbers[i]);
+        }
+        _columnar->end_row();
+        return;
+    }
+
+    char buf[256];
+    int nb_printed = snprintf(buf, sizeof(buf), "%g,%d,%d,%d,%d,%d\n",
+                              _pending_date,
+                              _pending_numbers[0],
+                              _pending_numbers[1],
+                              _pending_numbers[2],
+                              _pending_numbers[3],
+                              _pending_numbers[4]);
+    (void) nb_printed; // Avoids a warning if assertions are ignored
+    xbt_assert(nb_printed > 0 && nb_printed < static_cast<int>(sizeof(buf)),
                "Writing error: buffer has been completely filled, some information might "
                "have been lost. Please increase Batsim's output temporary buffers' size");
-    xbt_assert(_wbuf != nullptr, "wrong call: _wbuf is null");
-    _wbuf->append_text(buf);
-
-    free(buf);
+    _wbuf->append_text(buf, static_cast<size_t>(nb_printed));
 }
 
 void MachineStateTracer::flush()
 {
-    xbt_assert(_wbuf != nullptr, "wrong call: _wbuf is null");
+    xbt_assert(_wbuf != nullptr || _columnar != nullptr, "wrong call: _wbuf is null");
+
+    write_pending_row();
+
+    if (_columnar != nullptr)
+    {
+        _columnar->flush_row_group();
+        return;
+    }
 
     _wbuf->flush_buffer();
 }
 
 void MachineStateTracer::close_buffer()
 {
-    xbt_assert(_wbuf != nullptr, "wrong call: _wbuf is null");
+    xbt_assert(_wbuf != nullptr || _columnar != nullptr, "wrong call: _wbuf is null");
+
+    write_pending_row();
 
     delete _wbuf;
     _wbuf = nullptr;
+    delete _columnar;
+    _columnar = nullptr;
 }
 
 /* Part related to JobsTracer */
@@ -987,41 +1256,60 @@ JobsTracer::~JobsTracer()
         delete _wbuf;
         _wbuf = nullptr;
     }
+
+    if (_columnar != nullptr)
+    {
+        delete _columnar;
+        _columnar = nullptr;
+    }
 }
 
 void JobsTracer::initialize(BatsimContext *context,
                        const string & jobs_filename,
-                       const string & schedule_filename)
+                       const string & schedule_filename,
+                       bool asynchronous,
+                       bool columnar)
 {
-    xbt_assert(_wbuf == nullptr, "Double call of JobsTracer::initialize");
-    _wbuf = new WriteBuffer(jobs_filename);
+    xbt_assert(_wbuf == nullptr && _columnar == nullptr, "Double call of JobsTracer::initialize");
     _context = context;
     _schedule_filename = schedule_filename;
+    _row.reserve(256);
 
-    // Prepare for jobs output file
-    _job_keys = {
-        "job_id",
-        "workload_name",
-        "profile",
-        "submission_time",
-        "requested_number_of_resources",
-        "requested_time",
-        "success",
-        "final_state",
-        "starting_time",
-        "execution_time",
-        "finish_time",
-        "waiting_time",
-        "turnaround_time",
-        "stretch",
-        "allocated_resources",
-        "consumed_energy",
-        "metadata"
-    };
-    string header = boost::algorithm::join(_job_keys, ",") + "\n";
-    _row_content.reserve(_job_keys.size());
-    _wbuf->append_text(header.c_str());
-    _wbuf->flush_buffer();
+    // Prepare for jobs output file. The columns must match the ones written by write_job.
+    if (jobs_filename.empty())
+    {
+        // Jobs are not traced
+    }
+    else if (columnar)
+    {
+        _columnar = new ColumnarWriter(jobs_filename, {
+            {"job_id", ColumnType::STRING},
+            {"workload_name", ColumnType::DICTIONARY_STRING},
+            {"profile", ColumnType::DICTIONARY_STRING},
+            {"submission_time", ColumnType::FLOAT64},
+            {"requested_number_of_resources", ColumnType::INT64},
+            {"requested_time", ColumnType::FLOAT64},
+            {"success", ColumnType::INT64},
+            {"final_state", ColumnType::DICTIONARY_STRING},
+            {"starting_time", ColumnType::FLOAT64},
+            {"execution_time", ColumnType::FLOAT64},
+            {"finish_time", ColumnType::FLOAT64},
+            {"waiting_time", ColumnType::FLOAT64},
+            {"turnaround_time", ColumnType::FLOAT64},
+            {"stretch", ColumnType::FLOAT64},
+            {"allocated_resources", ColumnType::STRING},
+            {"consumed_energy", ColumnType::FLOAT64},
+            {"metadata", ColumnType::DICTIONARY_STRING}
+        });
+    }
+    else
+    {
+        _wbuf = new WriteBuffer(jobs_filename, 64*1024, asynchronous);
+        _wbuf->append_text("job_id,workload_name,profile,submission_time,requested_number_of_resources,requested_time,"
+                           "success,final_state,starting_time,execution_time,finish_time,waiting_time,turnaround_time,"
+                           "stretch,allocated_resources,consumed_energy,metadata\n");
+        _wbuf->flush_buffer();
+    }
 
     // Prepare for schedule output file
     for (int i = 0; i < static_cast<int>(context->machines.nb_machines()); ++i)
@@ -1085,6 +1373,24 @@ void JobsTracer::finalize()
 
     output_map["nb_computing_machines"] = to_string(_context->machines.nb_machines());
 
+    // Quantiles of the job metrics. Global distributions are merged from the per-workload ones.
+    JobMetricsDistributions global_distributions;
+    for (auto & mit : _distributions_by_workload)
+    {
+        global_distributions.waiting_time.merge(mit.second.waiting_time);
+        global_distributions.turnaround_time.merge(mit.second.turnaround_time);
+        global_distributions.slowdown.merge(mit.second.slowdown);
+    }
+    write_quantiles(output_map, global_distributions, "");
+
+    if (_distributions_by_workload.size() > 1)
+    {
+        for (auto & mit : _distributions_by_workload)
+        {
+            write_quantiles(output_map, mit.second, mit.first + "!");
+        }
+    }
+
     XBT_INFO("jobs=%d, finished=%d, success=%d, killed=%d, success_rate=%lf",
              _nb_jobs, _nb_jobs_finished, _nb_jobs_success, _nb_jobs_killed, success_rate);
     XBT_INFO("makespan=%lf, scheduling_time=%lf, mean_waiting_time=%lf, mean_turnaround_time=%lf, "
@@ -1102,28 +1408,18 @@ void JobsTracer::finalize()
     output_map["nb_grouped_switches"] = to_string(_context->nb_grouped_switches);
 
     // Let's compute machine-related metrics
-    map<MachineState, long double> time_spent_in_each_state;
-    const vector<MachineState> machine_states = {MachineState::SLEEPING, MachineState::IDLE,
-                                                 MachineState::COMPUTING,
-                                                 MachineState::TRANSITING_FROM_SLEEPING_TO_COMPUTING,
-                                                 MachineState::TRANSITING_FROM_COMPUTING_TO_SLEEPING,
-                                                 MachineState::UNAVAILABLE};
-    for (const MachineState & state : machine_states)
-    {
-        time_spent_in_each_state[state] = 0;
-    }
-
+    std::array<long double, NB_MACHINE_STATES> time_spent_in_each_state = {};
     for (const Machine * machine : _context->machines.machines())
     {
-        for (const MachineState & state : machine_states)
+        for (size_t i = 0; i < NB_MACHINE_STATES; ++i)
         {
-            time_spent_in_each_state[state] += machine->time_spent_in_each_state.at(state);
+            time_spent_in_each_state[i] += machine->time_spent_in_each_state[i];
         }
     }
 
-    for (const MachineState & state : machine_states)
+    for (size_t i = 0; i < NB_MACHINE_STATES; ++i)
     {
-        output_map["time_" + machine_state_to_string(state)] = to_string(static_cast<double>(time_spent_in_each_state[state]));
+        output_map["time_" + machine_state_to_string(static_cast<MachineState>(i))] = to_string(static_cast<double>(time_spent_in_each_state[i]));
     }
 
     // Let's write the output map into the file
@@ -1140,8 +1436,116 @@ void JobsTracer::finalize()
     f.close();
 }
 
+void JobsTracer::write_quantiles(std::map<std::string, std::string> & output_map,
+                                 JobMetricsDistributions & distributions,
+                                 const std::string & key_prefix)
+{
+    const std::pair<const char *, double> quantiles[] = {{"p50", 0.5}, {"p90", 0.9}, {"p99", 0.99}};
+    for (const auto & quantile : quantiles)
+    {
+        const string suffix = string(quantile.first) + "_";
+        output_map[key_prefix + suffix + "waiting_time"] = to_string(distributions.waiting_time.quantile(quantile.second));
+        output_map[key_prefix + suffix + "turnaround_time"] = to_string(distributions.turnaround_time.quantile(quantile.second));
+        output_map[key_prefix + suffix + "slowdown"] = to_string(distributions.slowdown.quantile(quantile.second));
+    }
+}
+
+/**
+ * @brief Appends an integer to a CSV row
+ * @param[in,out] row The row
+ * @param[in] value The value to append
+ */
+static void append_csv_value(string & row, long long value)
+{
+    char buf[24];
+    const auto result = std::to_chars(buf, buf + sizeof(buf), value);
+    row.append(buf, static_cast<size_t>(result.ptr - buf));
+}
+
+/**
+ * @brief Appends an integer to a CSV row
+ * @param[in,out] row The row
+ * @param[in] value The value to append
+ */
+static void append_csv_value(string & row, int value)
+{
+    append_csv_value(row, static_cast<long long>(value));
+}
+
+/**
+ * @brief Appends an integer to a CSV row
+ * @param[in,out] row The row
+ * @param[in] value The value to append
+ */
+static void append_csv_value(string & row, unsigned int value)
+{
+    append_csv_value(row, static_cast<long long>(value));
+}
+
+/**
+ * @brief Appends a floating-point value to a CSV row, formatted as std::to_string does (%f)
+ * @param[in,out] row The row
+ * @param[in] value The value to append
+ */
+static void append_csv_value(string & row, double value)
+{
+    char buf[64];
+    const int length = snprintf(buf, sizeof(buf), "%f", value);
+    if (length >= 0 && static_cast<size_t>(length) < sizeof(buf))
+    {
+        row.append(buf, static_cast<size_t>(length));
+    }
+    else
+    {
+        row += to_string(value); // huge values
+    }
+}
+
+/**
+ * @brief Appends a set of machines to a CSV row, formatted as IntervalSet::to_string_hyphen(" ") does
+ * @param[in,out] row The row
+ * @param[in] machines The set of machines
+ */
+static void append_csv_allocation(string & row, const IntervalSet & machines)
+{
+    for (auto it = machines.intervals_begin(); it != machines.intervals_end(); ++it)
+    {
+        if (it != machines.intervals_begin())
+        {
+            row += ' ';
+        }
+        append_csv_value(row, it->lower());
+        if (it->upper() != it->lower())
+        {
+            row += '-';
+            append_csv_value(row, it->upper());
+        }
+    }
+}
+
+/**
+ * @brief Appends a floating-point value to a CSV row, formatted as std::to_string does (%Lf)
+ * @param[in,out] row The row
+ * @param[in] value The value to append
+ */
+static void append_csv_value(string & row, long double value)
+{
+    char buf[64];
+    const int length = snprintf(buf, sizeof(buf), "%Lf", value);
+    if (length >= 0 && static_cast<size_t>(length) < sizeof(buf))
+    {
+        row.append(buf, static_cast<size_t>(length));
+    }
+    else
+    {
+        row += to_string(value); // huge values
+    }
+}
+
 void JobsTracer::write_job(const JobPtr job)
 {
+    ProfilingScope profiling_scope(_context->server_profiler.phase_counter(ServerPhase::WRITE_JOB));
+
     int success = (job->state == JobState::JOB_STATE_COMPLETED_SUCCESSFULLY);
     bool rejected = (job->state == JobState::JOB_STATE_REJECTED);
 
@@ -1176,6 +1580,11 @@ void JobsTracer::write_job(const JobPtr job)
             _sum_turnaround_time += turnaround_time;
             _sum_slowdown += slowdown;
 
+            JobMetricsDistributions & distributions = _distributions_by_workload[job->workload->name];
+            distributions.waiting_time.add(static_cast<double>(waiting_time));
+            distributions.turnaround_time.add(static_cast<double>(turnaround_time));
+            distributions.slowdown.add(static_cast<double>(slowdown));
+
             if (completion_time > _makespan)
             {
                 _makespan = completion_time;
@@ -1208,46 +1617,118 @@ void JobsTracer::write_job(const JobPtr job)
         xbt_die("Job %s did not complete", job->id.job_name().c_str());
     }
 
-    // Set all values to be written
-    _job_map["job_id"] = job->id.job_name();
-    _job_map["workload_name"] = job->workload->name;
-    _job_map["profile"] = (job->profile)->name;
-    _job_map["submission_time"] = to_string(static_cast<double>(job->submission_time));
-    _job_map["requested_number_of_resources"] = to_string(job->requested_nb_res);
-    _job_map["requested_time"] = to_string(static_cast<double>(job->walltime));
-    _job_map["success"] = to_string(success);
-    _job_map["final_state"] = job_state_to_string(job->state);
-    _job_map["starting_time"] = rejected ? "" : to_string(static_cast<double>(job->starting_time));
-    _job_map["execution_time"] = rejected ? "" : to_string(static_cast<double>(job->runtime));
-    _job_map["finish_time"] = rejected ? "" : to_string(static_cast<double>(job->starting_time + job->runtime));
-    _job_map["waiting_time"] = rejected ? "" : to_string(static_cast<double>(job->starting_time - job->submission_time));
-    _job_map["turnaround_time"] = rejected ? "" : to_string(static_cast<double>(job->starting_time + job->runtime - job->submission_time));
-    _job_map["stretch"] = rejected ? "" : to_string(static_cast<double>((job->starting_time + job->runtime - job->submission_time) / job->runtime));
-    _job_map["consumed_energy"] = rejected ? "" : to_string(job->consumed_energy);
+    if (_columnar != nullptr)
+    {
+        write_job_columnar(job, success, rejected);
+        return;
+    }
+    else if (_wbuf == nullptr)
+    {
+        return; // jobs are not traced
+    }
 
-    if (job->execution_request.get() != nullptr)
-        _job_map["allocated_resources"] = job->execution_request->job_allocation->hosts.to_string_hyphen(" ");
+    // Format the row directly, in the column order of the header written by initialize
+    _row.clear();
+    const string & job_id = job->id.to_string();
+    _row.append(job_id, job->id.workload_name().size() + 1, string::npos); // job name, after WORKLOAD_NAME!
+    _row += ',';
+    _row += job->workload->name;
+    _row += ',';
+    _row += job->profile->name;
+    _row += ',';
+    append_csv_value(_row, static_cast<double>(job->submission_time));
+    _row += ',';
+    append_csv_value(_row, job->requested_nb_res);
+    _row += ',';
+    append_csv_value(_row, static_cast<double>(job->walltime));
+    _row += ',';
+    append_csv_value(_row, success);
+    _row += ',';
+    _row += job_state_to_cstring(job->state);
+    _row += ',';
+    if (!rejected)
+    {
+        append_csv_value(_row, static_cast<double>(job->starting_time));
+        _row += ',';
+        append_csv_value(_row, static_cast<double>(job->runtime));
+        _row += ',';
+        append_csv_value(_row, static_cast<double>(job->starting_time + job->runtime));
+        _row += ',';
+        append_csv_value(_row, static_cast<double>(job->starting_time - job->submission_time));
+        _row += ',';
+        append_csv_value(_row, static_cast<double>(job->starting_time + job->runtime - job->submission_time));
+        _row += ',';
+        append_csv_value(_row, static_cast<double>((job->starting_time + job->runtime - job->submission_time) / job->runtime));
+        _row += ',';
+    }
     else
-        _job_map["allocated_resources"] = "";
+    {
+        _row.append(6, ',');
+    }
+    if (job->execution_request.get() != nullptr)
+    {
+        append_csv_allocation(_row, job->execution_request->job_allocation->hosts);
+    }
+    _row += ',';
+    if (!rejected)
+    {
+        append_csv_value(_row, job->consumed_energy);
+    }
+    _row += ','; // metadata is not traced
+    _row += '\n';
 
-    // And then write them
-    for (string & mit : _job_keys)
+    _wbuf->append_text(_row.data(), _row.size());
+}
+
+void JobsTracer::write_job_columnar(const JobPtr & job, int success, bool rejected)
+{
+    const double missing = std::numeric_limits<double>::quiet_NaN();
+    const string & job_id = job->id.to_string();
+    const size_t job_name_offset = job->id.workload_name().size() + 1; // job name, after WORKLOAD_NAME!
+
+    _columnar->append_string(std::string_view(job_id).substr(job_name_offset));
+    _columnar->append_string(job->workload->name);
+    _columnar->append_string(job->profile->name);
+    _columnar->append_float64(static_cast<double>(job->submission_time));
+    _columnar->append_int64(job->requested_nb_res);
+    _columnar->append_float64(static_cast<double>(job->walltime));
+    _columnar->append_int64(success);
+    _columnar->append_string(job_state_to_cstring(job->state));
+    _columnar->append_float64(rejected ? missing : static_cast<double>(job->starting_time));
+    _columnar->append_float64(rejected ? missing : static_cast<double>(job->runtime));
+    _columnar->append_float64(rejected ? missing : static_cast<double>(job->starting_time + job->runtime));
+    _columnar->append_float64(rejected ? missing : static_cast<double>(job->starting_time - job->submission_time));
+    _columnar->append_float64(rejected ? missing : static_cast<double>(job->starting_time + job->runtime - job->submission_time));
+    _columnar->append_float64(rejected ? missing : static_cast<double>((job->starting_time + job->runtime - job->submission_time) / job->runtime));
+
+    _row.clear();
+    if (job->execution_request.get() != nullptr)
     {
-        _row_content.push_back(_job_map[mit]);
+        append_csv_allocation(_row, job->execution_request->job_allocation->hosts);
     }
-    _wbuf->append_text((boost::algorithm::join(_row_content, ",") + "\n").c_str());
-    _row_content.clear();
+    _columnar->append_string(_row);
+
+    _columnar->append_float64(rejected ? missing : static_cast<double>(job->consumed_energy));
+    _columnar->append_string(""); // metadata is not traced
+    _columnar->end_row();
 }
 
 void JobsTracer::flush()
 {
-    xbt_assert(_wbuf != nullptr, "wrong call: _wbuf is null");
-    _wbuf->flush_buffer();
+    if (_columnar != nullptr)
+    {
+        _columnar->flush_row_group();
+    }
+    else if (_wbuf != nullptr)
+    {
+        _wbuf->flush_buffer();
+    }
 }
 
 void JobsTracer::close_buffer()
 {
-    xbt_assert(_wbuf != nullptr, "wrong call: _wbuf is null");
     delete _wbuf;
     _wbuf = nullptr;
+    delete _columnar;
+    _columnar = nullptr;
 }
@@ -12,14 +12,21 @@
 #include <string>
 #include <fstream>
 #include <map>
+#include <unordered_map>
 #include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
 
+#include "compression.hpp"
 #include "pointers.hpp"
 #include "machines.hpp"
 #include "jobs.hpp"
+#include "quantiles.hpp"
 
 struct BatsimContext;
 struct Job;
+class ColumnarWriter;
 
 /**
  * @brief Prepares Batsim's outputting
@@ -41,11 +48,20 @@ class WriteBuffer
 public:
     /**
      * @brief Builds a WriteBuffer
+     * @details In asynchronous mode, full buffers are written into the file by a dedicated I/O thread
+     *          while the simulation goes on filling another buffer (ring of nb_async_buffers buffers).
+     *          The simulation blocks when all buffers are waiting to be written.
+     *          The I/O thread is joined when the WriteBuffer is destroyed.
+     *
+     *          The file is compressed on the fly if its name ends with the extension of a CompressionCodec (e.g., .zst or .gz).
+     *          Compression is done by the I/O thread in asynchronous mode.
      * @param[in] filename The file that will be written
      * @param[in] buffer_size The size of the buffer (in bytes).
+     * @param[in] asynchronous Whether the file is written asynchronously by a dedicated I/O thread
      */
     explicit WriteBuffer(const std::string & filename,
-                         size_t buffer_size = 64*1024);
+                         size_t buffer_size = 64*1024,
+                         bool asynchronous = false);
 
     /**
      * @brief WriteBuffers cannot be copied.
@@ -55,7 +71,8 @@ public:
 
     /**
      * @brief Destructor
-     * @details This method flushes the buffer if it is not empty, destroys the buffer and closes the file.
+     * @details This method flushes the buffer if it is not empty, waits for all the data to be written (in asynchronous mode),
+     *          destroys the buffer and closes the file.
      */
     ~WriteBuffer();
 
@@ -65,16 +82,52 @@ public:
      */
     void append_text(const char * text);
 
+    /**
+     * @brief Appends a text of known length at the end of the buffer. If the buffer is full, it is automatically flushed into the disk.
+     * @param[in] text The text to append. It does not need to be null-terminated.
+     * @param[in] text_length The length of the text
+     */
+    void append_text(const char * text, size_t text_length);
+
     /**
      * @brief Write the current content of the buffer into the file
+     * @details In asynchronous mode, the content is handed over to the I/O thread and may be written later.
      */
     void flush_buffer();
 
 private:
+    /**
+     * @brief The main function of the I/O thread in asynchronous mode: writes the pending buffers into the file in order
+     */
+    void write_pending_buffers();
+
+    /**
+     * @brief Writes data into the file, compressing it if needed
+     * @param[in] data The data to write
+     * @param[in] size The size of the data
+     */
+    void write_to_file(const char * data, size_t size);
+
+private:
+    static const size_t nb_async_buffers = 4; //!< The number of buffers in asynchronous mode
+
+    std::string filename;       //!< The name of the file
     std::ofstream f;            //!< The file stream on which the buffer is outputted
+    std::unique_ptr<StreamCompressor> compressor; //!< Compresses the data written into the file, or nullptr if the file is not compressed
     const size_t buffer_size;   //!< The buffer maximum size
     char * buffer = nullptr;    //!< The buffer
     size_t buffer_pos = 0;         //!< The current position of the buffer (previous positions are already written)
+
+    const bool asynchronous;                //!< Whether the file is written by a dedicated I/O thread
+    std::vector<char *> async_buffers;      //!< The ring of buffers in asynchronous mode. buffer is one of them.
+    std::vector<size_t> async_sizes;        //!< The size of the content of each buffer of the ring, set when it is handed over to the I/O thread
+    size_t fill_index = 0;                  //!< The index in the ring of the buffer being filled
+    size_t write_index = 0;                 //!< The index in the ring of the next buffer to write (only accessed by the I/O thread)
+    size_t nb_pending = 0;                  //!< The number of buffers handed over to the I/O thread and not written yet
+    bool closing = false;                   //!< Whether the I/O thread should stop once all pending buffers are written
+    std::mutex async_mutex;                 //!< Protects nb_pending and closing
+    std::condition_variable async_cond;     //!< Notified whenever nb_pending or closing changes
+    std::thread io_thread;                  //!< The I/O thread
 };
 
 
@@ -127,8 +180,9 @@ public:
     /**
      * @brief Sets the filename of a PajeTracer
      * @param[in] filename The name of the output file
+     * @param[in] asynchronous Whether the output file is written by a dedicated I/O thread
      */
-    void set_filename(const std::string & filename);
+    void set_filename(const std::string & filename, bool asynchronous = false);
 
     /**
      * @brief PajeTracer destructor.
@@ -243,7 +297,7 @@ private:
 
     WriteBuffer * _wbuf = nullptr;  //!< The buffer class used to handle the output file
 
-    std::map<JobIdentifier, std::string> _jobs; //!< Maps jobs to their Pajé representation
+    std::unordered_map<JobIdentifier, std::string, JobIdentifierHasher> _jobs; //!< Maps jobs to their Pajé representation
     std::vector<std::string> _colors; //!< Strings associated with colors, used for the jobs
 
     PajeTracerState state = UNINITIALIZED; //!< The state of the PajeTracer
@@ -277,8 +331,9 @@ public:
     /**
      * @brief Sets the output filename of the tracer
      * @param filename The name of the output file of the tracer
+     * @param asynchronous Whether the output file is written by a dedicated I/O thread
      */
-    void setFilename(const std::string & filename);
+    void setFilename(const std::string & filename, bool asynchronous = false);
 
     /**
      * @brief Adds a power state change in the tracer
@@ -335,8 +390,15 @@ public:
     /**
      * @brief Sets the output filename of the tracer
      * @param[in] filename The name of the output file of the tracer
+     * @param[in] asynchronous Whether the output file is written by a dedicated I/O thread
      */
-    void set_filename(const std::string & filename);
+    void set_filename(const std::string & filename, bool asynchronous = false);
+
+    /**
+     * @brief Sets the columnar output filename of the tracer, which is then used instead of a CSV file
+     * @param[in] filename The name of the columnar output file of the tracer
+     */
+    void set_columnar_filename(const std::string & filename);
 
     /**
      * @brief Adds a job start in the tracer
@@ -385,10 +447,13 @@ private:
 private:
     BatsimContext * _context = nullptr; //!< The Batsim context
     WriteBuffer * _wbuf = nullptr; //!< The buffer used to handle the output file
+    ColumnarWriter * _columnar = nullptr; //!< The writer of the columnar output file (used instead of _wbuf if set)
 };
 
 /**
  * @brief Traces the repartition of the machine states over time
+ * @details At most one row is written per simulated date: the row of a date is only written when a later date is traced
+ *          (or when the tracer is flushed), with the number of machines in each state at the last call for this date.
  */
 class MachineStateTracer
 {
@@ -418,11 +483,19 @@ public:
     /**
      * @brief Sets the output filename of the tracer
      * @param[in] filename  The name of the output file of the tracer
+     * @param[in] asynchronous Whether the output file is written by a dedicated I/O thread
+     */
+    void set_filename(const std::string & filename, bool asynchronous = false);
+
+    /**
+     * @brief Sets the columnar output filename of the tracer, which is then used instead of a CSV file
+     * @param[in] filename The name of the columnar output file of the tracer
      */
-    void set_filename(const std::string & filename);
+    void set_columnar_filename(const std::string & filename);
 
     /**
-     * @brief Writes a line in the output file, corresponding to the current state, at the given date
+     * @brief Traces the current state at the given date
+     * @details The row is only written once a later date is traced, so that successive calls at the same date produce one row.
      * @param[in] date The current date
      */
     void write_machine_states(double date);
@@ -438,8 +511,31 @@ public:
     void close_buffer();
 
 private:
+    /**
+     * @brief Writes the pending row into the output file, if any
+     */
+    void write_pending_row();
+
+private:
+    static const int NB_TRACED_STATES = 5; //!< The number of machine states traced in each row
+
     BatsimContext * _context = nullptr; //!< The Batsim context
     WriteBuffer * _wbuf = nullptr; //!< The buffer used to handle the output file
+    ColumnarWriter * _columnar = nullptr; //!< The writer of the columnar output file (used instead of _wbuf if set)
+
+    bool _has_pending_row = false; //!< Whether a row has been traced but not written yet
+    double _pending_date = 0; //!< The date of the pending row
+    int _pending_numbers[NB_TRACED_STATES] = {0}; //!< The number of machines in each traced state of the pending row
+};
+
+/**
+ * @brief The streaming distributions of the metrics of finished jobs
+ */
+struct JobMetricsDistributions
+{
+    TDigest waiting_time; //!< The distribution of the waiting time of jobs
+    TDigest turnaround_time; //!< The distribution of the turnaround time of jobs
+    TDigest slowdown; //!< The distribution of the slowdown of jobs
 };
 
 /**
@@ -467,12 +563,16 @@ public:
     /**
      * @brief Initializes the tracer
      * @param[in] context The Batsim context
-     * @param[in] jobs_filename The name of the jobs output file
+     * @param[in] jobs_filename The name of the jobs output file. No jobs output file is written if empty (only the schedule metrics are computed).
      * @param[in] schedule_filename The name of the schedule output file
+     * @param[in] asynchronous Whether the jobs output file is written by a dedicated I/O thread
+     * @param[in] columnar Whether the jobs output file is a columnar file instead of a CSV file
      */
     void initialize(BatsimContext * context,
                     const std::string & jobs_filename,
-                    const std::string & schedule_filename);
+                    const std::string & schedule_filename,
+                    bool asynchronous = false,
+                    bool columnar = false);
 
     /**
      * @brief Finalizes the tracer. Writes schedule output file
@@ -496,15 +596,33 @@ public:
     void close_buffer();
 
 
+private:
+    /**
+     * @brief Writes a job into the columnar jobs output file
+     * @param[in] job The job
+     * @param[in] success Whether the job completed successfully
+     * @param[in] rejected Whether the job has been rejected
+     */
+    void write_job_columnar(const JobPtr & job, int success, bool rejected);
+
+    /**
+     * @brief Writes the quantiles of some distributions of job metrics into the schedule output map
+     * @param[in,out] output_map The schedule output map
+     * @param[in,out] distributions The distributions
+     * @param[in] key_prefix The prefix of the keys written into output_map
+     */
+    static void write_quantiles(std::map<std::string, std::string> & output_map,
+                                JobMetricsDistributions & distributions,
+                                const std::string & key_prefix);
+
 private:
     BatsimContext * _context = nullptr; //!< The Batsim context
     WriteBuffer * _wbuf = nullptr; //!< The buffer used to handle the jobs output file
+    ColumnarWriter * _columnar = nullptr; //!< The writer of the columnar jobs output file (used instead of _wbuf if set)
     std::string _schedule_filename; //!< The filename of the schedule output file
 
     // Jobs-related
-    std::vector<std::string> _job_keys; //!< The list of keys in the map
-    std::map<std::string, std::string> _job_map; //!< The map holding info of the Job to write
-    std::vector<std::string> _row_content; //!< The vector containing string to write
+    std::string _row; //!< The row of the job being written. Reused across jobs so that its memory is allocated once.
 
     // Schedule-related
     int _nb_jobs = 0; //!< The number of jobs.
@@ -520,4 +638,5 @@ private:
     long double _max_turnaround_time = 0; //!< The maximum turnaround time observed.
     long double _max_slowdown = 0; //!< The maximum slowdown observed.
     std::map<int, long double> _machines_utilization; //!< Counts the utilization time of each machine.
+    std::map<std::string, JobMetricsDistributions> _distributions_by_workload; //!< The distributions of the metrics of finished jobs, by workload name.
 };
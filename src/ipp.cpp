@@ -31,7 +31,7 @@ void generic_send_message(
 
     XBT_DEBUG("message from '%s' to '%s' of type '%s' with data %p",
               simgrid::s4u::this_actor::get_cname(), destination_mailbox.c_str(),
-              ip_message_type_to_string(type).c_str(), data);
+              ip_message_type_to_cstring(type), data);
 
     if (detached)
     {
@@ -45,7 +45,7 @@ void generic_send_message(
 
     XBT_DEBUG("message from '%s' to '%s' of type '%s' with data %p done",
               simgrid::s4u::this_actor::get_cname(), destination_mailbox.c_str(),
-              ip_message_type_to_string(type).c_str(), data);
+              ip_message_type_to_cstring(type), data);
 }
 
 /**
@@ -178,111 +178,89 @@ bool mailbox_empty(const std::string & reception_mailbox)
 }
 
 /**
- * @brief Transforms a IPMessageType into a std::string
+ * @brief Transforms a IPMessageType into a (static) null-terminated C string
  * @param[in] type The IPMessageType
- * @return The std::string corresponding to the type
+ * @return The C string corresponding to the type
  */
-std::string ip_message_type_to_string(IPMessageType type)
+const char * ip_message_type_to_cstring(IPMessageType type)
 {
-    string s;
-
     // Do not remove the switch. If one adds a new IPMessageType but forgets to handle it in the
     // switch, a compilation warning should help avoiding this bug.
     switch(type)
     {
         case IPMessageType::JOB_SUBMITTED:
-            s = "JOB_SUBMITTED";
-            break;
+            return "JOB_SUBMITTED";
         case IPMessageType::JOB_REGISTERED_BY_DP:
-            s = "JOB_REGISTERED_BY_DP";
-            break;
+            return "JOB_REGISTERED_BY_DP";
         case IPMessageType::PROFILE_REGISTERED_BY_DP:
-            s = "PROFILE_REGISTERED_BY_DP";
-            break;
+            return "PROFILE_REGISTERED_BY_DP";
         case IPMessageType::JOB_COMPLETED:
-            s = "JOB_COMPLETED";
-            break;
+            return "JOB_COMPLETED";
         case IPMessageType::PSTATE_MODIFICATION:
-            s = "PSTATE_MODIFICATION";
-            break;
+            return "PSTATE_MODIFICATION";
         case IPMessageType::SCHED_EXECUTE_JOB:
-            s = "SCHED_EXECUTE_JOB";
-            break;
+            return "SCHED_EXECUTE_JOB";
         case IPMessageType::SCHED_CHANGE_JOB_STATE:
-            s = "SCHED_CHANGE_JOB_STATE";
-            break;
+            return "SCHED_CHANGE_JOB_STATE";
         case IPMessageType::SCHED_HELLO:
-            s = "SCHED_HELLO";
-            break;
+            return "SCHED_HELLO";
         case IPMessageType::SCHED_REJECT_JOB:
-            s = "SCHED_REJECT_JOB";
-            break;
+            return "SCHED_REJECT_JOB";
         case IPMessageType::SCHED_KILL_JOBS:
-            s = "SCHED_KILL_JOB";
-            break;
+            return "SCHED_KILL_JOB";
         case IPMessageType::SCHED_CALL_ME_LATER:
-            s = "SCHED_CALL_ME_LATER";
-            break;
+            return "SCHED_CALL_ME_LATER";
         case IPMessageType::SCHED_STOP_CALL_ME_LATER:
-            s = "SCHED_STOP_CALL_ME_LATER";
-            break;
+            return "SCHED_STOP_CALL_ME_LATER";
         case IPMessageType::SCHED_CREATE_PROBE:
-            s = "SCHED_CREATE_PROBE";
-            break;
+            return "SCHED_CREATE_PROBE";
         case IPMessageType::SCHED_STOP_PROBE:
-            s = "SCHED_STOP_PROBE";
-            break;
+            return "SCHED_STOP_PROBE";
         case IPMessageType::SCHED_TELL_ME_ENERGY:
-            s = "SCHED_TELL_ME_ENERGY";
-            break;
+            return "SCHED_TELL_ME_ENERGY";
         case IPMessageType::SCHED_WAIT_ANSWER:
-            s = "SCHED_WAIT_ANSWER";
-            break;
+            return "SCHED_WAIT_ANSWER";
         case IPMessageType::WAIT_QUERY:
-            s = "WAIT_QUERY";
-            break;
+            return "WAIT_QUERY";
         case IPMessageType::SCHED_READY:
-            s = "SCHED_READY";
-            break;
+            return "SCHED_READY";
         case IPMessageType::ONESHOT_REQUESTED_CALL:
-            s = "ONESHOT_REQUESTED_CALL";
-            break;
+            return "ONESHOT_REQUESTED_CALL";
         case IPMessageType::PERIODIC_TRIGGER:
-            s = "PERIODIC_TRIGGER";
-            break;
+            return "PERIODIC_TRIGGER";
         case IPMessageType::PERIODIC_ENTITY_STOPPED:
-            s = "PERIODIC_ENTITY_STOPPED";
-            break;
+            return "PERIODIC_ENTITY_STOPPED";
         case IPMessageType::SUBMITTER_HELLO:
-            s = "SUBMITTER_HELLO";
-            break;
+            return "SUBMITTER_HELLO";
         case IPMessageType::SUBMITTER_CALLBACK:
-            s = "SUBMITTER_CALLBACK";
-            break;
+            return "SUBMITTER_CALLBACK";
         case IPMessageType::SUBMITTER_BYE:
-            s = "SUBMITTER_BYE";
-            break;
+            return "SUBMITTER_BYE";
         case IPMessageType::SWITCHED_ON:
-            s = "SWITCHED_ON";
-            break;
+            return "SWITCHED_ON";
         case IPMessageType::SWITCHED_OFF:
-            s = "SWITCHED_OFF";
-            break;
+            return "SWITCHED_OFF";
         case IPMessageType::KILLING_DONE:
-            s = "KILLING_DONE";
-            break;
+            return "KILLING_DONE";
         case IPMessageType::END_DYNAMIC_REGISTER:
-            s = "END_DYNAMIC_REGISTER";
-            break;
+            return "END_DYNAMIC_REGISTER";
         case IPMessageType::EVENT_OCCURRED:
-            s = "EVENT_OCCURRED";
-            break;
+            return "EVENT_OCCURRED";
         case IPMessageType::DIE:
-            s = "DIE";
-            break;
+            return "DIE";
     }
 
-    return s;
+    return "UNKNOWN";
+}
+
+/**
+ * @brief Transforms a IPMessageType into a std::string
+ * @param[in] type The IPMessageType
+ * @return The std::string corresponding to the type
+ */
+std::string ip_message_type_to_string(IPMessageType type)
+{
+    return ip_message_type_to_cstring(type);
 }
 
 IPMessage::~IPMessage()
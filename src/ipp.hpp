@@ -7,6 +7,7 @@
 
 #include <vector>
 #include <map>
+#include <memory>
 #include <string>
 
 #include <rapidjson/document.h>
@@ -16,11 +17,14 @@
 #include <batprotocol.hpp>
 #include <intervalset.hpp>
 
+#include "object_pool.hpp"
 #include "pointers.hpp"
+#include "probe_aggregation.hpp"
 #include "jobs.hpp"
 #include "events.hpp"
 
 struct BatsimContext;
+struct Machine;
 struct ServerData;
 
 /**
@@ -60,6 +64,9 @@ enum class IPMessageType
     ,DIE                        //!< Server -> Periodic. The server asks the periodic trigger manager to stop.
 };
 
+//! The number of IPMessageType values. DIE must remain the last IPMessageType.
+constexpr size_t NB_IP_MESSAGE_TYPES = static_cast<size_t>(IPMessageType::DIE) + 1;
+
 /**
  * @brief Contains the different types of submitters
  */
@@ -103,7 +110,7 @@ struct SubmitterByeMessage
 /**
  * @brief The content of the SUBMITTER_CALLBACK message
  */
-struct SubmitterJobCompletionCallbackMessage
+struct SubmitterJobCompletionCallbackMessage : public PoolAllocated<SubmitterJobCompletionCallbackMessage>
 {
     JobIdentifier job_id; //!< The JobIdentifier
 };
@@ -111,7 +118,7 @@ struct SubmitterJobCompletionCallbackMessage
 /**
  * @brief The content of the JobSubmitted message
  */
-struct JobSubmittedMessage
+struct JobSubmittedMessage : public PoolAllocated<JobSubmittedMessage>
 {
     std::string submitter_name; //!< The name of the submitter which submitted the jobs.
     std::vector<JobPtr> jobs; //!< The list of submitted Jobs
@@ -120,7 +127,7 @@ struct JobSubmittedMessage
 /**
  * @brief The content of the JobRegisteredByDP message
  */
-struct JobRegisteredByDPMessage
+struct JobRegisteredByDPMessage : public PoolAllocated<JobRegisteredByDPMessage>
 {
     JobPtr job; //!< The freshly registered job
     std::string job_description; //!< The job description string
@@ -148,7 +155,7 @@ struct SetJobMetadataMessage
 /**
  * @brief The content of the JobCompleted message
  */
-struct JobCompletedMessage
+struct JobCompletedMessage : public PoolAllocated<JobCompletedMessage>
 {
     JobPtr job; //!< The Job that has completed
 };
@@ -156,7 +163,7 @@ struct JobCompletedMessage
 /**
  * @brief The content of the ChangeJobState message
  */
-struct ChangeJobStateMessage
+struct ChangeJobStateMessage : public PoolAllocated<ChangeJobStateMessage>
 {
     JobIdentifier job_id; //!< The JobIdentifier
     std::string job_state; //!< The new job state
@@ -165,7 +172,7 @@ struct ChangeJobStateMessage
 /**
  * @brief The content of the JobRejected message
  */
-struct RejectJobMessage
+struct RejectJobMessage : public PoolAllocated<RejectJobMessage>
 {
     JobPtr job; //!< The Job to reject
 };
@@ -184,7 +191,7 @@ struct AllocationPlacement
 /**
  * @brief The content of the EXECUTE_JOB message
  */
-struct ExecuteJobMessage
+struct ExecuteJobMessage : public PoolAllocated<ExecuteJobMessage>
 {
     JobPtr job; //!< The Job to execute
     std::shared_ptr<AllocationPlacement> job_allocation; //!< The main allocation/placement for the job.
@@ -266,7 +273,7 @@ struct RequestedCall
     bool is_last_periodic_call = false; //!< Whether this message comes from the last call of a non-infinite periodic call
 };
 
-struct OneShotRequestedCallMessage
+struct OneShotRequestedCallMessage : public PoolAllocated<OneShotRequestedCallMessage>
 {
     RequestedCall call;
 };
@@ -276,11 +283,37 @@ struct StopCallMeLaterMessage
     std::string call_id; //!< The identifier of the CALL_ME_LATER to stop
 };
 
+/**
+ * @brief The quantities that probes can measure
+ * @details Accumulative probes measure counters (consumed energy, time spent computing),
+ *          while non-accumulative probes measure current values (power, load, used bandwidth).
+ */
+enum class ProbeMetric
+{
+    POWER           //!< The consumed energy (accumulative) or current power (non-accumulative) of hosts or links
+   ,HOST_LOAD       //!< The time spent computing (accumulative) or current computing load in [0,1] (non-accumulative) of hosts
+   ,LINK_TRAFFIC    //!< The current used bandwidth (non-accumulative) of links
+};
+
+/**
+ * @brief The immutable description of a probe, built once when the probe is created and shared by all the data it emits
+ */
+struct ProbeDescription
+{
+    std::string probe_id; //!< The identifier of the probe
+    batprotocol::fb::Resources resource_type; //!< The type of resources that are probed
+    IntervalSet hosts; //!< The hosts to probe (only defined if resources are hosts)
+    std::string hosts_str; //!< The hosts to probe as a hyphenated string, as sent to the EDC (only defined if resources are hosts)
+    std::shared_ptr<std::vector<std::string> > links; //!< The links to probe (only defined if resources are links)
+    batprotocol::fb::Metrics metrics; //!< The metrics that is probed
+};
+
 struct CreateProbeMessage
 {
     std::string probe_id; //!< The identifier of the probe
 
     batprotocol::fb::Metrics metrics; //!< The metrics that should be probed
+    ProbeMetric metric = ProbeMetric::POWER; //!< The quantity that is measured for the metrics
 
     batprotocol::fb::Resources resource_type; //!< The type of resources that should be probed
     IntervalSet hosts; //!< The hosts to probe (only defined if resources are hosts)
@@ -302,10 +335,23 @@ struct CreateProbeMessage
     batprotocol::fb::ResourcesAggregationFunction resource_agregation_type; //!< How data should be aggregated when several resources are probed
     double quantile_threshold; //!< The threshold to use for the quantile function, if any
     batprotocol::fb::TemporalAggregationFunction temporal_aggregation_type; //!< How sequential probed values should be aggregated (raw values? exponential moving average? some sliding window operation?)
+    TemporalAggregation temporal_aggregation; //!< The temporal aggregation function to apply on the values of each resource
 
     batprotocol::fb::ProbeEmissionFilteringPolicy emission_filtering_policy; //!< Filters which triggered measures should be forwarded to an EDC
     double emission_filtering_threshold_value; //!< If a threshold emission filtering policy is set, this is the threshold value
     batprotocol::fb::BooleanComparisonOperator emission_filtering_threshold_comparator; //!< If a threshold emission filtering policy is set, this is the comparator to apply on the measured value and the threshold value
+
+    // Built when the probe is created by the periodic actor
+    std::shared_ptr<const ProbeDescription> description; //!< The immutable description of the probe, shared with the data it emits
+    std::vector<simgrid::s4u::Host *> probed_hosts; //!< The SimGrid hosts to probe, in the order of hosts (only defined if resources are hosts)
+    std::vector<const Machine *> probed_machines; //!< The machines to probe, in the order of hosts (only defined if resources are hosts)
+    std::vector<simgrid::s4u::Link *> probed_links; //!< The SimGrid links to probe, in the order of links (only defined if resources are links)
+    std::vector<double> values_buffer; //!< Stores the values measured on each resource before they are aggregated (reused across measurements)
+    std::vector<double> accumulation_baselines; //!< For accumulative probes with reset, the counter value of each resource at the last reset
+    double accumulation_start_time = 0; //!< For accumulative probes, the time (in seconds) since which data is accumulated
+    TemporalAggregator temporal_aggregator; //!< Aggregates the successive values measured on each resource
+    unsigned int nb_triggered = 0; //!< The number of times the probe has been automatically triggered so far
+    unsigned int nb_emitted = 0; //!< The number of times the probe has emitted data so far
 };
 
 struct StopProbeMessage
@@ -313,26 +359,21 @@ struct StopProbeMessage
     std::string probe_id; //!< The identifier of the probe
 };
 
-struct ProbeData {
-    std::string probe_id; //!< The identifier of the probe
-
-    batprotocol::fb::Resources resource_type; //!< The type of resources that should be probed
-    IntervalSet hosts; //!< The hosts to probe (only defined if resources are hosts)
-    std::vector<std::string> links; //!< The links to probe (only defined if resources are links)
-
-    batprotocol::fb::Metrics metrics; //!< The metrics that should be probed
+struct ProbeData : public PoolAllocated<ProbeData>
+{
+    std::shared_ptr<const ProbeDescription> description; //!< The description of the probe that emitted the data
 
     batprotocol::fb::ProbeData data_type; //!< Whether the emitted data is raw vectorial data or an aggregation
     double aggregated_data; //!< Stores the actual data when it is an aggregation over several resources
     std::vector<double> vectorial_data; //!< Stores the actual data when it is vectorial (one value per probed resource)
 
-    bool manually_triggered; //!< Whether the probe was triggered manually (TriggerProbe event) or automatically (periodic)
+    bool manually_triggered; //!< Whether the probe was triggered manually (one-shot probe or TriggerProbe event) or automatically (periodic)
     unsigned int nb_triggered; //!< The number of times the probe has been automatically triggered by its period
     unsigned int nb_emitted; //!< The number of times the probe has been emitted
-    bool is_last_periodic = false; //!< Whether this message comes from the last data emission of a non-infinite periodic probe
+    bool is_last_periodic = false; //!< Whether this message comes from the last data emission of a non-infinite periodic probe or of a one-shot probe
 };
 
-struct PeriodicTriggerMessage
+struct PeriodicTriggerMessage : public PoolAllocated<PeriodicTriggerMessage>
 {
     std::vector<RequestedCall> calls;
     std::vector<ProbeData*> probes_data;
@@ -369,7 +410,7 @@ struct SchedWaitAnswerMessage
 /**
  * @brief The content of the SwitchON/SwitchOFF message
  */
-struct SwitchMessage
+struct SwitchMessage : public PoolAllocated<SwitchMessage>
 {
     int machine_id = -1; //!< The unique number of the machine which should be switched ON
     int new_pstate = -1; //!< The power state the machine should be put into
@@ -378,7 +419,7 @@ struct SwitchMessage
 /**
  * @brief The content of the KillingDone message
  */
-struct KillingDoneMessage
+struct KillingDoneMessage : public PoolAllocated<KillingDoneMessage>
 {
     KillJobsMessage * kill_jobs_message = nullptr; //!< The KillJobsMessage that initiated the kills
     std::map<std::string, std::shared_ptr<batprotocol::KillProgress>> jobs_progress; //!< Stores the progress of the jobs that have really been killed
@@ -408,7 +449,7 @@ struct FromJobMessage
 /**
  * @brief The content of the EventOccurred message
  */
-struct EventOccurredMessage
+struct EventOccurredMessage : public PoolAllocated<EventOccurredMessage>
 {
     std::string submitter_name;          //!< The name of the submitter which submitted the events.
     std::vector<const Event *> occurred_events; //!< The list of Event that occurred
@@ -417,7 +458,7 @@ struct EventOccurredMessage
 /**
  * @brief The base struct sent in inter-process messages
  */
-struct IPMessage
+struct IPMessage : public PoolAllocated<IPMessage>
 {
     /**
      * @brief Destroys a IPMessage
@@ -469,5 +510,6 @@ IPMessage * receive_message(const std::string & reception_mailbox);
 
 bool mailbox_empty(const std::string & reception_mailbox);
 
+const char * ip_message_type_to_cstring(IPMessageType type);
 std::string ip_message_type_to_string(IPMessageType type);
 std::string submitter_type_to_string(SubmitterType type);
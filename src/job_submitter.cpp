@@ -8,7 +8,9 @@
 #include <vector>
 #include <algorithm>
 #include <boost/bind.hpp>
+#include <limits>
 #include <memory>
+#include <set>
 
 #include <simgrid/s4u.hpp>
 
@@ -16,6 +18,8 @@
 #include "jobs_execution.hpp"
 #include "ipp.hpp"
 #include "context.hpp"
+#include "workload_cache.hpp"
+#include "workload_reader.hpp"
 
 XBT_LOG_NEW_DEFAULT_CATEGORY(job_submitter, "job_submitter"); //!< Logging
 
@@ -46,44 +50,26 @@ static void submit_jobs_to_server(const vector<JobPtr> & jobs_to_submit, const s
     }
 }
 
-void static_job_submitter_process(BatsimContext * context,
-                                  std::string workload_name)
+/**
+ * @brief Tracks the platform energy at the first job submission
+ * @param[in,out] context The BatsimContext
+ */
+static void on_first_job_submission(BatsimContext * context)
 {
-    xbt_assert(context->workloads.exists(workload_name),
-               "Error: a static_job_submitter_process is in charge of workload '%s', "
-               "which does not exist", workload_name.c_str());
-
-    Workload * workload = context->workloads.at(workload_name);
-
-    string submitter_name = workload_name + "_submitter";
-
-    /*  ░░░░░░░░▄▄▄███░░░░░░░░░░░░░░░░░░░░
-        ░░░▄▄██████████░░░░░░░░░░░░░░░░░░░
-        ░███████████████░░░░░░░░░░░░░░░░░░
-        ░▀███████████████░░░░░▄▄▄░░░░░░░░░
-        ░░░███████████████▄███▀▀▀░░░░░░░░░
-        ░░░░███████████████▄▄░░░░░░░░░░░░░
-        ░░░░▄████████▀▀▄▄▄▄▄░▀░░░░░░░░░░░░
-        ▄███████▀█▄▀█▄░░█░▀▀▀░█░░▄▄░░░░░░░
-        ▀▀░░░██▄█▄░░▀█░░▄███████▄█▀░░░▄░░░
-        ░░░░░█░█▀▄▄▀▄▀░█▀▀▀█▀▄▄▀░░░░░░▄░▄█
-        ░░░░░█░█░░▀▀▄▄█▀░█▀▀░░█░░░░░░░▀██░
-        ░░░░░▀█▄░░░░░░░░░░░░░▄▀░░░░░░▄██░░
-        ░░░░░░▀█▄▄░░░░░░░░▄▄█░░░░░░▄▀░░█░░
-        ░░░░░░░░░▀███▀▀████▄██▄▄░░▄▀░░░░░░
-        ░░░░░░░░░░░█▄▀██▀██▀▄█▄░▀▀░░░░░░░░
-        ░░░░░░░░░░░██░▀█▄█░█▀░▀▄░░░░░░░░░░
-        ░░░░░░░░░░█░█▄░░▀█▄▄▄░░█░░░░░░░░░░
-        ░░░░░░░░░░█▀██▀▀▀▀░█▄░░░░░░░░░░░░░
-        ░░░░░░░░░░░░▀░░░░░░░░░░░▀░░░░░░░░░ */
-
-    SubmitterHelloMessage * hello_msg = new SubmitterHelloMessage;
-    hello_msg->submitter_name = submitter_name;
-    hello_msg->enable_callback_on_job_completion = false;
-    hello_msg->submitter_type = SubmitterType::JOB_SUBMITTER;
-
-    send_message("server", IPMessageType::SUBMITTER_HELLO, static_cast<void*>(hello_msg));
+    if (context->energy_first_job_submission < 0)
+    {
+        context->energy_first_job_submission = context->machines.total_consumed_energy(context);
+    }
+}
 
+/**
+ * @brief Submits the jobs of a workload whose jobs have all been loaded before the simulation
+ * @param[in,out] context The BatsimContext
+ * @param[in] workload The workload whose jobs are submitted
+ * @param[in] submitter_name The name of the submitter
+ */
+static void submit_loaded_jobs(BatsimContext * context, Workload * workload, const std::string & submitter_name)
+{
     long double current_submission_date = static_cast<long double>(simgrid::s4u::Engine::get_clock());
 
     // sort jobs by arrival date in a temporary vector
@@ -128,16 +114,156 @@ void static_job_submitter_process(BatsimContext * context,
             if (is_first_job)
             {
                 is_first_job = false;
-                if (context->energy_first_job_submission < 0)
-                {
-                    context->energy_first_job_submission = context->machines.total_consumed_energy(context);
-                }
+                on_first_job_submission(context);
             }
         }
 
         // Send last vector of submitted jobs
         submit_jobs_to_server(jobs_to_send, submitter_name);
     }
+}
+
+/**
+ * @brief Submits the jobs of a workload while reading them from the workload file
+ * @details Jobs are read (and built) job_materialization_window seconds of simulated time before their submission,
+ *          so that only the jobs of the upcoming window are in memory. Reading the file is suspended while
+ *          the next job in the file is beyond the window. Jobs must thus be sorted by submission time in the file,
+ *          up to the window duration.
+ * @param[in,out] context The BatsimContext
+ * @param[in] workload The workload whose jobs are submitted
+ * @param[in] submitter_name The name of the submitter
+ */
+static void submit_jobs_while_reading_them(BatsimContext * context, Workload * workload, const std::string & submitter_name)
+{
+    const string error_prefix = "Invalid JSON file '" + workload->file + "'";
+    long double current_submission_date = static_cast<long double>(simgrid::s4u::Engine::get_clock());
+
+    // Jobs that have been read but not submitted yet, sorted by submission time
+    multiset<JobPtr, bool(*)(const JobPtr, const JobPtr)> pending_jobs(job_comparator_subtime_number);
+    vector<JobPtr> jobs_to_send;
+    bool is_first_job = true;
+
+    // Submits the pending jobs whose submission time is not after the given date, sleeping between submission times
+    auto submit_pending_jobs_until = [&](long double date)
+    {
+        while (!pending_jobs.empty() && (*pending_jobs.begin())->submission_time <= date)
+        {
+            auto job = *pending_jobs.begin();
+            if (job->submission_time > current_submission_date)
+            {
+                submit_jobs_to_server(jobs_to_send, submitter_name);
+                jobs_to_send.clear();
+
+                simgrid::s4u::this_actor::sleep_for(static_cast<double>(job->submission_time - current_submission_date));
+                current_submission_date = static_cast<long double>(simgrid::s4u::Engine::get_clock());
+            }
+
+            jobs_to_send.push_back(job);
+            pending_jobs.erase(pending_jobs.begin());
+
+            if (is_first_job)
+            {
+                is_first_job = false;
+                on_first_job_submission(context);
+            }
+        }
+
+        submit_jobs_to_server(jobs_to_send, submitter_name);
+        jobs_to_send.clear();
+    };
+
+    // Called on each job right after it has been read
+    auto on_job_read = [&](JobPtr job)
+    {
+        xbt_assert(job->submission_time >= current_submission_date,
+                   "%s: job '%s' is submitted at %Lg but has been read at %Lg. "
+                   "Jobs must be sorted by 'subtime' when they are read during the simulation "
+                   "(up to the materialization window, %Lg seconds here).",
+                   error_prefix.c_str(), job->id.to_cstring(), job->submission_time,
+                   current_submission_date, workload->job_materialization_window);
+
+        // Suspend the reading of the jobs until the job enters the materialization window
+        const long double window_start_date = job->submission_time - workload->job_materialization_window;
+        submit_pending_jobs_until(window_start_date);
+        if (window_start_date > current_submission_date)
+        {
+            simgrid::s4u::this_actor::sleep_for(static_cast<double>(window_start_date - current_submission_date));
+            current_submission_date = static_cast<long double>(simgrid::s4u::Engine::get_clock());
+        }
+
+        pending_jobs.insert(job);
+    };
+
+    if (workload->cache != nullptr)
+    {
+        // Cached jobs are already validated and sorted by submission time
+        for (size_t i = 0; i < workload->cache->nb_jobs(); ++i)
+        {
+            auto job = workload->cache->build_job(i, workload);
+            workload->jobs->add_job(job);
+            on_job_read(job);
+        }
+    }
+    else
+    {
+        WorkloadJsonReader reader(workload->file);
+        reader.read(nullptr, [&](const rapidjson::Value & job_desc)
+        {
+            auto job = workload->jobs->add_job_from_json(job_desc, error_prefix);
+            workload->check_single_job_validity(job);
+            on_job_read(job);
+        });
+    }
+
+    submit_pending_jobs_until(std::numeric_limits<long double>::infinity());
+}
+
+void static_job_submitter_process(BatsimContext * context,
+                                  std::string workload_name)
+{
+    xbt_assert(context->workloads.exists(workload_name),
+               "Error: a static_job_submitter_process is in charge of workload '%s', "
+               "which does not exist", workload_name.c_str());
+
+    Workload * workload = context->workloads.at(workload_name);
+
+    string submitter_name = workload_name + "_submitter";
+
+    /*  ░░░░░░░░▄▄▄███░░░░░░░░░░░░░░░░░░░░
+        ░░░▄▄██████████░░░░░░░░░░░░░░░░░░░
+        ░███████████████░░░░░░░░░░░░░░░░░░
+        ░▀███████████████░░░░░▄▄▄░░░░░░░░░
+        ░░░███████████████▄███▀▀▀░░░░░░░░░
+        ░░░░███████████████▄▄░░░░░░░░░░░░░
+        ░░░░▄████████▀▀▄▄▄▄▄░▀░░░░░░░░░░░░
+        ▄███████▀█▄▀█▄░░█░▀▀▀░█░░▄▄░░░░░░░
+        ▀▀░░░██▄█▄░░▀█░░▄███████▄█▀░░░▄░░░
+        ░░░░░█░█▀▄▄▀▄▀░█▀▀▀█▀▄▄▀░░░░░░▄░▄█
+        ░░░░░█░█░░▀▀▄▄█▀░█▀▀░░█░░░░░░░▀██░
+        ░░░░░▀█▄░░░░░░░░░░░░░▄▀░░░░░░▄██░░
+        ░░░░░░▀█▄▄░░░░░░░░▄▄█░░░░░░▄▀░░█░░
+        ░░░░░░░░░▀███▀▀████▄██▄▄░░▄▀░░░░░░
+        ░░░░░░░░░░░█▄▀██▀██▀▄█▄░▀▀░░░░░░░░
+        ░░░░░░░░░░░██░▀█▄█░█▀░▀▄░░░░░░░░░░
+        ░░░░░░░░░░█░█▄░░▀█▄▄▄░░█░░░░░░░░░░
+        ░░░░░░░░░░█▀██▀▀▀▀░█▄░░░░░░░░░░░░░
+        ░░░░░░░░░░░░▀░░░░░░░░░░░▀░░░░░░░░░ */
+
+    SubmitterHelloMessage * hello_msg = new SubmitterHelloMessage;
+    hello_msg->submitter_name = submitter_name;
+    hello_msg->enable_callback_on_job_completion = false;
+    hello_msg->submitter_type = SubmitterType::JOB_SUBMITTER;
+
+    send_message("server", IPMessageType::SUBMITTER_HELLO, static_cast<void*>(hello_msg));
+
+    if (workload->jobs_are_materialized_lazily())
+    {
+        submit_jobs_while_reading_them(context, workload, submitter_name);
+    }
+    else
+    {
+        submit_loaded_jobs(context, workload, submitter_name);
+    }
 
     SubmitterByeMessage * bye_msg = new SubmitterByeMessage;
     bye_msg->is_workflow_submitter = false;
@@ -7,6 +7,7 @@
 #include "workload.hpp"
 
 #include <string>
+#include <string_view>
 #include <fstream>
 #include <streambuf>
 #include <algorithm>
@@ -27,13 +28,78 @@ using namespace rapidjson;
 
 XBT_LOG_NEW_DEFAULT_CATEGORY(jobs, "jobs"); //!< Logging
 
+/**
+ * @brief The global table in which job identifiers are interned
+ * @details Strings are stored in deques so that their addresses remain stable,
+ *          which allows the lookup maps to use string_view keys that point to them.
+ */
+struct JobIdentifierTable
+{
+    /**
+     * @brief The interned identifiers of one workload
+     */
+    struct WorkloadEntry
+    {
+        std::string name; //!< The workload name
+        std::deque<std::string> representations; //!< The string representations of the jobs, by job index
+        std::unordered_map<std::string_view, uint32_t> job_indexes; //!< Maps job names (views inside representations) to their index
+    };
+
+    std::deque<WorkloadEntry> workloads; //!< The workloads, by workload index
+    std::unordered_map<std::string_view, uint32_t> workload_indexes; //!< Maps workload names to their index
+};
+
+/**
+ * @brief Returns the global table of interned job identifiers
+ * @return The global table of interned job identifiers
+ */
+static JobIdentifierTable & job_identifier_table()
+{
+    static JobIdentifierTable table;
+    return table;
+}
+
+/**
+ * @brief Interns a job identifier
+ * @param[in] workload_name The workload name
+ * @param[in] job_name The job name
+ * @param[out] workload_index The interned index of the workload name
+ * @param[out] job_index The interned index of the job name within its workload
+ */
+static void intern_job_identifier(const std::string & workload_name,
+                                  const std::string & job_name,
+                                  uint32_t & workload_index,
+                                  uint32_t & job_index)
+{
+    JobIdentifierTable & table = job_identifier_table();
+
+    auto workload_it = table.workload_indexes.find(workload_name);
+    if (workload_it == table.workload_indexes.end())
+    {
+        table.workloads.emplace_back();
+        table.workloads.back().name = workload_name;
+        workload_it = table.workload_indexes.emplace(table.workloads.back().name,
+                                                     static_cast<uint32_t>(table.workloads.size() - 1)).first;
+    }
+    workload_index = workload_it->second;
+    JobIdentifierTable::WorkloadEntry & entry = table.workloads[workload_index];
+
+    auto job_it = entry.job_indexes.find(job_name);
+    if (job_it == entry.job_indexes.end())
+    {
+        entry.representations.push_back(workload_name + '!' + job_name);
+        std::string_view job_name_view(entry.representations.back());
+        job_name_view.remove_prefix(workload_name.size() + 1);
+        job_it = entry.job_indexes.emplace(job_name_view, static_cast<uint32_t>(entry.representations.size() - 1)).first;
+    }
+    job_index = job_it->second;
+}
+
 JobIdentifier::JobIdentifier(const std::string & workload_name,
-                             const std::string & job_name) :
-    _workload_name(workload_name),
-    _job_name(job_name)
+                             const std::string & job_name)
 {
+    intern_job_identifier(workload_name, job_name, _workload_index, _job_index);
     check_lexically_valid();
-    _representation = representation();
 }
 
 JobIdentifier::JobIdentifier(const std::string & job_id_str)
@@ -48,21 +114,24 @@ JobIdentifier::JobIdentifier(const std::string & job_id_str)
                "parts, the second one being any string without '!'. Example: 'some_text!42'.",
                job_id_str.c_str());
 
-    this->_workload_name = job_identifier_parts[0];
-    this->_job_name = job_identifier_parts[1];
-
+    intern_job_identifier(job_identifier_parts[0], job_identifier_parts[1], _workload_index, _job_index);
     check_lexically_valid();
-    _representation = representation();
 }
 
-std::string JobIdentifier::to_string() const
+const std::string & JobIdentifier::to_string() const
 {
-    return _representation;
+    static const std::string empty_representation;
+    if (_workload_index == EMPTY_INDEX)
+    {
+        return empty_representation;
+    }
+
+    return job_identifier_table().workloads[_workload_index].representations[_job_index];
 }
 
 const char *JobIdentifier::to_cstring() const
 {
-    return _representation.c_str();
+    return to_string().c_str();
 }
 
 bool JobIdentifier::is_lexically_valid(std::string & reason) const
@@ -70,16 +139,18 @@ bool JobIdentifier::is_lexically_valid(std::string & reason) const
     bool ret = true;
     reason.clear();
 
-    if(_workload_name.find('!') != std::string::npos)
+    const string & workload = workload_name();
+    if(workload.find('!') != std::string::npos)
     {
         ret = false;
-        reason += "Invalid workload_name '" + _workload_name + "': contains a '!'.";
+        reason += "Invalid workload_name '" + workload + "': contains a '!'.";
     }
 
-    if(_job_name.find('!') != std::string::npos)
+    const string job = job_name();
+    if(job.find('!') != std::string::npos)
     {
         ret = false;
-        reason += "Invalid job_name '" + _job_name + "': contains a '!'.";
+        reason += "Invalid job_name '" + job + "': contains a '!'.";
     }
 
     return ret;
@@ -91,37 +162,56 @@ void JobIdentifier::check_lexically_valid() const
     xbt_assert(is_lexically_valid(reason), "%s", reason.c_str());
 }
 
-string JobIdentifier::workload_name() const
+const string & JobIdentifier::workload_name() const
 {
-    return _workload_name;
+    static const std::string empty_name;
+    if (_workload_index == EMPTY_INDEX)
+    {
+        return empty_name;
+    }
+
+    return job_identifier_table().workloads[_workload_index].name;
 }
 
 string JobIdentifier::job_name() const
 {
-    return _job_name;
+    if (_workload_index == EMPTY_INDEX)
+    {
+        return string();
+    }
+
+    return to_string().substr(workload_name().size() + 1);
 }
 
-string JobIdentifier::representation() const
+uint32_t JobIdentifier::workload_index() const
 {
-    return _workload_name + '!' + _job_name;
+    return _workload_index;
+}
+
+uint32_t JobIdentifier::job_index() const
+{
+    return _job_index;
 }
 
 bool operator<(const JobIdentifier &ji1, const JobIdentifier &ji2)
 {
-    return ji1.to_string() < ji2.to_string();
+    if (ji1.workload_index() != ji2.workload_index())
+    {
+        return ji1.workload_index() < ji2.workload_index();
+    }
+    return ji1.job_index() < ji2.job_index();
 }
 
 bool operator==(const JobIdentifier &ji1, const JobIdentifier &ji2)
 {
-    return ji1.to_string() == ji2.to_string();
+    return ji1.workload_index() == ji2.workload_index() && ji1.job_index() == ji2.job_index();
 }
 
 std::size_t JobIdentifierHasher::operator()(const JobIdentifier & id) const
 {
-    return std::hash<std::string>()(id.to_string());
+    return std::hash<uint64_t>()((static_cast<uint64_t>(id.workload_index()) << 32) | id.job_index());
 }
 
-
 BatTask::BatTask(JobPtr parent_job, ProfilePtr profile) :
     parent_job(parent_job),
     profile(profile)
@@ -161,26 +251,17 @@ void Jobs::set_workload(Workload *workload)
     _workload = workload;
 }
 
-void Jobs::load_from_json(const rapidjson::Document &doc, const std::string &filename)
+// Do NOT remove namespaces in the arguments (to avoid doxygen warnings)
+JobPtr Jobs::add_job_from_json(const rapidjson::Value & json_desc, const std::string & error_prefix)
 {
-    string error_prefix = "Invalid JSON file '" + filename + "'";
-
-    xbt_assert(doc.IsObject(), "%s: not a JSON object", error_prefix.c_str());
-    xbt_assert(doc.HasMember("jobs"), "%s: the 'jobs' array is missing", error_prefix.c_str());
-    const Value & jobs = doc["jobs"];
-    xbt_assert(jobs.IsArray(), "%s: the 'jobs' member is not an array", error_prefix.c_str());
-
-    for (SizeType i = 0; i < jobs.Size(); i++) // Uses SizeType instead of size_t
-    {
-        const Value & job_json_description = jobs[i];
+    auto j = Job::from_json(json_desc, _workload, error_prefix);
 
-        auto j = Job::from_json(job_json_description, _workload, error_prefix);
+    xbt_assert(!exists(j->id), "%s: duplication of job id '%s'",
+               error_prefix.c_str(), j->id.to_string().c_str());
+    _jobs[j->id] = j;
+    _jobs_met.insert(j->id);
 
-        xbt_assert(!exists(j->id), "%s: duplication of job id '%s'",
-                   error_prefix.c_str(), j->id.to_string().c_str());
-        _jobs[j->id] = j;
-        _jobs_met.insert({j->id, true});
-    }
+    return j;
 }
 
 JobPtr Jobs::operator[](JobIdentifier job_id)
@@ -216,7 +297,7 @@ void Jobs::add_job(JobPtr job)
                job->id.to_cstring());
 
     _jobs[job->id] = job;
-    _jobs_met.insert({job->id, true});
+    _jobs_met.insert(job->id);
 }
 
 void Jobs::delete_job(const JobIdentifier & job_id, const bool & garbage_collect_profiles)
@@ -298,7 +379,7 @@ bool job_comparator_subtime_number(const JobPtr a, const JobPtr b)
 
 Job::~Job()
 {
-    XBT_INFO("Job '%s' is being deleted", id.to_string().c_str());
+    XBT_DEBUG("Job '%s' is being deleted", id.to_string().c_str());
     xbt_assert(execution_actors.size() == 0,
                "Internal error: job %s on destruction still has %zu execution processes (should be 0).",
                this->id.to_string().c_str(), execution_actors.size());
@@ -324,6 +405,20 @@ bool Job::is_complete() const
            (state == JobState::JOB_STATE_COMPLETED_WALLTIME_REACHED);
 }
 
+JobIdentifier Job::identifier_from_json_id(const std::string & job_id_str,
+                                          const Workload * workload)
+{
+    if (job_id_str.find(workload->name) == std::string::npos)
+    {
+        // the workload name is not present in the job id string
+        return JobIdentifier(workload->name, job_id_str);
+    }
+    else
+    {
+        return JobIdentifier(job_id_str);
+    }
+}
+
 // Do NOT remove namespaces in the arguments (to avoid doxygen warnings)
 JobPtr Job::from_json(const rapidjson::Value & json_desc,
                      Workload * workload,
@@ -352,15 +447,7 @@ JobPtr Job::from_json(const rapidjson::Value & json_desc,
         job_id_str = to_string(json_desc["id"].GetInt());
     }
 
-    if (job_id_str.find(workload->name) == std::string::npos)
-    {
-        // the workload name is not present in the job id string
-        j->id = JobIdentifier(workload->name, job_id_str);
-    }
-    else
-    {
-        j->id = JobIdentifier(job_id_str);
-    }
+    j->id = identifier_from_json_id(job_id_str, workload);
 
     // Get submission time
     xbt_assert(json_desc.HasMember("subtime"), "%s: job '%s' has no 'subtime' field",
@@ -372,7 +459,7 @@ JobPtr Job::from_json(const rapidjson::Value & json_desc,
     // Get walltime (optional)
     if (!json_desc.HasMember("walltime"))
     {
-        XBT_INFO("job '%s' has no 'walltime' field", j->id.to_string().c_str());
+        XBT_DEBUG("job '%s' has no 'walltime' field", j->id.to_string().c_str());
     }
     else
     {
@@ -442,36 +529,23 @@ JobPtr Job::from_json(const std::string & json_str,
 
 std::string job_state_to_string(const JobState & state)
 {
-    string job_state("UNKNOWN");
+    return job_state_to_cstring(state);
+}
 
+const char * job_state_to_cstring(const JobState & state)
+{
     switch (state)
     {
-    case JobState::JOB_STATE_NOT_SUBMITTED:
-        job_state = "NOT_SUBMITTED";
-        break;
-    case JobState::JOB_STATE_SUBMITTED:
-        job_state = "SUBMITTED";
-        break;
-    case JobState::JOB_STATE_RUNNING:
-        job_state = "RUNNING";
-        break;
-    case JobState::JOB_STATE_COMPLETED_SUCCESSFULLY:
-        job_state = "COMPLETED_SUCCESSFULLY";
-        break;
-    case JobState::JOB_STATE_COMPLETED_FAILED:
-        job_state = "COMPLETED_FAILED";
-        break;
-    case JobState::JOB_STATE_COMPLETED_WALLTIME_REACHED:
-        job_state = "COMPLETED_WALLTIME_REACHED";
-        break;
-    case JobState::JOB_STATE_COMPLETED_KILLED:
-        job_state = "COMPLETED_KILLED";
-        break;
-    case JobState::JOB_STATE_REJECTED:
-        job_state = "REJECTED";
-        break;
+    case JobState::JOB_STATE_NOT_SUBMITTED: return "NOT_SUBMITTED";
+    case JobState::JOB_STATE_SUBMITTED: return "SUBMITTED";
+    case JobState::JOB_STATE_RUNNING: return "RUNNING";
+    case JobState::JOB_STATE_COMPLETED_SUCCESSFULLY: return "COMPLETED_SUCCESSFULLY";
+    case JobState::JOB_STATE_COMPLETED_FAILED: return "COMPLETED_FAILED";
+    case JobState::JOB_STATE_COMPLETED_WALLTIME_REACHED: return "COMPLETED_WALLTIME_REACHED";
+    case JobState::JOB_STATE_COMPLETED_KILLED: return "COMPLETED_KILLED";
+    case JobState::JOB_STATE_REJECTED: return "REJECTED";
     }
-    return job_state;
+    return "UNKNOWN";
 }
 
 JobState job_state_from_string(const std::string & state)
@@ -5,7 +5,9 @@
 
 #pragma once
 
+#include <cstdint>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <deque>
 #include <memory>
@@ -26,6 +28,10 @@ struct ExecuteJobMessage;
 
 /**
  * @brief A simple structure used to identify one job
+ * @details Identifiers are interned in a global table: a JobIdentifier is a pair of dense integers
+ *          (the index of its workload name and the index of its job name within the workload).
+ *          Hashing and comparing identifiers is therefore done in constant time, while the string representation
+ *          is only stored once per distinct identifier.
  */
 class JobIdentifier
 {
@@ -54,7 +60,7 @@ public:
      * @details Output format is WORKLOAD_NAME!JOB_NAME
      * @return A string representation of the JobIdentifier.
      */
-    std::string to_string() const;
+    const std::string & to_string() const;
 
     /**
      * @brief Returns a null-terminated C string of the JobIdentifier representation.
@@ -80,7 +86,7 @@ public:
      * @brief Returns the workload name.
      * @return The workload name.
      */
-    std::string workload_name() const;
+    const std::string & workload_name() const;
 
     /**
      * @brief Returns the job name within the workload.
@@ -88,29 +94,37 @@ public:
      */
     std::string job_name() const;
 
-private:
     /**
-     * @brief Computes the string representation of the JobIdentifier.
-     * @return The string representation of the JobIdentifier.
+     * @brief Returns the interned index of the workload name.
+     * @return The interned index of the workload name.
+     */
+    uint32_t workload_index() const;
+
+    /**
+     * @brief Returns the interned index of the job name within its workload.
+     * @return The interned index of the job name within its workload.
      */
-    std::string representation() const;
+    uint32_t job_index() const;
 
 private:
-    std::string _workload_name; //!< The name of the workload the job belongs to
-    std::string _job_name; //!< The job unique name inside its workload
-    std::string _representation; //!< Stores a string representation of the JobIdentifier
+    static constexpr uint32_t EMPTY_INDEX = 0xffffffff; //!< The index of empty identifiers
+
+    uint32_t _workload_index = EMPTY_INDEX; //!< The interned index of the workload the job belongs to
+    uint32_t _job_index = EMPTY_INDEX; //!< The interned index of the job unique name inside its workload
 };
 
 /**
- * @brief Compares two JobIdentifier thanks to their string representations
+ * @brief Compares two JobIdentifier thanks to their interned indexes
+ * @details This is a strict weak ordering (by workload then by job interning order), not the lexicographic order
+ *          of the string representations.
  * @param[in] ji1 The first JobIdentifier
  * @param[in] ji2 The second JobIdentifier
- * @return ji1.to_string() < ji2.to_string()
+ * @return Whether ji1 is ordered before ji2
  */
 bool operator<(const JobIdentifier & ji1, const JobIdentifier & ji2);
 
 /**
- * @brief Compares two JobIdentifier thanks to their string representations
+ * @brief Compares two JobIdentifier thanks to their interned indexes
  * @param[in] ji1 The first JobIdentifier
  * @param[in] ji2 The second JobIdentifier
  * @return ji1.to_string() == ji2.to_string()
@@ -220,6 +234,7 @@ struct Job
     long double starting_time = -1; //!< The time at which the job starts to be executed.
     long double runtime = -1; //!< The amount of time during which the job has been executed.
     bool kill_requested = false; //!< Whether the job kill has been requested
+    bool is_logged = true; //!< Whether the log lines about the lifecycle of the job are written (decided at submission by the LogSampler)
     long double consumed_energy = 0.0; //!< The sum, for all machine on which the job has been allocated, of the consumed energy (in Joules) during the job execution time (consumed_energy_after_job_completion - consumed_energy_before_job_start)
 
     // User inputs
@@ -232,6 +247,16 @@ struct Job
     std::string extra_data = ""; //!< User-given extra data. Not used by Batsim at all but forwarded to EDCs.
 
 public:
+    /**
+     * @brief Builds the identifier of a job from the 'id' field of its JSON description
+     * @details The workload name is prepended to the id, unless the id already contains it
+     * @param[in] job_id_str The 'id' field of the job JSON description (integers being converted to strings)
+     * @param[in] workload The Workload the job is in
+     * @return The job identifier
+     */
+    static JobIdentifier identifier_from_json_id(const std::string & job_id_str,
+                                                 const Workload * workload);
+
     /**
      * @brief Creates a new-allocated Job from a JSON description
      * @param[in] json_desc The JSON description of the job
@@ -315,11 +340,13 @@ public:
     void set_workload(Workload * workload);
 
     /**
-     * @brief Loads the jobs from a JSON document
-     * @param[in] doc The JSON document
-     * @param[in] filename The name of the file the JSON document has been extracted from
+     * @brief Builds one job from its JSON description and adds it into the Jobs
+     * @param[in] json_desc The JSON description of the job
+     * @param[in] error_prefix The prefix to display when an error occurs
+     * @return The newly added job
+     * @pre The profile of the job has already been loaded
      */
-    void load_from_json(const rapidjson::Document & doc, const std::string & filename);
+    JobPtr add_job_from_json(const rapidjson::Value & json_desc, const std::string & error_prefix);
 
     /**
      * @brief Accesses one job thanks to its identifier
@@ -403,7 +430,7 @@ public:
 
 private:
     std::unordered_map<JobIdentifier, JobPtr, JobIdentifierHasher> _jobs; //!< The map that contains the jobs
-    std::unordered_map<JobIdentifier, bool, JobIdentifierHasher> _jobs_met; //!< Stores the jobs id already met during the simulation
+    std::unordered_set<JobIdentifier, JobIdentifierHasher> _jobs_met; //!< The ids of all the jobs met during the simulation. Ids are kept after their job is deleted, so that duplicated ids are detected even when jobs are materialized lazily
     Profiles * _profiles = nullptr; //!< The profiles associated with the jobs
     Workload * _workload = nullptr; //!< The Workload the jobs belong to
 };
@@ -415,6 +442,13 @@ private:
  */
 std::string job_state_to_string(const JobState & state);
 
+/**
+ * @brief Returns a (static) C string corresponding to a given JobState
+ * @param[in] state The JobState
+ * @return A C string corresponding to a given JobState
+ */
+const char * job_state_to_cstring(const JobState & state);
+
 /**
  * @brief Returns a JobState corresponding to a given std::string
  * @param[in] state The std::string
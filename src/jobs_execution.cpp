@@ -94,7 +94,7 @@ int execute_task(
             btask->delay_task_start = simgrid::s4u::Engine::get_clock();
             btask->delay_task_required = data->delay;
 
-            if (do_delay_task(data->delay, remaining_time) == -1)
+            if (do_delay_task(data->delay, remaining_time, job->is_logged) == -1)
             {
                 return -1;
             }
@@ -128,14 +128,20 @@ int execute_task(
     return 1;
 }
 
-int do_delay_task(double sleeptime, double * remaining_time)
+int do_delay_task(double sleeptime, double * remaining_time, bool log)
 {
     // if the walltime is not set or not reached
     if (*remaining_time < 0 || sleeptime < *remaining_time)
     {
-        XBT_INFO("Sleeping the whole task length");
+        if (log)
+        {
+            XBT_INFO("Sleeping the whole task length");
+        }
         simgrid::s4u::this_actor::sleep_for(sleeptime);
-        XBT_INFO("Sleeping done");
+        if (log)
+        {
+            XBT_INFO("Sleeping done");
+        }
         if (*remaining_time > 0)
         {
             *remaining_time = *remaining_time - sleeptime;
@@ -144,9 +150,15 @@ int do_delay_task(double sleeptime, double * remaining_time)
     }
     else
     {
-        XBT_INFO("Sleeping until walltime");
+        if (log)
+        {
+            XBT_INFO("Sleeping until walltime");
+        }
         simgrid::s4u::this_actor::sleep_for(*remaining_time);
-        XBT_INFO("Job has reached walltime");
+        if (log)
+        {
+            XBT_INFO("Job has reached walltime");
+        }
         *remaining_time = 0;
         return -1;
     }
@@ -179,17 +191,26 @@ void execute_job_process(
     job->return_code = execute_task(job->task, context, execution_request, &remaining_time);
     if (job->return_code == 0)
     {
-        XBT_INFO("Job '%s' finished in time (success)", job->id.to_cstring());
+        if (job->is_logged)
+        {
+            XBT_INFO("Job '%s' finished in time (success)", job->id.to_cstring());
+        }
         job->state = JobState::JOB_STATE_COMPLETED_SUCCESSFULLY;
     }
     else if (job->return_code > 0)
     {
-        XBT_INFO("Job '%s' finished in time (failed: return_code=%d)", job->id.to_cstring(), job->return_code);
+        if (job->is_logged)
+        {
+            XBT_INFO("Job '%s' finished in time (failed: return_code=%d)", job->id.to_cstring(), job->return_code);
+        }
         job->state = JobState::JOB_STATE_COMPLETED_FAILED;
     }
     else if (job->return_code == -1)
     {
-        XBT_INFO("Job '%s' had been killed (walltime %Lg reached)", job->id.to_cstring(), job->walltime);
+        if (job->is_logged)
+        {
+            XBT_INFO("Job '%s' had been killed (walltime %Lg reached)", job->id.to_cstring(), job->walltime);
+        }
         job->state = JobState::JOB_STATE_COMPLETED_WALLTIME_REACHED;
         if (context->trace_schedule)
         {
@@ -198,7 +219,10 @@ void execute_job_process(
     }
     else if (job->return_code == -2)
     {
-        XBT_INFO("Job '%s' has been killed by the scheduler", job->id.to_cstring());
+        if (job->is_logged)
+        {
+            XBT_INFO("Job '%s' has been killed by the scheduler", job->id.to_cstring());
+        }
         job->state = JobState::JOB_STATE_COMPLETED_KILLED;
         if (context->trace_schedule)
         {
@@ -343,7 +367,10 @@ void killer_process(
                 xbt_assert(job->execution_actors.size() > 0, "kill inconsistency: no actors to kill while job's task could not be cancelled");
                 for (simgrid::s4u::ActorPtr actor : job->execution_actors)
                 {
-                    XBT_INFO("Killing process '%s'", actor->get_cname());
+                    if (job->is_logged)
+                    {
+                        XBT_INFO("Killing process '%s'", actor->get_cname());
+                    }
                     actor->kill();
                 }
                 job->execution_actors.clear();
@@ -36,9 +36,10 @@ void replay_smpi_trace(JobPtr job, ReplaySmpiProfileData * profile_data, const s
  * @brief Simulates a delay profile (sleeps until finished or walltime)
  * @param[in] sleeptime The time to sleep
  * @param[in,out] remaining_time The remaining amount of time before walltime
+ * @param[in] log Whether log lines should be written
  * @return 0 if enough time is available, -1 in the case of a timeout
  */
-int do_delay_task(double sleeptime, double * remaining_time);
+int do_delay_task(double sleeptime, double * remaining_time, bool log = true);
 
 /**
  * @brief Execute a BatTask recursively regarding on its profile type
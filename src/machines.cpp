@@ -27,19 +27,11 @@ XBT_LOG_NEW_DEFAULT_CATEGORY(machines, "machines"); //!< Logging
 
 Machines::Machines()
 {
-    const vector<MachineState> machine_states = {MachineState::SLEEPING, MachineState::IDLE,
-                                                 MachineState::COMPUTING,
-                                                 MachineState::TRANSITING_FROM_SLEEPING_TO_COMPUTING,
-                                                 MachineState::TRANSITING_FROM_COMPUTING_TO_SLEEPING,
-                                                 MachineState::UNAVAILABLE};
-    for (const MachineState & state : machine_states)
-    {
-        _nb_machines_in_each_state[state] = 0;
-    }
 }
 
 Machines::~Machines()
 {
+    _machines_by_name.clear();
     for (Machine * machine : _machines)
     {
         delete machine;
@@ -301,6 +293,13 @@ void Machines::create_machines(const BatsimContext *context,
         _machines.push_back(machine);
     }
 
+    // Index the machines by name. Names are never modified once the machines are created.
+    _machines_by_name.reserve(_machines.size());
+    for (Machine * machine : _machines)
+    {
+        _machines_by_name[machine->name] = machine;
+    }
+
     // Retrieve zone properties and forward it to machines
     simgrid::s4u::NetZone * root = simgrid::s4u::Engine::get_instance()->get_netzone_root();
     std::unordered_map<std::string, std::string> parent_properties;
@@ -309,7 +308,19 @@ void Machines::create_machines(const BatsimContext *context,
     xbt_assert(_master_machine != nullptr,
                "Cannot find the \"master\" role in the platform file");
 
-    _nb_machines_in_each_state[MachineState::IDLE] = static_cast<int>(_compute_nodes.size());
+    // All machines are initially idle
+    _nb_machines_in_each_state[static_cast<size_t>(MachineState::IDLE)] = static_cast<int>(_compute_nodes.size());
+    if (!_machines.empty())
+    {
+        _machines_in_each_state[static_cast<size_t>(MachineState::IDLE)].insert(IntervalSet::ClosedInterval(0, static_cast<int>(_machines.size()) - 1));
+    }
+
+    // The energy of all machines is read from SimGrid until their power is known
+    _energy_volatile_machines = _machines;
+    for (size_t i = 0; i < _energy_volatile_machines.size(); ++i)
+    {
+        _energy_volatile_machines[i]->energy_volatile_index = i;
+    }
 }
 
 
@@ -354,14 +365,11 @@ Machine * Machines::operator[](int machineID)
     return _machines[static_cast<size_t>(machineID)];
 }
 
-Machine * Machines::machine_by_name_or_null(const std::string & name) const
+Machine * Machines::machine_by_name_or_null(std::string_view name) const
 {
-
-    auto it = std::find_if(_machines.begin(), _machines.end(), [& name](Machine * machine) {
-        return machine->name == name;
-    });
-    if (it != _machines.end())
-        return *it;
+    auto it = _machines_by_name.find(name);
+    if (it != _machines_by_name.end())
+        return it->second;
     return nullptr;
 }
 
@@ -411,20 +419,48 @@ const Machine *Machines::master_machine() const
     return _master_machine;
 }
 
-long double Machines::total_consumed_energy(const BatsimContext *context) const
+long double Machines::total_consumed_energy(const BatsimContext *context)
 {
-    long double total_consumed_energy = 0;
+    if (!context->energy_used)
+    {
+        return -1;
+    }
+
+    const long double now = static_cast<long double>(simgrid::s4u::Engine::get_clock());
+    long double total_consumed_energy = _extrapolated_energy_offset + _extrapolated_power * now;
 
-    if (context->energy_used)
+    for (size_t i = 0; i < _energy_volatile_machines.size(); )
     {
-        for (const Machine * m : _machines)
+        Machine * m = _energy_volatile_machines[i];
+        const long double energy = static_cast<long double>(sg_host_get_consumed_energy(m->host));
+        total_consumed_energy += energy;
+
+        // Idle and sleeping compute machines run nothing, so their power remains constant until their next invalidation.
+        // Machines invalidated at the current time are kept volatile, as other changes may still happen at this time.
+        const bool power_is_stable = m->permissions == roles::Permissions::COMPUTE_NODE &&
+                                     (m->state == MachineState::IDLE || m->state == MachineState::SLEEPING) &&
+                                     m->energy_invalidation_date < now;
+        if (power_is_stable)
         {
-            total_consumed_energy += static_cast<long double>(sg_host_get_consumed_energy(m->host));
+            m->power = static_cast<long double>(sg_host_get_current_consumption(m->host));
+            m->wattmin = static_cast<long double>(sg_host_get_wattmin_at(m->host, sg_host_get_pstate(m->host)));
+            m->energy_offset = energy - m->power * now;
+            m->energy_extrapolated = true;
+
+            _extrapolated_energy_offset += m->energy_offset;
+            _extrapolated_power += m->power;
+            _extrapolated_wattmin += m->wattmin;
+
+            // Remove the machine from the volatile ones (order does not matter)
+            Machine * last = _energy_volatile_machines.back();
+            last->energy_volatile_index = i;
+            _energy_volatile_machines[i] = last;
+            _energy_volatile_machines.pop_back();
+        }
+        else
+        {
+            ++i;
         }
-    }
-    else
-    {
-        total_consumed_energy = -1;
     }
 
     return total_consumed_energy;
@@ -432,23 +468,36 @@ long double Machines::total_consumed_energy(const BatsimContext *context) const
 
 long double Machines::total_wattmin(const BatsimContext *context) const
 {
-    long double total_wattmin = 0;
-
-    if (context->energy_used)
+    if (!context->energy_used)
     {
-        for (const Machine * m : _machines)
-        {
-            total_wattmin += static_cast<long double>(sg_host_get_wattmin_at(m->host, sg_host_get_pstate(m->host)));
-        }
+        return -1;
     }
-    else
+
+    long double total_wattmin = _extrapolated_wattmin;
+    for (const Machine * m : _energy_volatile_machines)
     {
-        total_wattmin = -1;
+        total_wattmin += static_cast<long double>(sg_host_get_wattmin_at(m->host, sg_host_get_pstate(m->host)));
     }
 
     return total_wattmin;
 }
 
+void Machines::invalidate_machine_energy(Machine * machine)
+{
+    machine->energy_invalidation_date = static_cast<long double>(simgrid::s4u::Engine::get_clock());
+
+    if (machine->energy_extrapolated)
+    {
+        _extrapolated_energy_offset -= machine->energy_offset;
+        _extrapolated_power -= machine->power;
+        _extrapolated_wattmin -= machine->wattmin;
+        machine->energy_extrapolated = false;
+
+        machine->energy_volatile_index = _energy_volatile_machines.size();
+        _energy_volatile_machines.push_back(machine);
+    }
+}
+
 unsigned int Machines::nb_machines() const
 {
     return static_cast<unsigned int>(_machines.size());
@@ -464,15 +513,18 @@ unsigned int Machines::nb_storage_machines() const
     return static_cast<unsigned int>(_storage_nodes.size());
 }
 
-void Machines::update_nb_machines_in_each_state(MachineState old_state, MachineState new_state)
+void Machines::update_machines_in_each_state(int machine_id, MachineState old_state, MachineState new_state)
 {
-    _nb_machines_in_each_state[old_state]--;
-    _nb_machines_in_each_state[new_state]++;
-}
+    if (old_state == new_state)
+    {
+        return;
+    }
 
-const std::map<MachineState, int> &Machines::nb_machines_in_each_state() const
-{
-    return _nb_machines_in_each_state;
+    _nb_machines_in_each_state[static_cast<size_t>(old_state)]--;
+    _nb_machines_in_each_state[static_cast<size_t>(new_state)]++;
+
+    _machines_in_each_state[static_cast<size_t>(old_state)].remove(machine_id);
+    _machines_in_each_state[static_cast<size_t>(new_state)].insert(machine_id);
 }
 
 void Machines::update_machines_on_job_run(const JobPtr job,
@@ -593,15 +645,6 @@ Machine::Machine(Machines *machines) :
     machines(machines)
 {
     xbt_assert(this->machines != nullptr, "wrong call: machines is null");
-    const vector<MachineState> machine_states = {MachineState::SLEEPING, MachineState::IDLE,
-                                                 MachineState::COMPUTING,
-                                                 MachineState::TRANSITING_FROM_SLEEPING_TO_COMPUTING,
-                                                 MachineState::TRANSITING_FROM_COMPUTING_TO_SLEEPING,
-                                                 MachineState::UNAVAILABLE};
-    for (const MachineState & state : machine_states)
-    {
-        time_spent_in_each_state[state] = 0;
-    }
 }
 
 Machine::~Machine()
@@ -699,11 +742,23 @@ void Machine::update_machine_state(MachineState new_state)
     long double delta_time = current_date - last_state_change_date;
     xbt_assert(delta_time >= 0, "time inconsistency: time has decreased since last call");
 
-    time_spent_in_each_state[state] += delta_time;
+    time_spent_in_each_state[static_cast<size_t>(state)] += delta_time;
 
-    machines->update_nb_machines_in_each_state(state, new_state);
+    machines->update_machines_in_each_state(id, state, new_state);
     state = new_state;
     last_state_change_date = current_date;
+
+    machines->invalidate_machine_energy(this);
+}
+
+long double Machine::time_spent_in_state(MachineState machine_state, long double current_date) const
+{
+    long double time_spent = time_spent_in_each_state[static_cast<size_t>(machine_state)];
+    if (state == machine_state)
+    {
+        time_spent += current_date - last_state_change_date;
+    }
+    return time_spent;
 }
 
 std::shared_ptr<std::vector<double> > Machine::pstate_speeds() const
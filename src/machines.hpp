@@ -5,8 +5,10 @@
 
 #pragma once
 
+#include <array>
 #include <set>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -37,6 +39,9 @@ enum class MachineState
     ,UNAVAILABLE                            //!< The machine is unavailable
 };
 
+//! The number of values of MachineState
+constexpr size_t NB_MACHINE_STATES = static_cast<size_t>(MachineState::UNAVAILABLE) + 1;
+
 /// @cond DOXYGEN_SHOULD_SKIP_THIS
 // Required by old C++ to use MachineState as a key type in a hashmap
 namespace std
@@ -76,7 +81,14 @@ struct Machine
     std::unordered_map<int, SleepPState *> sleep_pstates; //!< Maps sleep power state numbers to their SleepPState
 
     long double last_state_change_date = 0; //!< The time at which the last state change has been done
-    std::unordered_map<MachineState, long double> time_spent_in_each_state; //!< The cumulated time of the machine in each MachineState
+    std::array<long double, NB_MACHINE_STATES> time_spent_in_each_state = {}; //!< The cumulated time of the machine in each MachineState, indexed by MachineState
+
+    bool energy_extrapolated = false; //!< Whether the consumed energy of the machine is currently extrapolated by Machines instead of being read from SimGrid
+    size_t energy_volatile_index = 0; //!< The index of the machine in the volatile machines of Machines (only meaningful if energy_extrapolated is false)
+    long double energy_invalidation_date = -1; //!< The last time at which the power of the machine may have changed
+    long double energy_offset = 0; //!< The consumed energy of the machine minus power * date, at the time it started to be extrapolated
+    long double power = 0; //!< The power of the machine (in watts) since it started to be extrapolated
+    long double wattmin = 0; //!< The wattmin of the machine since it started to be extrapolated
 
     std::unordered_map<std::string, std::string> properties; //!< Properties defined in the platform file
     std::unordered_map<std::string, std::string> zone_properties; //!< Properties of Zones defined in the platform file
@@ -113,6 +125,14 @@ struct Machine
      */
     void update_machine_state(MachineState new_state);
 
+    /**
+     * @brief Returns the cumulated time of the machine in one MachineState, including the time spent in its current state so far
+     * @param[in] machine_state The MachineState
+     * @param[in] current_date The current date
+     * @return The cumulated time of the machine in the given MachineState
+     */
+    long double time_spent_in_state(MachineState machine_state, long double current_date) const;
+
     /**
      * @brief Returns the computation speed of all pstates
      * @return The computation speed of all pstates
@@ -213,10 +233,11 @@ public:
 
     /**
      * @brief Access a Machine thanks to its name (Machine/Host name is unique Simgrid)
+     * @details Lookups are done in constant time via an index built by create_machines.
      * @param[in] name The machine name
      * @return The machine whose machine name is given. nullptr is returned if the machine is not found.
      */
-    Machine * machine_by_name_or_null(const std::string & name) const;
+    Machine * machine_by_name_or_null(std::string_view name) const;
 
     /**
      * @brief Checks whether a machine exists
@@ -256,18 +277,28 @@ public:
 
     /**
      * @brief Computes and returns the total consumed energy of all the computing machines
+     * @details The energy of idle and sleeping compute machines is extrapolated from their (constant) power,
+     *          so that only the machines whose power may have changed are read from SimGrid.
      * @param[in] context The Batsim context
      * @return The total consumed energy of all the computing machines
      */
-    long double total_consumed_energy(const BatsimContext * context) const;
+    long double total_consumed_energy(const BatsimContext * context);
 
     /**
      * @brief total_wattmin Computes and returns the total wattmin (minimum power) of all the computing machines
+     * @details Should be called after total_consumed_energy at the same simulation time, as they share extrapolated machines.
      * @param[in] context The BatsimContext
      * @return The total wattmin (minimum power) of all the computing machines
      */
     long double total_wattmin(const BatsimContext * context) const;
 
+    /**
+     * @brief Must be called whenever the power of a machine may change (state or pstate change)
+     * @details The energy of the machine is then read from SimGrid until its power is known to be stable again.
+     * @param[in,out] machine The machine
+     */
+    void invalidate_machine_energy(Machine * machine);
+
     /**
      * @brief Returns the total number of machines
      * @return The total number of machines
@@ -287,17 +318,32 @@ public:
     unsigned int nb_storage_machines() const;
 
     /**
-     * @brief Updates the number of machines in each state after a MachineState transition
-     * @param[in] old_state The old state of a Machine
-     * @param[in] new_state The new state of a Machine
+     * @brief Updates the machines in each state after a MachineState transition
+     * @param[in] machine_id The unique number of the Machine
+     * @param[in] old_state The old state of the Machine
+     * @param[in] new_state The new state of the Machine
      */
-    void update_nb_machines_in_each_state(MachineState old_state, MachineState new_state);
+    void update_machines_in_each_state(int machine_id, MachineState old_state, MachineState new_state);
 
     /**
-     * @brief _nb_machines_in_each_state getter
-     * @return A const reference to _nb_machines_in_each_state getter
+     * @brief Returns the number of computing machines in a given state
+     * @param[in] state The MachineState
+     * @return The number of computing machines in the given state
      */
-    const std::map<MachineState, int> & nb_machines_in_each_state() const;
+    int nb_machines_in_state(MachineState state) const
+    {
+        return _nb_machines_in_each_state[static_cast<size_t>(state)];
+    }
+
+    /**
+     * @brief Returns the machines (of any role) in a given state
+     * @param[in] state The MachineState
+     * @return A const reference to the unique numbers of the machines in the given state
+     */
+    const IntervalSet & machines_in_state(MachineState state) const
+    {
+        return _machines_in_each_state[static_cast<size_t>(state)];
+    }
 
     /**
      * @brief Add the properties of zones to each machine inside the zone
@@ -312,9 +358,16 @@ private:
     std::vector<Machine *> _machines;       //!< The vector of all machines
     std::vector<Machine *> _storage_nodes;  //!< The vector of storage machines
     std::vector<Machine *> _compute_nodes;  //!< The vector of computing machines
+    std::unordered_map<std::string_view, Machine *> _machines_by_name; //!< Indexes the machines by name. Keys are views on the names of the machines.
     Machine * _master_machine = nullptr;    //!< The master machine
     PajeTracer * _tracer = nullptr;         //!< The PajeTracer
-    std::map<MachineState, int> _nb_machines_in_each_state; //!< Counts how many machines are in each state
+    std::array<int, NB_MACHINE_STATES> _nb_machines_in_each_state = {}; //!< Counts how many computing machines are in each state, indexed by MachineState
+    std::array<IntervalSet, NB_MACHINE_STATES> _machines_in_each_state; //!< The machines (of any role) in each state, indexed by MachineState
+
+    std::vector<Machine *> _energy_volatile_machines; //!< The machines whose consumed energy is read from SimGrid (not extrapolated)
+    long double _extrapolated_energy_offset = 0; //!< The sum of energy_offset over extrapolated machines
+    long double _extrapolated_power = 0; //!< The sum of power over extrapolated machines
+    long double _extrapolated_wattmin = 0; //!< The sum of wattmin over extrapolated machines
 };
 
 /**
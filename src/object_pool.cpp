@@ -0,0 +1,47 @@
+/**
+ * @file object_pool.cpp
+ * @brief Contains typed object pools, used to recycle the memory of short-lived objects such as inter-actor messages
+ */
+
+#include "object_pool.hpp"
+
+#include <boost/core/demangle.hpp>
+
+#include <simgrid/s4u.hpp>
+
+XBT_LOG_NEW_DEFAULT_CATEGORY(object_pool, "object_pool"); //!< Logging
+
+/**
+ * @brief Returns the statistics of all the object pools that have been used
+ * @return The statistics of all the object pools that have been used
+ */
+static std::vector<ObjectPoolStats *> & object_pools_stats()
+{
+    static std::vector<ObjectPoolStats *> stats;
+    return stats;
+}
+
+void register_object_pool(ObjectPoolStats * stats, const char * mangled_type_name)
+{
+    stats->type_name = boost::core::demangle(mangled_type_name);
+    object_pools_stats().push_back(stats);
+}
+
+void log_object_pool_statistics()
+{
+    uint64_t nb_allocations = 0;
+    uint64_t nb_system_allocations = 0;
+
+    for (const ObjectPoolStats * stats : object_pools_stats())
+    {
+        XBT_INFO("%s: %lu allocations served by %lu system allocations (at most %lu objects in use at the same time)",
+                 stats->type_name.c_str(), static_cast<unsigned long>(stats->nb_allocations),
+                 static_cast<unsigned long>(stats->nb_system_allocations),
+                 static_cast<unsigned long>(stats->max_nb_objects_in_use));
+        nb_allocations += stats->nb_allocations;
+        nb_system_allocations += stats->nb_system_allocations;
+    }
+
+    XBT_INFO("Pooled objects: %lu allocations served by %lu system allocations",
+             static_cast<unsigned long>(nb_allocations), static_cast<unsigned long>(nb_system_allocations));
+}
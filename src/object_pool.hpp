@@ -0,0 +1,193 @@
+/**
+ * @file object_pool.hpp
+ * @brief Contains typed object pools, used to recycle the memory of short-lived objects such as inter-actor messages
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+/**
+ * @brief The allocation statistics of one object pool
+ */
+struct ObjectPoolStats
+{
+    std::string type_name; //!< The name of the type whose objects are pooled
+    uint64_t nb_allocations = 0; //!< The number of objects that have been allocated
+    uint64_t nb_system_allocations = 0; //!< The number of allocations that have actually been done on the system allocator
+    uint64_t nb_objects_in_use = 0; //!< The number of objects currently allocated
+    uint64_t max_nb_objects_in_use = 0; //!< The maximum number of objects that have been allocated at the same time
+};
+
+/**
+ * @brief Registers the statistics of an object pool, so that they are logged by log_object_pool_statistics
+ * @param[in] stats The statistics of the pool. Must outlive the simulation.
+ * @param[in] mangled_type_name The mangled name of the type whose objects are pooled
+ */
+void register_object_pool(ObjectPoolStats * stats, const char * mangled_type_name);
+
+/**
+ * @brief Logs the statistics of all the object pools that have been used
+ */
+void log_object_pool_statistics();
+
+/**
+ * @brief A pool of memory blocks that can each store one object of type T
+ * @details Released blocks are kept in a free list and reused by the next allocations.
+ *          Blocks are allocated by chunks from the system allocator and are never given back to it,
+ *          so that objects released during static destruction still find their pool.
+ *          Pools are not thread-safe, which is fine as simulated actors never run concurrently.
+ */
+template <typename T>
+class ObjectPool
+{
+public:
+    /**
+     * @brief Allocates memory for one object
+     * @param[in] size The requested size. Sizes that differ from sizeof(T) (derived classes) are not pooled.
+     * @return The allocated memory
+     */
+    static void * allocate(std::size_t size)
+    {
+        Pool & p = pool();
+        ++p.stats.nb_allocations;
+        if (++p.stats.nb_objects_in_use > p.stats.max_nb_objects_in_use)
+        {
+            p.stats.max_nb_objects_in_use = p.stats.nb_objects_in_use;
+        }
+
+        if (size != sizeof(T))
+        {
+            ++p.stats.nb_system_allocations;
+            return ::operator new(size);
+        }
+
+        if (p.free_list == nullptr)
+        {
+            allocate_chunk(p);
+        }
+
+        Block * block = p.free_list;
+        p.free_list = block->next;
+        return block;
+    }
+
+    /**
+     * @brief Gives the memory of one object back to the pool
+     * @param[in] ptr The memory to release, as returned by allocate
+     * @param[in] size The size that has been given to allocate
+     */
+    static void release(void * ptr, std::size_t size)
+    {
+        if (ptr == nullptr)
+        {
+            return;
+        }
+
+        Pool & p = pool();
+        --p.stats.nb_objects_in_use;
+
+        if (size != sizeof(T))
+        {
+            ::operator delete(ptr);
+            return;
+        }
+
+        Block * block = static_cast<Block *>(ptr);
+        block->next = p.free_list;
+        p.free_list = block;
+    }
+
+private:
+    /**
+     * @brief A memory block, that either stores an object or is in the free list
+     */
+    union Block
+    {
+        Block * next; //!< The next free block, when the block is in the free list
+        alignas(T) unsigned char storage[sizeof(T)]; //!< The object storage, when the block is allocated
+    };
+
+    static const std::size_t NB_BLOCKS_PER_CHUNK = 256; //!< The number of blocks allocated at once from the system allocator
+
+    /**
+     * @brief The state of the pool
+     */
+    struct Pool
+    {
+        Block * free_list = nullptr; //!< The blocks that can be allocated
+        std::vector<Block *> chunks; //!< The chunks of blocks allocated from the system allocator
+        ObjectPoolStats stats; //!< The allocation statistics of the pool
+    };
+
+    /**
+     * @brief Returns the state of the pool (created on first use)
+     * @return The state of the pool
+     */
+    static Pool & pool()
+    {
+        static Pool * p = create_pool();
+        return *p;
+    }
+
+    /**
+     * @brief Creates and registers the state of the pool
+     * @return The state of the pool
+     */
+    static Pool * create_pool()
+    {
+        Pool * p = new Pool;
+        register_object_pool(&p->stats, typeid(T).name());
+        return p;
+    }
+
+    /**
+     * @brief Allocates a new chunk of blocks from the system allocator and puts them in the free list
+     * @param[in,out] p The state of the pool
+     */
+    static void allocate_chunk(Pool & p)
+    {
+        Block * chunk = new Block[NB_BLOCKS_PER_CHUNK];
+        ++p.stats.nb_system_allocations;
+        p.chunks.push_back(chunk);
+
+        for (std::size_t i = 0; i < NB_BLOCKS_PER_CHUNK; ++i)
+        {
+            chunk[i].next = p.free_list;
+            p.free_list = &chunk[i];
+        }
+    }
+};
+
+/**
+ * @brief Makes the dynamic allocations of a type go through its ObjectPool
+ * @details Inherit from PoolAllocated<T> in the definition of T. Plain new and delete expressions are then pooled.
+ */
+template <typename T>
+struct PoolAllocated
+{
+    /**
+     * @brief Allocates the memory of one object from the pool
+     * @param[in] size The size of the object
+     * @return The allocated memory
+     */
+    static void * operator new(std::size_t size)
+    {
+        return ObjectPool<T>::allocate(size);
+    }
+
+    /**
+     * @brief Gives the memory of one object back to the pool
+     * @param[in] ptr The memory of the object
+     * @param[in] size The size of the object
+     */
+    static void operator delete(void * ptr, std::size_t size)
+    {
+        ObjectPool<T>::release(ptr, size);
+    }
+};
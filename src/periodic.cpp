@@ -16,39 +16,6 @@
 
 XBT_LOG_NEW_DEFAULT_CATEGORY(periodic, "periodic"); //!< Logging
 
-enum class PeriodicTriggerType
-{
-  CALL_ME_LATER
-, PROBE
-};
-
-const char * periodic_trigger_type_to_cstring(PeriodicTriggerType type) {
-  switch (type) {
-    case PeriodicTriggerType::CALL_ME_LATER:
-      return "CALL_ME_LATER";
-    case PeriodicTriggerType::PROBE:
-      return "PROBE";
-  };
-  return nullptr;
-}
-
-struct PeriodicTrigger
-{
-  Periodic periodic;
-  PeriodicTriggerType type;
-  void * data;
-};
-
-const char * periodic_trigger_id_cstring(const PeriodicTrigger & trigger) {
-  switch (trigger.type) {
-    case PeriodicTriggerType::CALL_ME_LATER:
-      return (static_cast<CallMeLaterMessage*>(trigger.data))->call_id.c_str();
-    case PeriodicTriggerType::PROBE:
-      xbt_assert(false, "TODO: implement me");
-  }
-  return nullptr;
-}
-
 void set_periodic_in_ms(Periodic & p) {
   switch (p.time_unit) {
     case batprotocol::fb::TimeUnit_Millisecond:
@@ -56,232 +23,315 @@ void set_periodic_in_ms(Periodic & p) {
     case batprotocol::fb::TimeUnit_Second: {
       p.time_unit = batprotocol::fb::TimeUnit_Millisecond;
       p.period *= 1000;
+      p.offset *= 1000;
     } break;
   }
 }
 
-void generate_static_periodic_schedule(
-  const std::map<std::string, CallMeLaterMessage*> & cml_triggers,
-  const std::map<std::string, CreateProbeMessage*> & probes,
-  std::vector<TimeSlice> & schedule,
-  uint64_t & slice_duration
-) {
-  // check that all periods have offset=0 and are expressed in the same unit (milliseconds)
-  std::map<uint64_t, std::vector<PeriodicTrigger>> triggers;
-  for (const auto & [_, cml] : cml_triggers) {
-    xbt_assert(cml->periodic.offset == 0, "CallMeLater (id='%s') has non-zero offset (%lu), which is not supported", cml->call_id.c_str(), cml->periodic.offset);
-    xbt_assert(cml->periodic.time_unit == batprotocol::fb::TimeUnit_Millisecond, "internal inconsistency: CallMeLater (id='%s') has non-ms time units, which should not happen here", cml->call_id.c_str());
-
-    auto trigger = PeriodicTrigger{
-      cml->periodic,
-      PeriodicTriggerType::CALL_ME_LATER,
-      (void*)cml
-    };
-
-    auto it = triggers.find(cml->periodic.period);
-    if (it == triggers.end())
-      triggers[cml->periodic.period] = {trigger};
-    else
-      it->second.emplace_back(trigger);
+uint64_t periodic_first_fire_time(uint64_t period, uint64_t offset, double creation_time) {
+  xbt_assert(period > 0, "invalid periodic trigger: period must be positive");
+  if (creation_time < (double)offset)
+    return offset;
+
+  // first offset + k*period strictly after creation_time
+  uint64_t k = (uint64_t)std::floor((creation_time - (double)offset) / (double)period) + 1;
+  uint64_t fire_time = offset + k * period;
+  xbt_assert(fire_time >= offset && (fire_time - offset) / period == k, "integer overflow?!");
+  return fire_time;
+}
+
+void PeriodicTimeline::insert(PeriodicTriggerType type, const std::string & id, uint64_t fire_time) {
+  auto [_, inserted] = _fire_times.emplace(std::make_pair(type, id), fire_time);
+  (void) inserted; // Avoids a warning if assertions are ignored
+  xbt_assert(inserted, "internal inconsistency: trigger '%s' is already in the periodic timeline", id.c_str());
+  _entries.insert(Entry{fire_time, type, id});
+}
+
+bool PeriodicTimeline::remove(PeriodicTriggerType type, const std::string & id) {
+  auto it = _fire_times.find(std::make_pair(type, id));
+  if (it == _fire_times.end())
+    return false;
+
+  _entries.erase(Entry{it->second, type, id});
+  _fire_times.erase(it);
+  return true;
+}
+
+void PeriodicTimeline::pop_next(std::vector<Entry> & entries) {
+  entries.clear();
+  if (_entries.empty())
+    return;
+
+  const uint64_t fire_time = _entries.begin()->fire_time;
+  while (!_entries.empty() && _entries.begin()->fire_time == fire_time) {
+    auto node = _entries.extract(_entries.begin());
+    _fire_times.erase(std::make_pair(node.value().type, node.value().id));
+    entries.emplace_back(std::move(node.value()));
   }
+}
 
-  for (const auto & [_, probe] : probes) {
-    xbt_assert(probe->periodic.offset == 0, "Probe (id='%s') has non-zero offset (%lu), which is not supported", probe->probe_id.c_str(), probe->periodic.offset);
-    xbt_assert(probe->periodic.time_unit == batprotocol::fb::TimeUnit_Millisecond, "internal inconsistency: Probe (id='%s') has non-ms time units, which should not happen here", probe->probe_id.c_str());
-
-    auto trigger = PeriodicTrigger{
-      probe->periodic,
-      PeriodicTriggerType::PROBE,
-      (void*)probe
-    };
-
-    auto it = triggers.find(probe->periodic.period);
-    if (it == triggers.end())
-      triggers[probe->periodic.period] = {trigger};
-    else
-      it->second.emplace_back(trigger);
+double sum_probed_values(const double * values, size_t nb_values) {
+  // Four independent partial sums break the dependency chain of the scalar loop,
+  // which lets the compiler use SIMD additions without reassociating floating-point operations itself
+  double sums[4] = {0.0, 0.0, 0.0, 0.0};
+  size_t i = 0;
+  for (; i + 4 <= nb_values; i += 4) {
+    sums[0] += values[i];
+    sums[1] += values[i+1];
+    sums[2] += values[i+2];
+    sums[3] += values[i+3];
   }
+  for (; i < nb_values; ++i)
+    sums[0] += values[i];
 
-  // check that all different periods are multiple or each other
-  bool period_inconsistency = false;
-  std::vector<uint64_t> periods;
-  for (const auto& [period, _] : triggers)
-    periods.push_back(period);
-  for (unsigned int i = 0; i < periods.size(); ++i) {
-    for (unsigned int j = i+1; j < periods.size(); ++j) {
-      if (periods[j] % periods[i] != 0) {
-        period_inconsistency = true;
-        const auto & p_i = triggers[periods[i]].at(0);
-        const auto & p_j = triggers[periods[j]].at(0);
-        XBT_ERROR("Period inconsistency found within periodic triggers."
-          "All periods should be the same, or longer periods should be a multiple of all shorter periods."
-          "Period %lu is incompatible with period %lu, as the remainder of %lu/%lu is non-zero."
-          "Example of triggers with such periods:"
-          "%s(id='%s', period=%lu ms) and %s(id='%s', period=%lu ms)",
-          periods[j], periods[i], periods[j], periods[i],
-          periodic_trigger_type_to_cstring(p_j.type), periodic_trigger_id_cstring(p_j), p_j.periodic.period,
-          periodic_trigger_type_to_cstring(p_i.type), periodic_trigger_id_cstring(p_i), p_i.periodic.period
-        );
+  return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+}
+
+/**
+ * @brief Builds the immutable description of a probe and resolves the SimGrid resources it measures
+ * @param[in] context The BatsimContext
+ * @param[in,out] probe The probe
+ */
+static void prepare_probe(BatsimContext * context, CreateProbeMessage * probe) {
+  auto description = std::make_shared<ProbeDescription>();
+  description->probe_id = probe->probe_id;
+  description->resource_type = probe->resource_type;
+  description->metrics = probe->metrics;
+
+  size_t nb_resources = 0;
+  switch (probe->resource_type) {
+    case batprotocol::fb::Resources_HostResources: {
+      xbt_assert(probe->metric != ProbeMetric::LINK_TRAFFIC, "invalid CreateProbe (probe_id='%s'): the traffic of hosts cannot be probed", probe->probe_id.c_str());
+      xbt_assert(probe->metric != ProbeMetric::POWER || context->energy_used,
+        "invalid CreateProbe (probe_id='%s'): trying to probe energy on hosts but the 'host_energy' SimGrid plugin has not been enabled", probe->probe_id.c_str());
+
+      description->hosts = probe->hosts;
+      description->hosts_str = probe->hosts.to_string_hyphen();
+
+      probe->probed_hosts.reserve(probe->hosts.size());
+      probe->probed_machines.reserve(probe->hosts.size());
+      for (auto it = probe->hosts.elements_begin(); it != probe->hosts.elements_end(); ++it) {
+        const Machine * machine = context->machines[*it];
+        probe->probed_hosts.push_back(machine->host);
+        probe->probed_machines.push_back(machine);
       }
-    }
+      nb_resources = probe->probed_hosts.size();
+    } break;
+    case batprotocol::fb::Resources_LinkResources: {
+      xbt_assert(probe->metric != ProbeMetric::HOST_LOAD, "invalid CreateProbe (probe_id='%s'): the computing load of links cannot be probed", probe->probe_id.c_str());
+      xbt_assert(probe->metric != ProbeMetric::POWER || context->link_energy_used,
+        "invalid CreateProbe (probe_id='%s'): trying to probe energy on links but the 'link_energy' SimGrid plugin has not been enabled", probe->probe_id.c_str());
+
+      probe->probed_links.reserve(probe->links.size());
+      for (const auto & link_name : probe->links) {
+        auto * link = simgrid::s4u::Link::by_name_or_null(link_name);
+        xbt_assert(link != nullptr, "invalid CreateProbe (probe_id='%s'): link '%s' does not exist", probe->probe_id.c_str(), link_name.c_str());
+        probe->probed_links.push_back(link);
+      }
+      nb_resources = probe->probed_links.size();
+
+      description->links = std::make_shared<std::vector<std::string> >(std::move(probe->links));
+    } break;
+    default: {
+      xbt_assert(false, "invalid CreateProbe (probe_id='%s'): unsupported resource type", probe->probe_id.c_str());
+    } break;
   }
-  xbt_assert(!period_inconsistency, "Period inconsistency found, aborting");
 
-  // clear output values and leave now in degenerate case (nothing to do)
-  schedule.clear();
-  slice_duration = 0;
-  if (triggers.empty())
-    return;
+  if (probe->data_accumulation_strategy == batprotocol::fb::ProbeDataAccumulationStrategy_ProbeDataAccumulation) {
+    xbt_assert(probe->metric != ProbeMetric::LINK_TRAFFIC, "invalid CreateProbe (probe_id='%s'): the traffic of links cannot be accumulated", probe->probe_id.c_str());
+  }
+  else {
+    xbt_assert(probe->metric != ProbeMetric::POWER || probe->resource_type == batprotocol::fb::Resources_HostResources,
+      "invalid CreateProbe (probe_id='%s'): the current power of links cannot be probed, only their accumulated energy", probe->probe_id.c_str());
+  }
+
+  probe->values_buffer.reserve(nb_resources);
+  probe->temporal_aggregator.reset(probe->temporal_aggregation, nb_resources);
+  probe->description = std::move(description);
+}
+
+/**
+ * @brief Returns whether a probe accumulates its data and resets it each time it emits it
+ * @param[in] probe The probe
+ * @return Whether the probe accumulates its data with reset
+ */
+static bool is_reset_on_emission(const CreateProbeMessage * probe) {
+  return probe->data_accumulation_strategy == batprotocol::fb::ProbeDataAccumulationStrategy_ProbeDataAccumulation &&
+         probe->data_accumulation_reset_mode == batprotocol::fb::ResetMode_ProbeAccumulationReset;
+}
 
-  // compute how many slices are needed
-  std::vector<uint64_t> multiples;
-  uint64_t nb_slices = 1;
-  for (unsigned int i = 1; i < periods.size(); ++i) {
-    uint64_t multiple = periods[i] / periods[i-1];
-    multiples.push_back(multiple);
-    nb_slices *= multiple;
+/**
+ * @brief Reads the counter of each resource of an accumulative probe (consumed energy, time spent computing)
+ * @param[in] probe The probe
+ * @param[out] values The counter of each resource
+ */
+static void read_probe_counters(const CreateProbeMessage * probe, std::vector<double> & values) {
+  values.clear();
+  switch (probe->metric) {
+    case ProbeMetric::POWER: {
+      if (probe->resource_type == batprotocol::fb::Resources_HostResources) {
+        for (auto * host : probe->probed_hosts)
+          values.push_back(sg_host_get_consumed_energy(host));
+      }
+      else {
+        for (auto * link : probe->probed_links)
+          values.push_back(sg_link_get_consumed_energy(link));
+      }
+    } break;
+    case ProbeMetric::HOST_LOAD: {
+      const long double now = static_cast<long double>(simgrid::s4u::Engine::get_clock());
+      for (const auto * machine : probe->probed_machines)
+        values.push_back(static_cast<double>(machine->time_spent_in_state(MachineState::COMPUTING, now)));
+    } break;
+    case ProbeMetric::LINK_TRAFFIC: {
+      xbt_assert(false, "the traffic of links cannot be accumulated");
+    } break;
   }
+}
 
-  // populate static schedule, while checking for integer overflows
-  schedule.resize(nb_slices);
-  slice_duration = periods.at(0);
-  uint64_t previous_time = 0;
-  for (unsigned int i = 0; i < nb_slices; ++i) {
-    uint64_t current_time = slice_duration * i;
-    xbt_assert(current_time >= previous_time, "integer overflow?!");
-    auto & slice = schedule[i];
-    slice.duration = (double)slice_duration;
-    slice.cml_triggers.clear();
-    for (const auto & [_, cml] : cml_triggers) {
-      if (current_time % cml->periodic.period == 0)
-        slice.cml_triggers.push_back(cml);
-    }
-    for (const auto & [_, probe] : probes) {
-      if (current_time % probe->periodic.period == 0)
-        slice.probes.push_back(probe);
-    }
-    previous_time = current_time;
+/**
+ * @brief Reads the current value of each resource of a non-accumulative probe (power, computing load, used bandwidth)
+ * @param[in] probe The probe
+ * @param[out] values The current value of each resource
+ */
+static void read_probe_current_values(const CreateProbeMessage * probe, std::vector<double> & values) {
+  values.clear();
+  switch (probe->metric) {
+    case ProbeMetric::POWER: {
+      for (auto * host : probe->probed_hosts)
+        values.push_back(sg_host_get_current_consumption(host));
+    } break;
+    case ProbeMetric::HOST_LOAD: {
+      for (const auto * machine : probe->probed_machines)
+        values.push_back(machine->state == MachineState::COMPUTING ? 1.0 : 0.0);
+    } break;
+    case ProbeMetric::LINK_TRAFFIC: {
+      for (auto * link : probe->probed_links)
+        values.push_back(link->get_load());
+    } break;
   }
 }
 
-void periodic_main_actor(BatsimContext * context)
-{
-  auto mbox = simgrid::s4u::Mailbox::by_name("periodic");
-  bool need_reschedule = false;
-  bool die_received = false;
-  std::map<std::string, CallMeLaterMessage*> cml_triggers;
-  std::map<std::string, CreateProbeMessage*> probes;
+/**
+ * @brief Initializes a probe at its first trigger. Accumulative probes with reset start accumulating from there.
+ * @param[in,out] probe The probe
+ */
+static void initialize_probe(CreateProbeMessage * probe) {
+  if (is_reset_on_emission(probe)) {
+    read_probe_counters(probe, probe->accumulation_baselines);
+    probe->accumulation_start_time = simgrid::s4u::Engine::get_clock();
+  }
+  probe->initialized = true;
+}
 
-  std::vector<TimeSlice> static_schedule;
-  uint64_t slice_duration = 0;
-  unsigned int current_slice_i = 0;
-  double next_timeout_duration = 0;
+/**
+ * @brief Measures the value of each resource of a probe into its values buffer
+ * @details Accumulative probes measure the counter of each resource (since their last reset if they are reset on emission),
+ *          which is divided by the accumulation duration if temporal normalization is enabled.
+ *          Non-accumulative probes measure the current value of each resource.
+ *          The temporal aggregation function of the probe is then applied on the values.
+ * @param[in,out] probe The probe
+ */
+static void measure_probe_values(CreateProbeMessage * probe) {
+  auto & values = probe->values_buffer;
 
-  while (!die_received) {
-    need_reschedule = false;
-    // Wait for current slice to terminate while being able to receive a message from the server.
-    // If there is currently no triggers, just wait for a message without timeout.
-    IPMessage * message = nullptr;
-    try {
-      if (static_schedule.empty())
-        message = mbox->get<IPMessage>();
-      else {
-        uint64_t total_schedule_length = slice_duration * static_schedule.size();
-        double current_time = simgrid::s4u::Engine::get_clock() * 1e3; // simgrid is in s, this module is in ms
-        double current_time_mod_schedule_length = fmod(current_time, (double)total_schedule_length);
-        double elapsed = fmod(current_time_mod_schedule_length, slice_duration);
-        current_slice_i = (uint64_t)(current_time_mod_schedule_length) / slice_duration;
-        next_timeout_duration = static_schedule[current_slice_i].duration - elapsed;
-        xbt_assert(next_timeout_duration > 0, "internal inconsistency");
-        message = mbox->get<IPMessage>(next_timeout_duration * 1e-3); // this modules expresses everything in milliseconds
-      }
+  if (probe->data_accumulation_strategy == batprotocol::fb::ProbeDataAccumulationStrategy_ProbeDataAccumulation) {
+    read_probe_counters(probe, values);
 
-      // A message from the server has been received
-      switch(message->type) {
-        case IPMessageType::DIE: {
-          die_received = true;
-        } break;
-        case IPMessageType::SCHED_CALL_ME_LATER: {
-          auto msg = static_cast<CallMeLaterMessage*>(message->data);
-          message->data = nullptr;
-          auto it = cml_triggers.find(msg->call_id);
-          xbt_assert(it == cml_triggers.end(), "received a new CallMeLater with call_id='%s' while this call_id is already in use", msg->call_id.c_str());
-          xbt_assert(msg->periodic.is_infinite || msg->periodic.nb_periods >= 1, "invalid CallMeLater (call_id='%s'): finite but nb_periods=%u should be greater than 0", msg->call_id.c_str(), msg->periodic.nb_periods);
-          set_periodic_in_ms(msg->periodic);
-          cml_triggers[msg->call_id] = msg;
-          need_reschedule = true;
-        } break;
-        case IPMessageType::SCHED_CREATE_PROBE: {
-          auto msg = static_cast<CreateProbeMessage*>(message->data);
-          message->data = nullptr;
-          msg->initialized = false;
-          auto it = probes.find(msg->probe_id);
-          xbt_assert(it == probes.end(), "received a new CreateProbe with probe_id='%s' while this probe_id is already in use", msg->probe_id.c_str());
-          xbt_assert(msg->periodic.is_infinite || msg->periodic.nb_periods >= 1, "invalid CreateProbe (probe_id='%s'): finite but nb_periods=%u should be greater than 0", msg->probe_id.c_str(), msg->periodic.nb_periods);
-          set_periodic_in_ms(msg->periodic);
-          probes[msg->probe_id] = msg;
-          need_reschedule = true;
-        } break;
-        case IPMessageType::SCHED_STOP_CALL_ME_LATER: {
-          auto msg = static_cast<StopCallMeLaterMessage*>(message->data);
-          message->data = nullptr;
-          auto it = cml_triggers.find(msg->call_id);
-          if (it == cml_triggers.end()) {
-            XBT_WARN("Received a StopCallMeLater on call_id='%s', but no such call is running", msg->call_id.c_str());
-          } else {
-            XBT_INFO("Stopping CallMeLater on call_id='%s'", msg->call_id.c_str());
-
-            auto * m = new PeriodicEntityStoppedMessage;
-            m->entity_id = msg->call_id;
-            m->is_probe = false;
-            m->is_call_me_later = true;
-            send_message("server", IPMessageType::PERIODIC_ENTITY_STOPPED, static_cast<void*>(m));
-
-            cml_triggers.erase(msg->call_id);
-            delete msg;
-            need_reschedule = true;
-          }
-        } break;
-        case IPMessageType::SCHED_STOP_PROBE: {
-          auto msg = static_cast<StopProbeMessage*>(message->data);
-          message->data = nullptr;
-          auto it = probes.find(msg->probe_id);
-          if (it == probes.end()) {
-            XBT_WARN("Received a StopProbe on probe_id='%s', but no such probe is running", msg->probe_id.c_str());
-          } else {
-            XBT_INFO("Stopping probe with probe_id='%s'", msg->probe_id.c_str());
-
-            auto * m = new PeriodicEntityStoppedMessage;
-            m->entity_id = msg->probe_id;
-            m->is_probe = true;
-            m->is_call_me_later = false;
-            send_message("server", IPMessageType::PERIODIC_ENTITY_STOPPED, static_cast<void*>(m));
-
-            probes.erase(msg->probe_id);
-            delete msg;
-            need_reschedule = true;
-          }
-        } break;
-        default: {
-          xbt_assert(false, "Unexpected message received: %s", ip_message_type_to_string(message->type).c_str());
-        } break;
+    const double now = simgrid::s4u::Engine::get_clock();
+    const double accumulation_duration = now - probe->accumulation_start_time;
+
+    if (is_reset_on_emission(probe)) {
+      for (size_t i = 0; i < values.size(); ++i) {
+        const double counter = values[i];
+        values[i] = probe->data_accumulation_reset_value + counter - probe->accumulation_baselines[i];
+        probe->accumulation_baselines[i] = counter;
       }
-      delete message;
-      message = nullptr;
+      probe->accumulation_start_time = now;
+    }
 
-      if (die_received)
-        break;
+    if (probe->data_accumulation_temporal_normalization && accumulation_duration > 0) {
+      for (auto & value : values)
+        value /= accumulation_duration;
     }
-    catch (const simgrid::TimeoutException&) {
-      // The end of the current slice has been reached without receiving any message from the server
-      current_slice_i = (current_slice_i + 1) % static_schedule.size();
+  }
+  else
+    read_probe_current_values(probe, values);
+
+  if (probe->temporal_aggregator.is_enabled())
+    probe->temporal_aggregator.add_values(values.data());
+}
+
+/**
+ * @brief Measures a probe
+ * @param[in,out] probe The probe
+ * @return The measured probe data, to be sent to the server
+ */
+static ProbeData * measure_probe(CreateProbeMessage * probe) {
+  measure_probe_values(probe);
+
+  // Emission filtering is not implemented: all measures are emitted
+  ++probe->nb_emitted;
 
-      // Populate the content of the full message that should be sent to the server
-      auto * msg = new PeriodicTriggerMessage;
-      auto & slice = static_schedule[current_slice_i];
+  auto * probe_data = new ProbeData;
+  probe_data->description = probe->description;
 
-      // CallMeLater triggers
-      for (auto * cml : slice.cml_triggers) {
+  probe_data->manually_triggered = !probe->is_periodic; // One-shot probes are triggered on demand, at the time requested by the EDC
+  probe_data->nb_triggered = probe->nb_triggered;
+  probe_data->nb_emitted = probe->nb_emitted;
+  probe_data->is_last_periodic = !probe->is_periodic || (!probe->periodic.is_infinite && probe->periodic.nb_periods == 1);
+
+  switch(probe->resource_agregation_type) {
+    case batprotocol::fb::ResourcesAggregationFunction_NoResourcesAggregation: {
+      probe_data->data_type = batprotocol::fb::ProbeData_VectorialProbeData;
+      probe_data->vectorial_data = probe->values_buffer;
+    } break;
+    case batprotocol::fb::ResourcesAggregationFunction_Sum:
+    case batprotocol::fb::ResourcesAggregationFunction_ArithmeticMean: {
+      probe_data->data_type = batprotocol::fb::ProbeData_AggregatedProbeData;
+      probe_data->aggregated_data = sum_probed_values(probe->values_buffer.data(), probe->values_buffer.size());
+      if (probe->resource_agregation_type == batprotocol::fb::ResourcesAggregationFunction_ArithmeticMean)
+        probe_data->aggregated_data /= probe->values_buffer.size();
+    } break;
+    default: {
+      xbt_assert(false, "unimplemented resource aggregation type");
+    } break;
+  };
+
+  return probe_data;
+}
+
+ProbeData * measure_oneshot_probe(BatsimContext * context, CreateProbeMessage * probe) {
+  xbt_assert(!probe->is_periodic, "inconsistency: probe_id='%s' is periodic", probe->probe_id.c_str());
+  prepare_probe(context, probe);
+  initialize_probe(probe);
+  return measure_probe(probe);
+}
+
+/**
+ * @brief Fires the next triggers of the timeline, and sends what they emit to the server
+ * @param[in,out] timeline The timeline of the triggers. Fired triggers are inserted back at their next firing time, if any.
+ * @param[in,out] cml_triggers The CallMeLater triggers. Finished triggers are removed.
+ * @param[in,out] probes The probes. Finished probes are removed.
+ */
+static void fire_next_triggers(
+  PeriodicTimeline & timeline,
+  std::map<std::string, CallMeLaterMessage*> & cml_triggers,
+  std::map<std::string, CreateProbeMessage*> & probes
+) {
+  std::vector<PeriodicTimeline::Entry> fired_triggers;
+  timeline.pop_next(fired_triggers);
+
+  // Populate the content of the full message that should be sent to the server
+  auto * msg = new PeriodicTriggerMessage;
+
+  for (const auto & trigger : fired_triggers) {
+    bool finished = false;
+    const Periodic * periodic = nullptr;
+
+    switch (trigger.type) {
+      case PeriodicTriggerType::CALL_ME_LATER: {
+        auto * cml = cml_triggers.at(trigger.id);
         msg->calls.emplace_back(RequestedCall{
           cml->call_id,
           !cml->periodic.is_infinite && cml->periodic.nb_periods == 1
@@ -291,92 +341,188 @@ void periodic_main_actor(BatsimContext * context)
           --cml->periodic.nb_periods;
           if (cml->periodic.nb_periods == 0) {
             XBT_INFO("Periodic trigger CallMeLater(call_id='%s') just issued its last call!", cml->call_id.c_str());
-            need_reschedule = true;
             cml_triggers.erase(cml->call_id);
             delete cml;
+            finished = true;
           }
         }
-      }
-
-      // Probe data
-      for (auto probe_it = slice.probes.begin(); probe_it != slice.probes.end(); ) {
-        auto * probe = *probe_it;
-        bool erased = false;
+        if (!finished)
+          periodic = &cml->periodic;
+      } break;
+      case PeriodicTriggerType::PROBE: {
+        auto * probe = probes.at(trigger.id);
+        if (probe->is_periodic)
+          ++probe->nb_triggered;
         if (probe->initialized) {
-          xbt_assert(probe->metrics == batprotocol::fb::Metrics_Power, "only the power metrics is implemented");
-          xbt_assert(probe->resource_type == batprotocol::fb::Resources_HostResources, "only the host resource type is implemented");
-          xbt_assert(context->energy_used, "trying to probe energy on hosts but the 'host_energy' SimGrid plugin has not been enabled");
-
-          // TODO: populate the immutable fields only once, then just memcpy this for a new probe? or just put the original probe data into the message? (requires smart ptr)
-          auto * probe_data = new ProbeData;
-          probe_data->probe_id = probe->probe_id;
-          probe_data->resource_type = probe->resource_type;
-          probe_data->hosts = probe->hosts;
-          probe_data->metrics = probe->metrics;
-
-          probe_data->manually_triggered = false;
-          probe_data->nb_triggered = 0; // TODO: implement me
-          probe_data->nb_emitted = 0; // TODO: implement me
-          probe_data->is_last_periodic = !probe->periodic.is_infinite && probe->periodic.nb_periods == 1;
-
-          // TODO: populate an iterator of s4u hosts once per probe to avoid this slow traversal + host retrieval
-          probe_data->vectorial_data.reserve(probe->hosts.size());
-          for (auto it = probe->hosts.elements_begin(); it != probe->hosts.elements_end(); ++it)
-          {
-              int machine_id = *it;
-              Machine * machine = context->machines[machine_id];
-              probe_data->vectorial_data.emplace_back(sg_host_get_consumed_energy(machine->host));
-          }
+          msg->probes_data.emplace_back(measure_probe(probe));
 
-          switch(probe->resource_agregation_type) {
-            case batprotocol::fb::ResourcesAggregationFunction_NoResourcesAggregation: {
-              probe_data->data_type = batprotocol::fb::ProbeData_VectorialProbeData;
-            } break;
-            case batprotocol::fb::ResourcesAggregationFunction_Sum:
-            case batprotocol::fb::ResourcesAggregationFunction_ArithmeticMean: {
-              probe_data->data_type = batprotocol::fb::ProbeData_AggregatedProbeData;
-              probe_data->aggregated_data = 0.0;
-              for (const auto & value : probe_data->vectorial_data)
-                probe_data->aggregated_data += value;
-              if (probe->resource_agregation_type == batprotocol::fb::ResourcesAggregationFunction_ArithmeticMean)
-                probe_data->aggregated_data /= probe->hosts.size();
-            } break;
-            default: {
-              xbt_assert(false, "unimplemented resource aggregation type");
-            } break;
-          };
-
-          msg->probes_data.emplace_back(probe_data);
-
-          if (!probe->periodic.is_infinite) {
+          if (!probe->is_periodic) {
+            XBT_INFO("One-shot trigger Probe(probe_id='%s') just issued its call!", probe->probe_id.c_str());
+            finished = true;
+          }
+          else if (!probe->periodic.is_infinite) {
             --probe->periodic.nb_periods;
             if (probe->periodic.nb_periods == 0) {
               XBT_INFO("Periodic trigger Probe(probe_id='%s') just issued its last call!", probe->probe_id.c_str());
-              need_reschedule = true;
-              probes.erase(probe->probe_id);
-              probe_it = slice.probes.erase(probe_it);
-              delete probe;
-              erased = true;
+              finished = true;
             }
           }
+
+          if (finished) {
+            probes.erase(probe->probe_id);
+            delete probe;
+          }
         }
-        if (!erased)
-          ++probe_it;
-      }
+        else
+          initialize_probe(probe);
+
+        if (!finished)
+          periodic = &probe->periodic;
+      } break;
+    }
+
+    // Periodic triggers fire again one period later, regardless of the other triggers
+    if (!finished) {
+      const uint64_t next_fire_time = trigger.fire_time + periodic->period;
+      xbt_assert(next_fire_time > trigger.fire_time, "integer overflow?!");
+      timeline.insert(trigger.type, trigger.id, next_fire_time);
+    }
+  }
+
+  // Triggers may fire without emitting anything (probes that are only initialized)
+  if (msg->calls.empty() && msg->probes_data.empty())
+    delete msg;
+  else
+    send_message("server", IPMessageType::PERIODIC_TRIGGER, static_cast<void*>(msg));
+}
+
+void periodic_main_actor(BatsimContext * context)
+{
+  auto mbox = simgrid::s4u::Mailbox::by_name("periodic");
+  bool die_received = false;
+  std::map<std::string, CallMeLaterMessage*> cml_triggers;
+  std::map<std::string, CreateProbeMessage*> probes;
+
+  // Each trigger is in the timeline at its next firing time (in ms), and is inserted back after each firing.
+  // Triggers are thus independent from each other: any period and offset are supported.
+  PeriodicTimeline timeline;
 
-      // Reset probes
-      for (auto * probe : slice.probes) {
-        probe->initialized = true;
-        xbt_assert(probe->data_accumulation_strategy == batprotocol::fb::ProbeDataAccumulationStrategy_ProbeDataAccumulation, "non-accumulative probes are not supported right now");
-        xbt_assert(probe->data_accumulation_reset_mode == batprotocol::fb::ResetMode_NoReset, "accumulative probes with reset are not implemented");
-        // TODO: implement reset
+  while (!die_received) {
+    // Wait for the next firing time while being able to receive a message from the server.
+    // If there is currently no triggers, just wait for a message without timeout.
+    IPMessage * message = nullptr;
+    bool fire_time_reached = false;
+    try {
+      if (timeline.empty())
+        message = mbox->get<IPMessage>();
+      else {
+        double current_time = simgrid::s4u::Engine::get_clock() * 1e3; // simgrid is in s, this module is in ms
+        double next_timeout_duration = (double)timeline.next_fire_time() - current_time;
+        if (next_timeout_duration <= 0)
+          fire_time_reached = true;
+        else
+          message = mbox->get<IPMessage>(next_timeout_duration * 1e-3); // this modules expresses everything in milliseconds
       }
+    }
+    catch (const simgrid::TimeoutException&) {
+      // The next firing time has been reached without receiving any message from the server
+      fire_time_reached = true;
+    }
 
-      send_message("server", IPMessageType::PERIODIC_TRIGGER, static_cast<void*>(msg));
+    if (fire_time_reached) {
+      fire_next_triggers(timeline, cml_triggers, probes);
+      continue;
     }
 
-    if (need_reschedule) {
-      generate_static_periodic_schedule(cml_triggers, probes, static_schedule, slice_duration);
+    // A message from the server has been received
+    switch(message->type) {
+      case IPMessageType::DIE: {
+        die_received = true;
+      } break;
+      case IPMessageType::SCHED_CALL_ME_LATER: {
+        auto msg = static_cast<CallMeLaterMessage*>(message->data);
+        message->data = nullptr;
+        auto it = cml_triggers.find(msg->call_id);
+        xbt_assert(it == cml_triggers.end(), "received a new CallMeLater with call_id='%s' while this call_id is already in use", msg->call_id.c_str());
+        xbt_assert(msg->periodic.is_infinite || msg->periodic.nb_periods >= 1, "invalid CallMeLater (call_id='%s'): finite but nb_periods=%u should be greater than 0", msg->call_id.c_str(), msg->periodic.nb_periods);
+        xbt_assert(msg->periodic.period > 0, "invalid CallMeLater (call_id='%s'): period should be greater than 0", msg->call_id.c_str());
+        set_periodic_in_ms(msg->periodic);
+        cml_triggers[msg->call_id] = msg;
+        timeline.insert(PeriodicTriggerType::CALL_ME_LATER, msg->call_id,
+          periodic_first_fire_time(msg->periodic.period, msg->periodic.offset, simgrid::s4u::Engine::get_clock() * 1e3));
+      } break;
+      case IPMessageType::SCHED_CREATE_PROBE: {
+        auto msg = static_cast<CreateProbeMessage*>(message->data);
+        message->data = nullptr;
+        msg->initialized = false;
+        auto it = probes.find(msg->probe_id);
+        xbt_assert(it == probes.end(), "received a new CreateProbe with probe_id='%s' while this probe_id is already in use", msg->probe_id.c_str());
+        prepare_probe(context, msg);
+        probes[msg->probe_id] = msg;
+
+        if (msg->is_periodic) {
+          xbt_assert(msg->periodic.is_infinite || msg->periodic.nb_periods >= 1, "invalid CreateProbe (probe_id='%s'): finite but nb_periods=%u should be greater than 0", msg->probe_id.c_str(), msg->periodic.nb_periods);
+          xbt_assert(msg->periodic.period > 0, "invalid CreateProbe (probe_id='%s'): period should be greater than 0", msg->probe_id.c_str());
+          set_periodic_in_ms(msg->periodic);
+          timeline.insert(PeriodicTriggerType::PROBE, msg->probe_id,
+            periodic_first_fire_time(msg->periodic.period, msg->periodic.offset, simgrid::s4u::Engine::get_clock() * 1e3));
+        }
+        else {
+          // One-shot probes accumulate data from their creation, and measure at their target time.
+          // The server measures the ones whose target time is already reached, so the target time is in the future.
+          initialize_probe(msg);
+          double target_time = msg->target_time;
+          if (msg->time_unit == batprotocol::fb::TimeUnit_Second)
+            target_time *= 1e3;
+          timeline.insert(PeriodicTriggerType::PROBE, msg->probe_id, (uint64_t)std::ceil(target_time));
+        }
+      } break;
+      case IPMessageType::SCHED_STOP_CALL_ME_LATER: {
+        auto msg = static_cast<StopCallMeLaterMessage*>(message->data);
+        message->data = nullptr;
+        auto it = cml_triggers.find(msg->call_id);
+        if (it == cml_triggers.end()) {
+          XBT_WARN("Received a StopCallMeLater on call_id='%s', but no such call is running", msg->call_id.c_str());
+        } else {
+          XBT_INFO("Stopping CallMeLater on call_id='%s'", msg->call_id.c_str());
+
+          auto * m = new PeriodicEntityStoppedMessage;
+          m->entity_id = msg->call_id;
+          m->is_probe = false;
+          m->is_call_me_later = true;
+          send_message("server", IPMessageType::PERIODIC_ENTITY_STOPPED, static_cast<void*>(m));
+
+          timeline.remove(PeriodicTriggerType::CALL_ME_LATER, msg->call_id);
+          delete it->second;
+          cml_triggers.erase(it);
+        }
+        delete msg;
+      } break;
+      case IPMessageType::SCHED_STOP_PROBE: {
+        auto msg = static_cast<StopProbeMessage*>(message->data);
+        message->data = nullptr;
+        auto it = probes.find(msg->probe_id);
+        if (it == probes.end()) {
+          XBT_WARN("Received a StopProbe on probe_id='%s', but no such probe is running", msg->probe_id.c_str());
+        } else {
+          XBT_INFO("Stopping probe with probe_id='%s'", msg->probe_id.c_str());
+
+          auto * m = new PeriodicEntityStoppedMessage;
+          m->entity_id = msg->probe_id;
+          m->is_probe = true;
+          m->is_call_me_later = false;
+          send_message("server", IPMessageType::PERIODIC_ENTITY_STOPPED, static_cast<void*>(m));
+
+          timeline.remove(PeriodicTriggerType::PROBE, msg->probe_id);
+          delete it->second;
+          probes.erase(it);
+        }
+        delete msg;
+      } break;
+      default: {
+        xbt_assert(false, "Unexpected message received: %s", ip_message_type_to_cstring(message->type));
+      } break;
     }
+    delete message;
   }
 }
@@ -5,26 +5,126 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <set>
 #include <string>
+#include <tuple>
+#include <utility>
 #include <vector>
-#include <map>
 
 #include "ipp.hpp"
 
 struct BatsimContext;
 
-struct TimeSlice
+enum class PeriodicTriggerType
 {
-  std::vector<CallMeLaterMessage*> cml_triggers;
-  std::vector<CreateProbeMessage*> probes;
-  double duration;
+  CALL_ME_LATER
+, PROBE
 };
 
-void generate_static_periodic_schedule(
-  const std::map<std::string, CallMeLaterMessage*> & cml_triggers,
-  const std::map<std::string, CreateProbeMessage*> & probes,
-  std::vector<TimeSlice> & schedule,
-  uint64_t & slice_duration
-);
+/**
+ * @brief Returns the first firing time of a periodic trigger created at a given time
+ * @details Triggers fire at times offset + k*period (k >= 0), and the first firing time is strictly after the creation time.
+ * @param[in] period The period of the trigger. Must be positive.
+ * @param[in] offset The offset of the trigger
+ * @param[in] creation_time The creation time of the trigger (in the same time unit as period and offset)
+ * @return The first firing time of the trigger
+ */
+uint64_t periodic_first_fire_time(uint64_t period, uint64_t offset, double creation_time);
+
+/**
+ * @brief Orders periodic triggers by their next firing time (min-heap with removal)
+ * @details Insertion, removal and popping are O(log n). Triggers that fire at the same time are popped
+ *          sorted by type (CallMeLater first) then by identifier.
+ */
+class PeriodicTimeline
+{
+public:
+  /**
+   * @brief A trigger of the timeline
+   */
+  struct Entry
+  {
+    uint64_t fire_time; //!< The time at which the trigger fires
+    PeriodicTriggerType type; //!< The type of the trigger
+    std::string id; //!< The identifier of the trigger (call_id or probe_id)
+
+    /**
+     * @brief Orders entries by firing time, then type, then identifier
+     * @param[in] other Another entry
+     * @return Whether this entry comes before the other one
+     */
+    bool operator<(const Entry & other) const
+    {
+      return std::tie(fire_time, type, id) < std::tie(other.fire_time, other.type, other.id);
+    }
+  };
+
+  /**
+   * @brief Inserts a trigger into the timeline
+   * @param[in] type The type of the trigger
+   * @param[in] id The identifier of the trigger. Must not be in the timeline already.
+   * @param[in] fire_time The time at which the trigger fires
+   */
+  void insert(PeriodicTriggerType type, const std::string & id, uint64_t fire_time);
+
+  /**
+   * @brief Removes a trigger from the timeline
+   * @param[in] type The type of the trigger
+   * @param[in] id The identifier of the trigger
+   * @return Whether the trigger was in the timeline
+   */
+  bool remove(PeriodicTriggerType type, const std::string & id);
+
+  /**
+   * @brief Returns whether the timeline is empty
+   * @return Whether the timeline is empty
+   */
+  bool empty() const { return _entries.empty(); }
+
+  /**
+   * @brief Returns the number of triggers in the timeline
+   * @return The number of triggers in the timeline
+   */
+  size_t size() const { return _entries.size(); }
+
+  /**
+   * @brief Returns the firing time of the next trigger. The timeline must not be empty.
+   * @return The firing time of the next trigger
+   */
+  uint64_t next_fire_time() const { return _entries.begin()->fire_time; }
+
+  /**
+   * @brief Removes all the triggers that fire at the next firing time from the timeline
+   * @param[out] entries The removed triggers, in timeline order
+   */
+  void pop_next(std::vector<Entry> & entries);
+
+private:
+  std::set<Entry> _entries; //!< The triggers, ordered by firing time
+  std::map<std::pair<PeriodicTriggerType, std::string>, uint64_t> _fire_times; //!< The firing time of each trigger
+};
+
+/**
+ * @brief Sums probed values
+ * @details The sum is computed with several independent partial sums so that it can be vectorized.
+ *          It may thus slightly differ from a sequential sum due to floating-point rounding.
+ * @param[in] values The values to sum
+ * @param[in] nb_values The number of values
+ * @return The sum of the values
+ */
+double sum_probed_values(const double * values, size_t nb_values);
+
+/**
+ * @brief Measures a one-shot probe right away, at the current simulation time
+ * @details This is used for one-shot probes whose target time is already reached when they are created.
+ *          The probe accumulates data from its creation, so accumulative probes with reset measure no consumption.
+ * @param[in] context The BatsimContext
+ * @param[in,out] probe The one-shot probe
+ * @return The measured probe data
+ */
+ProbeData * measure_oneshot_probe(BatsimContext * context, CreateProbeMessage * probe);
 
 void periodic_main_actor(BatsimContext * context);
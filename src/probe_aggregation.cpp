@@ -0,0 +1,106 @@
+/**
+ * @file probe_aggregation.cpp
+ * @brief Contains the temporal aggregation of the values measured by probes
+ */
+
+#include "probe_aggregation.hpp"
+
+#include <simgrid/s4u.hpp>
+
+using namespace std;
+
+void TemporalAggregator::reset(const TemporalAggregation & aggregation, size_t nb_resources)
+{
+    _aggregation = aggregation;
+    _nb_resources = nb_resources;
+    _nb_values = 0;
+
+    _states.clear();
+    _window_values.clear();
+    _window_rounds.clear();
+    _candidates_begin.clear();
+    _candidates_end.clear();
+
+    switch (_aggregation.type)
+    {
+    case TemporalAggregationType::NONE:
+        break;
+    case TemporalAggregationType::EXPONENTIAL_MOVING_AVERAGE:
+        xbt_assert(_aggregation.ema_alpha > 0 && _aggregation.ema_alpha <= 1,
+                   "Invalid exponential moving average weight (%g): must be in ]0,1]", _aggregation.ema_alpha);
+        _states.assign(_nb_resources, 0);
+        break;
+    case TemporalAggregationType::SLIDING_WINDOW_MEAN:
+        xbt_assert(_aggregation.window_size > 0, "Invalid sliding window size: must be positive");
+        _states.assign(_nb_resources, 0);
+        _window_values.assign(_aggregation.window_size * _nb_resources, 0);
+        break;
+    case TemporalAggregationType::SLIDING_WINDOW_MAX:
+        xbt_assert(_aggregation.window_size > 0, "Invalid sliding window size: must be positive");
+        _window_values.assign(_aggregation.window_size * _nb_resources, 0);
+        _window_rounds.assign(_aggregation.window_size * _nb_resources, 0);
+        _candidates_begin.assign(_nb_resources, 0);
+        _candidates_end.assign(_nb_resources, 0);
+        break;
+    }
+}
+
+void TemporalAggregator::add_values(double * values)
+{
+    const size_t round = _nb_values++;
+    const size_t window_size = _aggregation.window_size;
+
+    switch (_aggregation.type)
+    {
+    case TemporalAggregationType::NONE:
+        break;
+    case TemporalAggregationType::EXPONENTIAL_MOVING_AVERAGE:
+    {
+        // The first value initializes the average, so that it is not biased towards 0
+        const double alpha = (round == 0) ? 1 : _aggregation.ema_alpha;
+        for (size_t r = 0; r < _nb_resources; ++r)
+        {
+            _states[r] += alpha * (values[r] - _states[r]);
+            values[r] = _states[r];
+        }
+    } break;
+    case TemporalAggregationType::SLIDING_WINDOW_MEAN:
+    {
+        // The value of this round replaces the one that leaves the window in the ring buffer
+        double * slot = &_window_values[(round % window_size) * _nb_resources];
+        const size_t nb_values_in_window = min(round + 1, window_size);
+        for (size_t r = 0; r < _nb_resources; ++r)
+        {
+            _states[r] += values[r] - slot[r];
+            slot[r] = values[r];
+            values[r] = _states[r] / nb_values_in_window;
+        }
+    } break;
+    case TemporalAggregationType::SLIDING_WINDOW_MAX:
+    {
+        // Each resource keeps the values of the window that may still become the maximum, in decreasing order
+        for (size_t r = 0; r < _nb_resources; ++r)
+        {
+            size_t & begin = _candidates_begin[r];
+            size_t & end = _candidates_end[r];
+
+            // Candidates that leave the window are removed first, so that the new candidate always has a free slot
+            if (begin < end && _window_rounds[(begin % window_size) * _nb_resources + r] + window_size <= round)
+            {
+                ++begin;
+            }
+            while (begin < end && _window_values[((end - 1) % window_size) * _nb_resources + r] <= values[r])
+            {
+                --end;
+            }
+
+            const size_t index = (end % window_size) * _nb_resources + r;
+            _window_values[index] = values[r];
+            _window_rounds[index] = round;
+            ++end;
+
+            values[r] = _window_values[(begin % window_size) * _nb_resources + r];
+        }
+    } break;
+    }
+}
@@ -0,0 +1,77 @@
+/**
+ * @file probe_aggregation.hpp
+ * @brief Contains the temporal aggregation of the values measured by probes
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief The functions that aggregate the successive values measured on a resource
+ */
+enum class TemporalAggregationType
+{
+    NONE                        //!< Measured values are emitted as is
+   ,EXPONENTIAL_MOVING_AVERAGE  //!< The exponential moving average of the measured values
+   ,SLIDING_WINDOW_MEAN         //!< The mean of the last measured values
+   ,SLIDING_WINDOW_MAX          //!< The maximum of the last measured values
+};
+
+/**
+ * @brief Defines how the successive values measured by a probe are aggregated
+ */
+struct TemporalAggregation
+{
+    TemporalAggregationType type = TemporalAggregationType::NONE; //!< The aggregation function
+    double ema_alpha = 1; //!< For exponential moving averages, the weight of the last value (in ]0,1])
+    unsigned int window_size = 1; //!< For sliding windows, the number of values in the window (positive)
+};
+
+/**
+ * @brief Aggregates the successive values measured on each resource of a probe
+ * @details Each resource has its own state, stored contiguously for all resources.
+ *          Adding a value costs O(1) per resource (amortized for sliding maximums),
+ *          and the memory is O(window_size) per resource.
+ */
+class TemporalAggregator
+{
+public:
+    /**
+     * @brief Sets the aggregation function and the number of resources, and clears the aggregation state
+     * @param[in] aggregation The aggregation function
+     * @param[in] nb_resources The number of probed resources
+     */
+    void reset(const TemporalAggregation & aggregation, size_t nb_resources);
+
+    /**
+     * @brief Adds one value per resource and computes the aggregated values
+     * @param[in,out] values The values measured on each resource (nb_resources values), replaced by their aggregated values
+     */
+    void add_values(double * values);
+
+    /**
+     * @brief Returns whether the aggregator modifies the values it is given
+     * @return Whether the aggregation function is not NONE
+     */
+    bool is_enabled() const
+    {
+        return _aggregation.type != TemporalAggregationType::NONE;
+    }
+
+private:
+    TemporalAggregation _aggregation; //!< The aggregation function
+    size_t _nb_resources = 0; //!< The number of probed resources
+    size_t _nb_values = 0; //!< The number of values added to each resource so far
+
+    std::vector<double> _states; //!< The EMA or the sum of the window of each resource
+
+    // Ring buffers of window_size slots per resource, slot i of resource r being at index (i % window_size) * nb_resources + r
+    std::vector<double> _window_values; //!< The last values of each resource (sliding mean), or the decreasing candidates for the maximum (sliding max)
+    std::vector<size_t> _window_rounds; //!< For sliding maximums, the round at which each candidate was added
+
+    // For sliding maximums, the candidates of each resource form a deque within the ring buffer
+    std::vector<size_t> _candidates_begin; //!< The position of the first candidate of each resource
+    std::vector<size_t> _candidates_end; //!< The position after the last candidate of each resource
+};
@@ -26,31 +26,16 @@ Profiles::~Profiles()
     _profiles.clear();
 }
 
-void Profiles::load_from_json(const Document &doc, const string & filename)
+// Do NOT remove namespaces in the arguments (to avoid doxygen warnings)
+void Profiles::add_profile_from_json(const std::string & profile_name,
+                                     const rapidjson::Value & json_desc,
+                                     const std::string & error_prefix,
+                                     const std::string & filename)
 {
-    string error_prefix = "Invalid JSON file '" + filename + "'";
-
-    xbt_assert(doc.IsObject(), "%s: not a JSON object", error_prefix.c_str());
-    xbt_assert(doc.HasMember("profiles"), "%s: the 'profiles' object is missing",
-               error_prefix.c_str());
-    const Value & profiles = doc["profiles"];
-    xbt_assert(profiles.IsObject(), "%s: the 'profiles' member is not an object",
-               error_prefix.c_str());
-
-    for (Value::ConstMemberIterator it = profiles.MemberBegin(); it != profiles.MemberEnd(); ++it)
-    {
-        const Value & key = it->name;
-        const Value & value = it->value;
-
-        xbt_assert(key.IsString(), "%s: all children of the 'profiles' object must have a "
-                   "string key", error_prefix.c_str());
-        string profile_name = key.GetString();
-
-        auto profile = Profile::from_json(profile_name, value, error_prefix, true, filename);
-        xbt_assert(!exists(string(key.GetString())), "%s: duplication of profile name '%s'",
-                   error_prefix.c_str(), key.GetString());
-        _profiles[string(key.GetString())] = profile;
-    }
+    auto profile = Profile::from_json(profile_name, json_desc, error_prefix, true, filename);
+    xbt_assert(!exists(profile_name), "%s: duplication of profile name '%s'",
+               error_prefix.c_str(), profile_name.c_str());
+    _profiles[profile_name] = profile;
 }
 
 ProfilePtr Profiles::operator[](const std::string &profile_name)
@@ -214,11 +214,17 @@ public:
     ~Profiles();
 
     /**
-     * @brief Loads the profiles from a workload (a JSON document)
-     * @param[in] doc The JSON document
-     * @param[in] filename The name of the file from which the JSON document has been created (debug purpose)
+     * @brief Builds one profile from its JSON description and adds it into the Profiles
+     * @param[in] profile_name The name of the profile
+     * @param[in] json_desc The JSON description of the profile
+     * @param[in] error_prefix The prefix to display when an error occurs
+     * @param[in] filename The name of the file from which the profile has been read
+     * @pre No profile with the same name exists in the Profiles instance
      */
-    void load_from_json(const rapidjson::Document & doc, const std::string & filename);
+    void add_profile_from_json(const std::string & profile_name,
+                               const rapidjson::Value & json_desc,
+                               const std::string & error_prefix,
+                               const std::string & filename);
 
     /**
      * @brief Accesses one profile thanks to its name
@@ -0,0 +1,38 @@
+/**
+ * @file progress.cpp
+ * @brief Contains the sampling of per-event log lines and the periodic progress log lines
+ */
+
+#include "progress.hpp"
+
+#include <simgrid/s4u.hpp>
+
+using namespace std;
+
+XBT_LOG_NEW_DEFAULT_CATEGORY(progress, "progress"); //!< Logging
+
+void ProgressReporter::enable(double period)
+{
+    xbt_assert(period > 0, "Invalid progress reporting period (%g): must be positive", period);
+    _enabled = true;
+    _period = chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(period));
+    _last_report_time = chrono::steady_clock::now();
+}
+
+void ProgressReporter::report(std::chrono::steady_clock::time_point now, double simulated_time,
+                              int nb_submitted_jobs, int nb_completed_jobs, int nb_running_jobs)
+{
+    // Rates are computed over the last period, so that they reflect the current simulation speed
+    const double elapsed = chrono::duration<double>(now - _last_report_time).count();
+    const double completion_rate = (nb_completed_jobs - _last_nb_completed_jobs) / elapsed;
+    const double time_ratio = (simulated_time - _last_simulated_time) / elapsed;
+
+    XBT_INFO("Progress: simulated time=%g, jobs submitted=%d, completed=%d, running=%d, "
+             "%.1f jobs completed/s, simulated/wall-clock time ratio=%g",
+             simulated_time, nb_submitted_jobs, nb_completed_jobs, nb_running_jobs,
+             completion_rate, time_ratio);
+
+    _last_report_time = now;
+    _last_simulated_time = simulated_time;
+    _last_nb_completed_jobs = nb_completed_jobs;
+}
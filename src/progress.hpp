@@ -0,0 +1,124 @@
+/**
+ * @file progress.hpp
+ * @brief Contains the sampling of per-event log lines and the periodic progress log lines
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief The kinds of frequent simulation events whose log lines can be sampled
+ */
+enum class SampledLogEvent
+{
+    JOB                 //!< The lifecycle of a job (sampled at submission, see Job::is_logged)
+   ,MACHINE_SWITCH      //!< A machine is being switched on or off
+};
+
+//! The number of values of SampledLogEvent
+constexpr size_t NB_SAMPLED_LOG_EVENTS = static_cast<size_t>(SampledLogEvent::MACHINE_SWITCH) + 1;
+
+/**
+ * @brief Decides which log lines of frequent simulation events are written
+ * @details One event out of every period events of each kind is logged. A period of 1 (default) logs all events,
+ *          and a period of 0 logs none. Callers should check should_log before formatting their log lines,
+ *          so that the events that are not logged cost a counter increment.
+ *          Jobs are sampled once at submission, so that all the log lines of a sampled job are written.
+ */
+class LogSampler
+{
+public:
+    /**
+     * @brief Sets the sampling period
+     * @param[in] period One event out of period events of each kind is logged. 0 disables the logging of these events.
+     */
+    void set_period(unsigned int period)
+    {
+        _period = period;
+    }
+
+    /**
+     * @brief Returns whether the log lines of an event should be written
+     * @details Each call counts one event of the given kind.
+     * @param[in] event The kind of event
+     * @return Whether the log lines of the event should be written
+     */
+    bool should_log(SampledLogEvent event)
+    {
+        if (_period <= 1)
+        {
+            return _period == 1;
+        }
+        uint64_t & counter = _counters[static_cast<size_t>(event)];
+        return (counter++ % _period) == 0;
+    }
+
+private:
+    unsigned int _period = 1; //!< One event out of _period events of each kind is logged (none if 0)
+    std::array<uint64_t, NB_SAMPLED_LOG_EVENTS> _counters = {}; //!< The number of events of each kind so far
+};
+
+/**
+ * @brief Periodically logs aggregated progress information about the simulation (throughput, simulation speed)
+ * @details Reporting is disabled by default. Periods are measured in wall-clock time.
+ */
+class ProgressReporter
+{
+public:
+    /**
+     * @brief Enables progress reporting
+     * @param[in] period The minimum wall-clock duration (in seconds) between two progress lines. Must be positive.
+     */
+    void enable(double period);
+
+    /**
+     * @brief Returns whether progress reporting is enabled
+     * @return Whether progress reporting is enabled
+     */
+    bool is_enabled() const
+    {
+        return _enabled;
+    }
+
+    /**
+     * @brief Logs a progress line if the reporting period has elapsed since the last one
+     * @param[in] simulated_time The current simulated time
+     * @param[in] nb_submitted_jobs The number of jobs submitted so far
+     * @param[in] nb_completed_jobs The number of jobs completed so far
+     * @param[in] nb_running_jobs The number of jobs being executed
+     */
+    void update(double simulated_time, int nb_submitted_jobs, int nb_completed_jobs, int nb_running_jobs)
+    {
+        if (_enabled)
+        {
+            const auto now = std::chrono::steady_clock::now();
+            if (now - _last_report_time >= _period)
+            {
+                report(now, simulated_time, nb_submitted_jobs, nb_completed_jobs, nb_running_jobs);
+            }
+        }
+    }
+
+private:
+    /**
+     * @brief Logs a progress line
+     * @param[in] now The current wall-clock time
+     * @param[in] simulated_time The current simulated time
+     * @param[in] nb_submitted_jobs The number of jobs submitted so far
+     * @param[in] nb_completed_jobs The number of jobs completed so far
+     * @param[in] nb_running_jobs The number of jobs being executed
+     */
+    void report(std::chrono::steady_clock::time_point now, double simulated_time,
+                int nb_submitted_jobs, int nb_completed_jobs, int nb_running_jobs);
+
+private:
+    bool _enabled = false; //!< Whether progress reporting is enabled
+    std::chrono::steady_clock::duration _period = std::chrono::steady_clock::duration::zero(); //!< The minimum wall-clock duration between two progress lines
+    std::chrono::steady_clock::time_point _last_report_time; //!< The wall-clock time of the last progress line (or of enable)
+    double _last_simulated_time = 0; //!< The simulated time at the last progress line
+    int _last_nb_completed_jobs = 0; //!< The number of completed jobs at the last progress line
+};
@@ -372,6 +372,20 @@ CreateProbeMessage * from_create_probe(const batprotocol::fb::CreateProbeEvent *
 
     // Metrics
     msg->metrics = create_probe->metrics();
+    switch (create_probe->metrics()) {
+        case batprotocol::fb::Metrics_Power: {
+            msg->metric = ProbeMetric::POWER;
+        } break;
+        case batprotocol::fb::Metrics_Load: {
+            msg->metric = ProbeMetric::HOST_LOAD;
+        } break;
+        case batprotocol::fb::Metrics_Traffic: {
+            msg->metric = ProbeMetric::LINK_TRAFFIC;
+        } break;
+        default: {
+            xbt_assert(false, "invalid CreateProbe received: unsupported metrics");
+        } break;
+    }
 
     // Resources
     msg->resource_type = create_probe->resources_type();
@@ -467,6 +481,30 @@ CreateProbeMessage * from_create_probe(const batprotocol::fb::CreateProbeEvent *
 
     // Temporal aggregation
     msg->temporal_aggregation_type = create_probe->temporal_aggregation_function_type();
+    switch (create_probe->temporal_aggregation_function_type()) {
+        case batprotocol::fb::TemporalAggregationFunction_NONE: {
+            xbt_assert(false, "invalid CreateProbe received: temporal aggregation function is NONE");
+        } break;
+        case batprotocol::fb::TemporalAggregationFunction_NoTemporalAggregation: {
+            msg->temporal_aggregation.type = TemporalAggregationType::NONE;
+        } break;
+        case batprotocol::fb::TemporalAggregationFunction_ExponentialMovingAverage: {
+            msg->temporal_aggregation.type = TemporalAggregationType::EXPONENTIAL_MOVING_AVERAGE;
+            msg->temporal_aggregation.ema_alpha = create_probe->temporal_aggregation_function_as_ExponentialMovingAverage()->alpha();
+            xbt_assert(msg->temporal_aggregation.ema_alpha > 0 && msg->temporal_aggregation.ema_alpha <= 1,
+                "invalid CreateProbe received: exponential moving average's alpha (%g) is not in ]0,1]", msg->temporal_aggregation.ema_alpha);
+        } break;
+        case batprotocol::fb::TemporalAggregationFunction_SlidingWindowMean: {
+            msg->temporal_aggregation.type = TemporalAggregationType::SLIDING_WINDOW_MEAN;
+            msg->temporal_aggregation.window_size = create_probe->temporal_aggregation_function_as_SlidingWindowMean()->window_size();
+            xbt_assert(msg->temporal_aggregation.window_size > 0, "invalid CreateProbe received: sliding window mean's window size is 0");
+        } break;
+        case batprotocol::fb::TemporalAggregationFunction_SlidingWindowMax: {
+            msg->temporal_aggregation.type = TemporalAggregationType::SLIDING_WINDOW_MAX;
+            msg->temporal_aggregation.window_size = create_probe->temporal_aggregation_function_as_SlidingWindowMax()->window_size();
+            xbt_assert(msg->temporal_aggregation.window_size > 0, "invalid CreateProbe received: sliding window max's window size is 0");
+        } break;
+    }
 
     // Emission filtering policy
     msg->emission_filtering_policy = create_probe->emission_filtering_policy_type();
@@ -522,7 +560,7 @@ void parse_batprotocol_message(const uint8_t * buffer, uint32_t buffer_size, dou
             i, batprotocol::fb::EnumNamesEvent()[event_timestamp->event_type()], messages->at(i).timestamp, preceding_event_timestamp
         );
 
-        XBT_INFO("Parsing an event of type=%s", batprotocol::fb::EnumNamesEvent()[event_timestamp->event_type()]);
+        XBT_DEBUG("Parsing an event of type=%s", batprotocol::fb::EnumNamesEvent()[event_timestamp->event_type()]);
         using namespace batprotocol::fb;
         switch (event_timestamp->event_type())
         {
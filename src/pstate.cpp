@@ -28,16 +28,26 @@ void switch_on_machine_process(BatsimContext *context, int machine_id, int new_p
     int current_pstate = machine->host->get_pstate();
     int on_ps = machine->sleep_pstates[current_pstate]->switch_on_virtual_pstate;
 
-    XBT_INFO("Switching machine %d ('%s') ON. Passing in virtual pstate %d to do so", machine->id,
-             machine->name.c_str(), on_ps);
+    const bool log = context->log_sampler.should_log(SampledLogEvent::MACHINE_SWITCH);
+    if (log)
+    {
+        XBT_INFO("Switching machine %d ('%s') ON. Passing in virtual pstate %d to do so", machine->id,
+                 machine->name.c_str(), on_ps);
+    }
     machine->host->set_pstate(on_ps);
     //args->context->pstate_tracer.add_pstate_change(simgrid::s4u::Engine::get_clock(), machine->id, on_ps);
 
-    XBT_INFO("Computing 1 flop to simulate time & energy cost of switch ON");
+    if (log)
+    {
+        XBT_INFO("Computing 1 flop to simulate time & energy cost of switch ON");
+    }
     simgrid::s4u::this_actor::execute(1);
 
-    XBT_INFO("1 flop has been computed. Switching machine %d ('%s') to computing pstate %d",
-             machine->id, machine->name.c_str(), new_pstate);
+    if (log)
+    {
+        XBT_INFO("1 flop has been computed. Switching machine %d ('%s') to computing pstate %d",
+                 machine->id, machine->name.c_str(), new_pstate);
+    }
     machine->host->set_pstate(new_pstate);
     //args->context->pstate_tracer.add_pstate_change(simgrid::s4u::Engine::get_clock(), machine->id, pstate);
 
@@ -62,16 +72,26 @@ void switch_off_machine_process(BatsimContext * context, int machine_id, int new
 
     int off_ps = machine->sleep_pstates[new_pstate]->switch_off_virtual_pstate;
 
-    XBT_INFO("Switching machine %d ('%s') OFF. Passing in virtual pstate %d to do so", machine->id,
-             machine->name.c_str(), off_ps);
+    const bool log = context->log_sampler.should_log(SampledLogEvent::MACHINE_SWITCH);
+    if (log)
+    {
+        XBT_INFO("Switching machine %d ('%s') OFF. Passing in virtual pstate %d to do so", machine->id,
+                 machine->name.c_str(), off_ps);
+    }
     machine->host->set_pstate(off_ps);
     //args->context->pstate_tracer.add_pstate_change(simgrid::s4u::Engine::get_clock(), machine->id, off_ps);
 
-    XBT_INFO("Computing 1 flop to simulate time & energy cost of switch OFF");
+    if (log)
+    {
+        XBT_INFO("Computing 1 flop to simulate time & energy cost of switch OFF");
+    }
     simgrid::s4u::this_actor::execute(1);
 
-    XBT_INFO("1 flop has been computed. Switching machine %d ('%s') to sleeping pstate %d",
-             machine->id, machine->name.c_str(), new_pstate);
+    if (log)
+    {
+        XBT_INFO("1 flop has been computed. Switching machine %d ('%s') to sleeping pstate %d",
+                 machine->id, machine->name.c_str(), new_pstate);
+    }
     machine->host->set_pstate(new_pstate);
     //args->context->pstate_tracer.add_pstate_change(simgrid::s4u::Engine::get_clock(), machine->id, pstate);
 
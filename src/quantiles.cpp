@@ -0,0 +1,150 @@
+/**
+ * @file quantiles.cpp
+ * @brief Contains the streaming estimation of quantiles
+ */
+
+#include "quantiles.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <simgrid/s4u.hpp>
+
+using namespace std;
+
+TDigest::TDigest(double compression) :
+    _compression(compression),
+    _min(std::numeric_limits<double>::infinity()),
+    _max(-std::numeric_limits<double>::infinity())
+{
+    xbt_assert(compression >= 10, "Invalid t-digest compression (%g): must be at least 10", compression);
+}
+
+void TDigest::add(double value, double weight)
+{
+    if (std::isnan(value))
+    {
+        return;
+    }
+    xbt_assert(weight > 0, "Invalid t-digest weight (%g): must be positive", weight);
+
+    _buffer.push_back({value, weight});
+    _total_weight += weight;
+    _min = std::min(_min, value);
+    _max = std::max(_max, value);
+
+    // The buffer amortizes the sort of compress, while bounding memory
+    if (_buffer.size() >= static_cast<size_t>(5 * _compression))
+    {
+        compress();
+    }
+}
+
+void TDigest::merge(const TDigest & other)
+{
+    if (other._total_weight == 0)
+    {
+        return;
+    }
+
+    _buffer.insert(_buffer.end(), other._centroids.begin(), other._centroids.end());
+    _buffer.insert(_buffer.end(), other._buffer.begin(), other._buffer.end());
+    _total_weight += other._total_weight;
+    _min = std::min(_min, other._min);
+    _max = std::max(_max, other._max);
+    compress();
+}
+
+double TDigest::quantile(double q)
+{
+    xbt_assert(q >= 0 && q <= 1, "Invalid quantile (%g): must be in [0,1]", q);
+    compress();
+
+    if (_centroids.empty())
+    {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    if (_centroids.size() == 1)
+    {
+        return _centroids[0].mean;
+    }
+
+    // Values are interpolated between the centers of successive centroids,
+    // and between the extreme values and the centers of the extreme centroids
+    const double target = q * _total_weight;
+    const Centroid & first = _centroids.front();
+    if (target < first.weight / 2)
+    {
+        return _min + (first.mean - _min) * target / (first.weight / 2);
+    }
+
+    double center = first.weight / 2;
+    for (size_t i = 1; i < _centroids.size(); ++i)
+    {
+        const Centroid & previous = _centroids[i-1];
+        const Centroid & current = _centroids[i];
+        const double next_center = center + previous.weight / 2 + current.weight / 2;
+        if (target < next_center)
+        {
+            return previous.mean + (current.mean - previous.mean) * (target - center) / (next_center - center);
+        }
+        center = next_center;
+    }
+
+    const Centroid & last = _centroids.back();
+    const double remaining = _total_weight - center;
+    return last.mean + (_max - last.mean) * std::min(1.0, (target - center) / remaining);
+}
+
+size_t TDigest::nb_centroids()
+{
+    compress();
+    return _centroids.size();
+}
+
+void TDigest::compress()
+{
+    if (_buffer.empty())
+    {
+        return;
+    }
+
+    _buffer.insert(_buffer.end(), _centroids.begin(), _centroids.end());
+    std::sort(_buffer.begin(), _buffer.end(), [](const Centroid & a, const Centroid & b) { return a.mean < b.mean; });
+    _centroids.clear();
+
+    // Greedily merge successive centroids while the merged centroid stays within one unit of the scale function
+    Centroid current = _buffer[0];
+    double weight_before = 0;
+    double q_limit = inverse_scale(scale(0) + 1) * _total_weight;
+    for (size_t i = 1; i < _buffer.size(); ++i)
+    {
+        const Centroid & next = _buffer[i];
+        if (weight_before + current.weight + next.weight <= q_limit)
+        {
+            current.weight += next.weight;
+            current.mean += (next.mean - current.mean) * next.weight / current.weight;
+        }
+        else
+        {
+            weight_before += current.weight;
+            _centroids.push_back(current);
+            current = next;
+            q_limit = inverse_scale(scale(weight_before / _total_weight) + 1) * _total_weight;
+        }
+    }
+    _centroids.push_back(current);
+    _buffer.clear();
+}
+
+double TDigest::scale(double q) const
+{
+    return _compression / (2 * M_PI) * std::asin(2 * q - 1);
+}
+
+double TDigest::inverse_scale(double k) const
+{
+    const double angle = std::min(k * 2 * M_PI / _compression, M_PI / 2);
+    return (std::sin(angle) + 1) / 2;
+}
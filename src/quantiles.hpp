@@ -0,0 +1,95 @@
+/**
+ * @file quantiles.hpp
+ * @brief Contains the streaming estimation of quantiles
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Estimates the quantiles of a stream of values in bounded memory (merging t-digest)
+ * @details Values are summarized into weighted centroids, which are small near the extreme quantiles
+ *          and larger around the median. Estimations are thus very accurate for quantiles such as p99.
+ *          Two digests can be merged, e.g., to compute global quantiles from per-workload digests.
+ */
+class TDigest
+{
+public:
+    /**
+     * @brief Creates an empty TDigest
+     * @param[in] compression Bounds the number of centroids (about compression/2 once compressed).
+     *                        Higher values make estimations more accurate but use more memory.
+     */
+    explicit TDigest(double compression = 100);
+
+    /**
+     * @brief Adds a value into the digest
+     * @param[in] value The value. NaN values are ignored.
+     * @param[in] weight The weight of the value (how many times the value has been observed)
+     */
+    void add(double value, double weight = 1);
+
+    /**
+     * @brief Adds all the values summarized by another digest into this digest
+     * @param[in] other The other digest
+     */
+    void merge(const TDigest & other);
+
+    /**
+     * @brief Estimates a quantile of the values added so far
+     * @param[in] q The quantile, in [0,1] (e.g., 0.99 for p99)
+     * @return The estimated quantile, or NaN if no value has been added
+     */
+    double quantile(double q);
+
+    /**
+     * @brief Returns the total weight of the values added so far
+     * @return The total weight of the values added so far
+     */
+    double count() const { return _total_weight; }
+
+    /**
+     * @brief Returns the number of centroids currently stored, once compressed
+     * @return The number of centroids currently stored
+     */
+    size_t nb_centroids();
+
+private:
+    /**
+     * @brief A weighted summary of close values
+     */
+    struct Centroid
+    {
+        double mean;    //!< The mean of the summarized values
+        double weight;  //!< The total weight of the summarized values
+    };
+
+    /**
+     * @brief Merges the buffered values into the centroids
+     */
+    void compress();
+
+    /**
+     * @brief The scale function, which maps a quantile to the index of its centroid
+     * @param[in] q The quantile
+     * @return The (real) index of the centroid that contains the quantile
+     */
+    double scale(double q) const;
+
+    /**
+     * @brief The inverse of the scale function
+     * @param[in] k The (real) index of a centroid
+     * @return The quantile at which the centroid starts
+     */
+    double inverse_scale(double k) const;
+
+private:
+    double _compression; //!< Bounds the number of centroids
+    double _total_weight = 0; //!< The total weight of the added values
+    double _min; //!< The minimum added value
+    double _max; //!< The maximum added value
+    std::vector<Centroid> _centroids; //!< The centroids, sorted by mean
+    std::vector<Centroid> _buffer; //!< The values added since the last compression
+};
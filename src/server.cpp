@@ -5,6 +5,7 @@
 
 #include "server.hpp"
 
+#include <array>
 #include <chrono>
 #include <string>
 #include <set>
@@ -16,6 +17,7 @@
 #include <simgrid/s4u.hpp>
 
 #include "context.hpp"
+#include "edc_record.hpp"
 #include "ipp.hpp"
 #include "jobs_execution.hpp"
 #include "periodic.hpp"
@@ -24,6 +26,53 @@ XBT_LOG_NEW_DEFAULT_CATEGORY(server, "server"); //!< Logging
 
 using namespace std;
 
+//! The function type of the server message handlers
+typedef void (*ServerMessageHandler)(ServerData *, IPMessage *);
+
+/**
+ * @brief Builds the table that associates each IPMessageType with the server handler that reacts to it
+ * @return The handler table, indexed by IPMessageType. Types the server cannot handle are associated with nullptr.
+ */
+static constexpr std::array<ServerMessageHandler, NB_IP_MESSAGE_TYPES> make_server_handler_table()
+{
+    std::array<ServerMessageHandler, NB_IP_MESSAGE_TYPES> table {};
+    auto set = [&table](IPMessageType type, ServerMessageHandler handler) { table[static_cast<size_t>(type)] = handler; };
+
+    set(IPMessageType::JOB_SUBMITTED, server_on_job_submitted);
+    set(IPMessageType::JOB_REGISTERED_BY_DP, server_on_register_job);
+    set(IPMessageType::PROFILE_REGISTERED_BY_DP, server_on_register_profile);
+    set(IPMessageType::JOB_COMPLETED, server_on_job_completed);
+    set(IPMessageType::PSTATE_MODIFICATION, server_on_pstate_modification);
+    set(IPMessageType::SCHED_EXECUTE_JOB, server_on_execute_job);
+    set(IPMessageType::SCHED_CHANGE_JOB_STATE, server_on_change_job_state);
+    set(IPMessageType::SCHED_HELLO, server_on_edc_hello);
+    set(IPMessageType::SCHED_REJECT_JOB, server_on_reject_job);
+    set(IPMessageType::SCHED_KILL_JOBS, server_on_kill_jobs);
+    set(IPMessageType::SCHED_CREATE_PROBE, server_on_create_probe);
+    set(IPMessageType::SCHED_STOP_PROBE, server_on_stop_probe);
+    set(IPMessageType::SCHED_CALL_ME_LATER, server_on_call_me_later);
+    set(IPMessageType::SCHED_STOP_CALL_ME_LATER, server_on_stop_call_me_later);
+    set(IPMessageType::SCHED_TELL_ME_ENERGY, server_on_sched_tell_me_energy);
+    set(IPMessageType::SCHED_WAIT_ANSWER, server_on_sched_wait_answer);
+    set(IPMessageType::WAIT_QUERY, server_on_wait_query);
+    set(IPMessageType::SCHED_READY, server_on_sched_ready);
+    set(IPMessageType::ONESHOT_REQUESTED_CALL, server_on_oneshot_requested_call);
+    set(IPMessageType::PERIODIC_TRIGGER, server_on_periodic_trigger);
+    set(IPMessageType::PERIODIC_ENTITY_STOPPED, server_on_periodic_entity_stopped);
+    set(IPMessageType::KILLING_DONE, server_on_killing_done);
+    set(IPMessageType::SUBMITTER_HELLO, server_on_submitter_hello);
+    set(IPMessageType::SUBMITTER_BYE, server_on_submitter_bye);
+    set(IPMessageType::SWITCHED_ON, server_on_switched);
+    set(IPMessageType::SWITCHED_OFF, server_on_switched);
+    set(IPMessageType::END_DYNAMIC_REGISTER, server_on_end_dynamic_register);
+    set(IPMessageType::EVENT_OCCURRED, server_on_event_occurred);
+
+    return table;
+}
+
+//! The server handlers, indexed by IPMessageType. Built at compile time.
+static constexpr std::array<ServerMessageHandler, NB_IP_MESSAGE_TYPES> server_handler_table = make_server_handler_table();
+
 void server_process(BatsimContext * context)
 {
     ServerData * data = new ServerData;
@@ -35,37 +84,6 @@ void server_process(BatsimContext * context)
     context->proto_msg_builder->add_batsim_hello("TODO");
     finish_message_and_call_edc(data);
 
-    // Prepare a handler map to react to events
-    std::map<IPMessageType, std::function<void(ServerData *, IPMessage *)>> handler_map;
-    handler_map[IPMessageType::JOB_SUBMITTED] = server_on_job_submitted;
-    handler_map[IPMessageType::JOB_REGISTERED_BY_DP] = server_on_register_job;
-    handler_map[IPMessageType::PROFILE_REGISTERED_BY_DP] = server_on_register_profile;
-    handler_map[IPMessageType::JOB_COMPLETED] = server_on_job_completed;
-    handler_map[IPMessageType::PSTATE_MODIFICATION] = server_on_pstate_modification;
-    handler_map[IPMessageType::SCHED_EXECUTE_JOB] = server_on_execute_job;
-    handler_map[IPMessageType::SCHED_CHANGE_JOB_STATE] = server_on_change_job_state;
-    handler_map[IPMessageType::SCHED_HELLO] = server_on_edc_hello;
-    handler_map[IPMessageType::SCHED_REJECT_JOB] = server_on_reject_job;
-    handler_map[IPMessageType::SCHED_KILL_JOBS] = server_on_kill_jobs;
-    handler_map[IPMessageType::SCHED_CREATE_PROBE] = server_on_create_probe;
-    handler_map[IPMessageType::SCHED_STOP_PROBE] = server_on_stop_probe;
-    handler_map[IPMessageType::SCHED_CALL_ME_LATER] = server_on_call_me_later;
-    handler_map[IPMessageType::SCHED_STOP_CALL_ME_LATER] = server_on_stop_call_me_later;
-    handler_map[IPMessageType::SCHED_TELL_ME_ENERGY] = server_on_sched_tell_me_energy;
-    handler_map[IPMessageType::SCHED_WAIT_ANSWER] = server_on_sched_wait_answer;
-    handler_map[IPMessageType::WAIT_QUERY] = server_on_wait_query;
-    handler_map[IPMessageType::SCHED_READY] = server_on_sched_ready;
-    handler_map[IPMessageType::ONESHOT_REQUESTED_CALL] = server_on_oneshot_requested_call;
-    handler_map[IPMessageType::PERIODIC_TRIGGER] = server_on_periodic_trigger;
-    handler_map[IPMessageType::PERIODIC_ENTITY_STOPPED] = server_on_periodic_entity_stopped;
-    handler_map[IPMessageType::KILLING_DONE] = server_on_killing_done;
-    handler_map[IPMessageType::SUBMITTER_HELLO] = server_on_submitter_hello;
-    handler_map[IPMessageType::SUBMITTER_BYE] = server_on_submitter_bye;
-    handler_map[IPMessageType::SWITCHED_ON] = server_on_switched;
-    handler_map[IPMessageType::SWITCHED_OFF] = server_on_switched;
-    handler_map[IPMessageType::END_DYNAMIC_REGISTER] = server_on_end_dynamic_register;
-    handler_map[IPMessageType::EVENT_OCCURRED] = server_on_event_occurred;
-
     /* Currently, there is one job submtiter per input file (workload or workflow).
        As workflows use an inner workload, calling nb_static_workloads() should
        be enough. The dynamic job submitter (from the decision process) is not part
@@ -89,18 +107,24 @@ void server_process(BatsimContext * context)
         // Wait and receive a message from a node or the request-reply process...
         IPMessage * message = receive_message("server");
         XBT_DEBUG("Server received a message of type %s:",
-                 ip_message_type_to_string(message->type).c_str());
+                 ip_message_type_to_cstring(message->type));
 
         // Handle the message
-        xbt_assert(handler_map.count(message->type) == 1,
+        ServerMessageHandler handler_function = server_handler_table[static_cast<size_t>(message->type)];
+        xbt_assert(handler_function != nullptr,
                    "The server does not know how to handle message type %s.",
-                   ip_message_type_to_string(message->type).c_str());
-        auto handler_function = handler_map[message->type];
-        handler_function(data, message);
+                   ip_message_type_to_cstring(message->type));
+        {
+            ProfilingScope profiling_scope(context->server_profiler.handler_counter(message->type));
+            handler_function(data, message);
+        }
 
         // Delete the message
         delete message;
 
+        context->progress_reporter.update(simgrid::s4u::Engine::get_clock(), data->nb_submitted_jobs,
+                                          data->nb_completed_jobs, data->nb_running_jobs);
+
         // Let's send a message to the scheduler if needed
         if (data->sched_ready &&                     // The scheduler must be ready
             !data->end_of_simulation_ack_received && // The simulation must NOT be finished
@@ -161,11 +185,13 @@ void finish_message_and_call_edc(ServerData * data)
     auto context = data->context;
 
     // finalize the message and serialize it
-    context->proto_msg_builder->finish_message(simgrid::s4u::Engine::get_clock());
-
     uint8_t * what_happened_buffer = nullptr;
     uint32_t what_happened_buffer_size = 0u;
-    batprotocol::serialize_message(*context->proto_msg_builder, context->edc_json_format, (const uint8_t**)&what_happened_buffer, &what_happened_buffer_size);
+    {
+        ProfilingScope profiling_scope(context->server_profiler.phase_counter(ServerPhase::SERIALIZE));
+        context->proto_msg_builder->finish_message(simgrid::s4u::Engine::get_clock());
+        batprotocol::serialize_message(*context->proto_msg_builder, context->edc_json_format, (const uint8_t**)&what_happened_buffer, &what_happened_buffer_size);
+    }
 
     // call the external decision component
     uint8_t * decisions_buffer = nullptr;
@@ -185,9 +211,18 @@ void finish_message_and_call_edc(ServerData * data)
         long double elapsed_microseconds = static_cast<long double>(chrono::duration <long double, micro> (end - start).count());
         context->microseconds_used_by_scheduler += elapsed_microseconds;
 
+        // The EDC call is already timed, no need to read the clock again
+        ProfilingCounter * edc_call_counter = context->server_profiler.phase_counter(ServerPhase::EDC_CALL);
+        if (edc_call_counter != nullptr)
+        {
+            edc_call_counter->elapsed += end - start;
+            ++edc_call_counter->nb_calls;
+        }
+
         if (context->edc_json_format)
         {
-            XBT_INFO("Received '%s'", (char *)decisions_buffer);
+            // ZeroMQ messages are not null-terminated
+            XBT_INFO("Received '%.*s'", static_cast<int>(decisions_buffer_size), (char *)decisions_buffer);
         }
     }
     catch(const std::runtime_error & error)
@@ -204,10 +239,23 @@ void finish_message_and_call_edc(ServerData * data)
         throw runtime_error("Execution aborted (communication with external decision component failed)");
     }
 
+    if (context->edc_recorder != nullptr)
+    {
+        context->edc_recorder->record(what_happened_buffer, what_happened_buffer_size, decisions_buffer, decisions_buffer_size);
+    }
+
     // parse the decisions and store them in an inter-actor message list
     double now = -1;
     std::shared_ptr<std::vector<IPMessageWithTimestamp> > messages(new std::vector<IPMessageWithTimestamp>());
-    protocol::parse_batprotocol_message(decisions_buffer, decisions_buffer_size, now, messages, context);
+    {
+        ProfilingScope profiling_scope(context->server_profiler.phase_counter(ServerPhase::PARSE));
+        protocol::parse_batprotocol_message(decisions_buffer, decisions_buffer_size, now, messages, context);
+
+        // the decisions have been copied into inter-actor messages, their buffer is no longer needed
+        context->edc->release_decisions();
+    }
+
+    ProfilingScope profiling_scope(context->server_profiler.phase_counter(ServerPhase::INJECT));
 
     // the what_happened buffer is no longer needed, the associated MessageBuilder can be cleared
     context->proto_msg_builder->clear(simgrid::s4u::Engine::get_clock());
@@ -313,8 +361,11 @@ void server_on_job_completed(ServerData * data,
     xbt_assert(data->nb_completed_jobs + data->nb_running_jobs <= data->nb_submitted_jobs, "inconsistency: nb_completed_jobs + nb_running_jobs > nb_submitted_jobs");
     auto job = message->job;
 
-    XBT_INFO("Job %s has COMPLETED. %d jobs completed so far",
-             job->id.to_cstring(), data->nb_completed_jobs);
+    if (job->is_logged)
+    {
+        XBT_INFO("Job %s has COMPLETED. %d jobs completed so far",
+                 job->id.to_cstring(), data->nb_completed_jobs);
+    }
 
     data->context->proto_msg_builder->set_current_time(simgrid::s4u::Engine::get_clock());
     data->context->proto_msg_builder->add_job_completed(
@@ -359,7 +410,11 @@ void server_on_job_submitted(ServerData * data,
         // Update control information
         job->state = JobState::JOB_STATE_SUBMITTED;
         ++data->nb_submitted_jobs;
-        XBT_INFO("Job %s SUBMITTED. %d jobs submitted so far", job->id.to_cstring(), data->nb_submitted_jobs);
+        job->is_logged = data->context->log_sampler.should_log(SampledLogEvent::JOB);
+        if (job->is_logged)
+        {
+            XBT_INFO("Job %s SUBMITTED. %d jobs submitted so far", job->id.to_cstring(), data->nb_submitted_jobs);
+        }
 
         data->context->proto_msg_builder->set_current_time(simgrid::s4u::Engine::get_clock());
         data->context->proto_msg_builder->add_job_submitted(job->id.to_string(), protocol::to_job(*job), simgrid::s4u::Engine::get_clock());
@@ -514,10 +569,14 @@ void server_on_pstate_modification(ServerData * data,
         {
             if (machine->pstates[message->new_pstate] == PStateType::COMPUTATION_PSTATE)
             {
-                XBT_INFO("Switching machine %d ('%s') pstate : %d -> %d.", machine->id,
-                         machine->name.c_str(), curr_pstate, message->new_pstate);
+                if (data->context->log_sampler.should_log(SampledLogEvent::MACHINE_SWITCH))
+                {
+                    XBT_INFO("Switching machine %d ('%s') pstate : %d -> %d.", machine->id,
+                             machine->name.c_str(), curr_pstate, message->new_pstate);
+                }
                 machine->host->set_pstate(message->new_pstate);
                 xbt_assert(machine->host->get_pstate() == message->new_pstate, "pstate inconsistency: the desired pstate has not been set");
+                data->context->machines.invalidate_machine_energy(machine);
 
                 IntervalSet all_switched_machines;
                 if (data->context->current_switches.mark_switch_as_done(machine->id, message->new_pstate,
@@ -585,6 +644,45 @@ void server_on_oneshot_requested_call(ServerData * data,
     data->context->proto_msg_builder->add_requested_call(msg.call_id, msg.is_last_periodic_call);
 }
 
+/**
+ * @brief Adds the ProbeDataEmitted event of some probe data to the message that will be sent to the EDC
+ * @param[in,out] data The data associated with the server actor
+ * @param[in,out] probe_data The probe data. Its vectorial data is moved into the event.
+ */
+static void add_probe_data_emitted(ServerData * data, ProbeData * probe_data)
+{
+    std::shared_ptr<batprotocol::ProbeData> pdata;
+    switch (probe_data->data_type) {
+        case batprotocol::fb::ProbeData_VectorialProbeData: {
+            pdata = batprotocol::ProbeData::make_vectorial(std::make_shared<std::vector<double>>(std::move(probe_data->vectorial_data)));
+        } break;
+        case batprotocol::fb::ProbeData_AggregatedProbeData: {
+            pdata = batprotocol::ProbeData::make_aggregated(probe_data->aggregated_data);
+        } break;
+        default: {
+            xbt_assert(false, "unimplemented probe data type");
+        } break;
+    }
+
+    const ProbeDescription & description = *probe_data->description;
+    switch(description.resource_type) {
+        case batprotocol::fb::Resources_HostResources: {
+            pdata->set_resources_as_hosts(description.hosts_str);
+        } break;
+        case batprotocol::fb::Resources_LinkResources: {
+            pdata->set_resources_as_links(description.links);
+        } break;
+        default: {
+            xbt_assert(false, "unimplemented probe resource type");
+        } break;
+    }
+
+    data->context->proto_msg_builder->add_probe_data_emitted(
+        description.probe_id, description.metrics, pdata,
+        probe_data->manually_triggered, probe_data->nb_emitted, probe_data->nb_triggered
+    );
+}
+
 void server_on_periodic_trigger(ServerData * data,
                                 IPMessage * task_data)
 {
@@ -603,35 +701,7 @@ void server_on_periodic_trigger(ServerData * data,
         if (probe_data->is_last_periodic)
             --data->nb_probe_entities;
 
-        std::shared_ptr<batprotocol::ProbeData> pdata;
-        switch (probe_data->data_type) {
-            case batprotocol::fb::ProbeData_VectorialProbeData: {
-                pdata = batprotocol::ProbeData::make_vectorial(std::make_shared<std::vector<double>>(std::move(probe_data->vectorial_data)));
-            } break;
-            case batprotocol::fb::ProbeData_AggregatedProbeData: {
-                pdata = batprotocol::ProbeData::make_aggregated(probe_data->aggregated_data);
-            } break;
-            default: {
-                xbt_assert(false, "unimplemented probe data type");
-            } break;
-        }
-
-        switch(probe_data->resource_type) {
-            case batprotocol::fb::Resources_HostResources: {
-                pdata->set_resources_as_hosts(probe_data->hosts.to_string_hyphen());
-            } break;
-            case batprotocol::fb::Resources_LinkResources: {
-                pdata->set_resources_as_links(std::make_shared<std::vector<std::string> >(std::move(probe_data->links)));
-            } break;
-            default: {
-                xbt_assert(false, "unimplemented probe resource type");
-            } break;
-        }
-
-        data->context->proto_msg_builder->add_probe_data_emitted(
-            probe_data->probe_id, probe_data->metrics, pdata,
-            probe_data->manually_triggered, probe_data->nb_emitted, probe_data->nb_triggered
-        );
+        add_probe_data_emitted(data, probe_data);
     }
 }
 
@@ -824,9 +894,12 @@ void server_on_change_job_state(ServerData * data,
     }
     auto job = data->context->workloads.job_at(message->job_id);
 
-    XBT_INFO("Change job state: Job %s to state %s",
-             job->id.to_cstring(),
-             message->job_state.c_str());
+    if (job->is_logged)
+    {
+        XBT_INFO("Change job state: Job %s to state %s",
+                 job->id.to_cstring(),
+                 message->job_state.c_str());
+    }
 
     JobState new_state = job_state_from_string(message->job_state);
 
@@ -898,7 +971,10 @@ void server_on_reject_job(ServerData * data,
     job->state = JobState::JOB_STATE_REJECTED;
     data->nb_completed_jobs++;
 
-    XBT_INFO("Job '%s' has been rejected", job->id.to_cstring());
+    if (job->is_logged)
+    {
+        XBT_INFO("Job '%s' has been rejected", job->id.to_cstring());
+    }
 
     data->context->jobs_tracer.write_job(job);
     data->jobs_to_be_deleted.push_back(message->job->id);
@@ -944,11 +1020,33 @@ void server_on_create_probe(ServerData * data,
                             IPMessage * task_data)
 {
     xbt_assert(task_data->data != nullptr, "inconsistency: task_data has null data");
+
     auto * message = static_cast<CreateProbeMessage *>(task_data->data);
 
+    // One-shot probes whose target time is already reached are measured right away, and emit their data in the reply to the current message
+    if (!message->is_periodic)
+    {
+        double target_time = message->target_time;
+        if (message->time_unit == batprotocol::fb::TimeUnit_Millisecond)
+            target_time /= 1e3;
+
+        const double now = simgrid::s4u::Engine::get_clock();
+        if (target_time <= now)
+        {
+            ProbeData * probe_data = measure_oneshot_probe(data->context, message);
+            data->context->proto_msg_builder->set_current_time(now);
+            add_probe_data_emitted(data, probe_data);
+
+            delete probe_data;
+            delete message;
+            task_data->data = nullptr;
+            return;
+        }
+    }
+
     ++data->nb_probe_entities;
 
-    xbt_assert(message->is_periodic, "non-periodic probes are not implemented");
+    // The other probes are managed by the periodic actor, which owns the measurement state of probes
     send_message("periodic", IPMessageType::SCHED_CREATE_PROBE, task_data->data);
 }
 
@@ -1014,10 +1112,15 @@ void server_on_execute_job(ServerData * data,
     data->nb_running_jobs++;
     xbt_assert(data->nb_running_jobs <= data->nb_submitted_jobs, "inconsistency: nb_running_jobs > nb_submitted_jobs");
 
+    const Machines & machines = data->context->machines;
+
     // Check that the allocated hosts have the right permissions.
+    // Only machines that compute jobs are concerned, and those are either computing or unavailable.
     if (!data->context->allow_compute_sharing || !data->context->allow_storage_sharing)
     {
-        for (auto machine_id_it = allocation->hosts.elements_begin(); machine_id_it != allocation->hosts.elements_end(); ++machine_id_it)
+        const IntervalSet busy_allocated_machines = allocation->hosts & (machines.machines_in_state(MachineState::COMPUTING) +
+                                                                         machines.machines_in_state(MachineState::UNAVAILABLE));
+        for (auto machine_id_it = busy_allocated_machines.elements_begin(); machine_id_it != busy_allocated_machines.elements_end(); ++machine_id_it)
         {
             int machine_id = *machine_id_it;
             const Machine * machine = data->context->machines[machine_id];
@@ -1047,30 +1150,37 @@ void server_on_execute_job(ServerData * data,
     }
 
     // Check that every machine can compute the job
-    for (auto machine_id_it = allocation->hosts.elements_begin(); machine_id_it != allocation->hosts.elements_end(); ++machine_id_it)
+    const IntervalSet unable_allocated_machines = allocation->hosts - (machines.machines_in_state(MachineState::COMPUTING) +
+                                                                        machines.machines_in_state(MachineState::IDLE));
+    if (unable_allocated_machines.size() > 0)
     {
-        int machine_id = *machine_id_it;
-        Machine * machine = data->context->machines[machine_id];
-
-        xbt_assert(machine->state == MachineState::COMPUTING || machine->state == MachineState::IDLE,
+        const Machine * machine = machines[unable_allocated_machines.first_element()];
+        (void) machine; // Avoids a warning if assertions are ignored
+        xbt_assert(false,
                    "Job '%s': Invalid job allocation ('%s'): machine %d (hostname='%s') cannot compute jobs now "
                    "(the machine is not computing nor idle, its state is '%s')",
                    job->id.to_cstring(),
                    allocation->hosts.to_string_hyphen().c_str(),
                    machine->id, machine->name.c_str(),
                    machine_state_to_string(machine->state).c_str());
+    }
 
-        if (data->context->energy_used)
-        {
+    if (data->context->energy_used)
+    {
         // Check that every machine is in a computation pstate
-        int ps = machine->host->get_pstate();
-        (void) ps; // Avoids a warning if assertions are ignored
-        xbt_assert(machine->has_pstate(ps), "machine %d has no pstate %d", machine_id, ps);
-        xbt_assert(machine->pstates[ps] == PStateType::COMPUTATION_PSTATE,
-                   "Job '%s': Invalid job allocation ('%s'): machine %d (hostname='%s') is not in a computation pstate (ps=%d)",
-                   job->id.to_cstring(),
-                   allocation->hosts.to_string_hyphen().c_str(),
-                   machine->id, machine->name.c_str(), ps);
+        for (auto machine_id_it = allocation->hosts.elements_begin(); machine_id_it != allocation->hosts.elements_end(); ++machine_id_it)
+        {
+            int machine_id = *machine_id_it;
+            Machine * machine = data->context->machines[machine_id];
+
+            int ps = machine->host->get_pstate();
+            (void) ps; // Avoids a warning if assertions are ignored
+            xbt_assert(machine->has_pstate(ps), "machine %d has no pstate %d", machine_id, ps);
+            xbt_assert(machine->pstates[ps] == PStateType::COMPUTATION_PSTATE,
+                       "Job '%s': Invalid job allocation ('%s'): machine %d (hostname='%s') is not in a computation pstate (ps=%d)",
+                       job->id.to_cstring(),
+                       allocation->hosts.to_string_hyphen().c_str(),
+                       machine->id, machine->name.c_str(), ps);
         }
     }
 
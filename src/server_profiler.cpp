@@ -0,0 +1,72 @@
+/**
+ * @file server_profiler.cpp
+ * @brief Contains the wall-clock profiling of the server loop
+ */
+
+#include "server_profiler.hpp"
+
+#include <cstdio>
+
+#include <simgrid/s4u.hpp>
+
+XBT_LOG_NEW_DEFAULT_CATEGORY(server_profiler, "server_profiler"); //!< Logging
+
+const char * server_phase_to_cstring(ServerPhase phase)
+{
+    switch (phase)
+    {
+    case ServerPhase::SERIALIZE: return "SERIALIZE";
+    case ServerPhase::EDC_CALL: return "EDC_CALL";
+    case ServerPhase::PARSE: return "PARSE";
+    case ServerPhase::INJECT: return "INJECT";
+    case ServerPhase::WRITE_JOB: return "WRITE_JOB";
+    }
+    return "UNKNOWN";
+}
+
+void ServerProfiler::enable(const std::string & filename)
+{
+    _enabled = true;
+    _filename = filename;
+}
+
+/**
+ * @brief Writes one row of the profiling CSV file
+ * @param[in] f The CSV file
+ * @param[in] kind The kind of the profiled section (handler or phase)
+ * @param[in] name The name of the profiled section
+ * @param[in] counter The counter of the profiled section
+ */
+static void write_counter_row(FILE * f, const char * kind, const char * name, const ProfilingCounter & counter)
+{
+    const double total_seconds = std::chrono::duration<double>(counter.elapsed).count();
+    const double mean_microseconds = counter.nb_calls > 0 ? total_seconds * 1e6 / counter.nb_calls : 0;
+    fprintf(f, "%s,%s,%lu,%.9f,%.3f\n", kind, name, static_cast<unsigned long>(counter.nb_calls), total_seconds, mean_microseconds);
+}
+
+void ServerProfiler::write_results() const
+{
+    if (!_enabled)
+    {
+        return;
+    }
+
+    FILE * f = fopen(_filename.c_str(), "w");
+    xbt_assert(f != nullptr, "Cannot write file '%s'", _filename.c_str());
+
+    fputs("kind,name,nb_calls,total_seconds,mean_microseconds\n", f);
+    for (size_t i = 0; i < NB_IP_MESSAGE_TYPES; ++i)
+    {
+        if (_handlers[i].nb_calls > 0)
+        {
+            write_counter_row(f, "handler", ip_message_type_to_cstring(static_cast<IPMessageType>(i)), _handlers[i]);
+        }
+    }
+    for (size_t i = 0; i < NB_SERVER_PHASES; ++i)
+    {
+        write_counter_row(f, "phase", server_phase_to_cstring(static_cast<ServerPhase>(i)), _phases[i]);
+    }
+
+    fclose(f);
+    XBT_INFO("Server profile written into '%s'", _filename.c_str());
+}
@@ -0,0 +1,142 @@
+/**
+ * @file server_profiler.hpp
+ * @brief Contains the wall-clock profiling of the server loop
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "ipp.hpp"
+
+/**
+ * @brief The phases of the server loop whose wall-clock time can be profiled (besides message handlers)
+ */
+enum class ServerPhase
+{
+    SERIALIZE       //!< Finalizing and serializing the protocol message sent to the EDC
+   ,EDC_CALL        //!< Calling the EDC (take_decisions)
+   ,PARSE           //!< Parsing the EDC decisions into inter-actor messages
+   ,INJECT          //!< Clearing the protocol message and starting the actor that injects the decisions
+   ,WRITE_JOB       //!< Writing a finished job into the jobs output file (JobsTracer::write_job)
+};
+
+//! The number of values of ServerPhase
+constexpr size_t NB_SERVER_PHASES = static_cast<size_t>(ServerPhase::WRITE_JOB) + 1;
+
+/**
+ * @brief Returns a string corresponding to a given ServerPhase
+ * @param[in] phase The ServerPhase
+ * @return A string corresponding to a given ServerPhase
+ */
+const char * server_phase_to_cstring(ServerPhase phase);
+
+/**
+ * @brief The number of calls and the wall-clock time spent in one profiled code section
+ */
+struct ProfilingCounter
+{
+    uint64_t nb_calls = 0; //!< The number of times the section has been executed
+    std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::duration::zero(); //!< The wall-clock time spent in the section
+};
+
+/**
+ * @brief Accumulates the number of calls and the wall-clock time spent in each server message handler and in each ServerPhase
+ * @details Profiling is disabled by default. When it is disabled, counter accessors return nullptr
+ *          and ProfilingScope does not read the clock, so instrumented code only pays for a branch.
+ *          Phases may be nested in message handlers (e.g., WRITE_JOB), hence times should not be summed across rows.
+ */
+class ServerProfiler
+{
+public:
+    /**
+     * @brief Enables profiling, whose results will be written into a CSV file
+     * @param[in] filename The name of the CSV file
+     */
+    void enable(const std::string & filename);
+
+    /**
+     * @brief Returns whether profiling is enabled
+     * @return Whether profiling is enabled
+     */
+    bool is_enabled() const
+    {
+        return _enabled;
+    }
+
+    /**
+     * @brief Returns the counter of a message handler
+     * @param[in] type The type of the message handled
+     * @return The counter of the handler, or nullptr if profiling is disabled
+     */
+    ProfilingCounter * handler_counter(IPMessageType type)
+    {
+        return _enabled ? &_handlers[static_cast<size_t>(type)] : nullptr;
+    }
+
+    /**
+     * @brief Returns the counter of a phase
+     * @param[in] phase The phase
+     * @return The counter of the phase, or nullptr if profiling is disabled
+     */
+    ProfilingCounter * phase_counter(ServerPhase phase)
+    {
+        return _enabled ? &_phases[static_cast<size_t>(phase)] : nullptr;
+    }
+
+    /**
+     * @brief Writes the profiling results into the CSV file (if profiling is enabled)
+     */
+    void write_results() const;
+
+private:
+    bool _enabled = false; //!< Whether profiling is enabled
+    std::string _filename; //!< The name of the CSV file into which the results are written
+    std::array<ProfilingCounter, NB_IP_MESSAGE_TYPES> _handlers; //!< The counters of the message handlers, indexed by IPMessageType
+    std::array<ProfilingCounter, NB_SERVER_PHASES> _phases; //!< The counters of the phases, indexed by ServerPhase
+};
+
+/**
+ * @brief Measures the wall-clock time spent in a scope and adds it to a ProfilingCounter
+ */
+class ProfilingScope
+{
+public:
+    /**
+     * @brief Starts measuring
+     * @param[in,out] counter The counter to update when the scope ends. Nothing is measured if nullptr.
+     */
+    explicit ProfilingScope(ProfilingCounter * counter) :
+        _counter(counter)
+    {
+        if (_counter != nullptr)
+        {
+            _start = std::chrono::steady_clock::now();
+        }
+    }
+
+    /**
+     * @brief ProfilingScope cannot be copied.
+     * @param[in] other Another instance
+     */
+    ProfilingScope(const ProfilingScope & other) = delete;
+
+    /**
+     * @brief Stops measuring and updates the counter
+     */
+    ~ProfilingScope()
+    {
+        if (_counter != nullptr)
+        {
+            _counter->elapsed += std::chrono::steady_clock::now() - _start;
+            ++_counter->nb_calls;
+        }
+    }
+
+private:
+    ProfilingCounter * _counter; //!< The counter to update, or nullptr
+    std::chrono::steady_clock::time_point _start; //!< When the measure started
+};
@@ -2,8 +2,13 @@
 
 #include <stdio.h>
 
+#include <fstream>
+#include <sstream>
+#include <string>
+
 #include <intervalset.hpp>
 
+#include "../context.hpp"
 #include "../export.hpp"
 
 TEST(buffered_outputting, write_buffer)
@@ -37,6 +42,49 @@ TEST(buffered_outputting, write_buffer)
     EXPECT_EQ(remove_ret, 0) << "Could not remove file " << filename;
 }
 
+static std::string read_file(const char * filename)
+{
+    std::ifstream f(filename);
+    std::stringstream ss;
+    ss << f.rdbuf();
+    return ss.str();
+}
+
+TEST(buffered_outputting, async_write_buffer)
+{
+    const char * filename = "/tmp/test_wbuf_async";
+    WriteBuffer * buf = new WriteBuffer(filename, 8, true);
+    std::string expected;
+
+    // Many texts smaller than the buffer size, so that the writer thread falls behind
+    for (int i = 0; i < 1000; ++i)
+    {
+        std::string text = std::to_string(i) + "\n";
+        buf->append_text(text.c_str());
+        expected += text;
+    }
+
+    // Texts bigger than the buffer size are written by chunks, in order
+    for (int i = 0; i < 10; ++i)
+    {
+        const char * text = "This text is bigger than the buffer\n";
+        buf->append_text(text);
+        expected += text;
+    }
+
+    buf->flush_buffer();
+    buf->append_text("end\n");
+    expected += "end\n";
+
+    // Join the writer thread, close file and release memory
+    delete buf;
+
+    EXPECT_EQ(read_file(filename), expected);
+
+    // Remove temporary file
+    int remove_ret = remove(filename);
+    EXPECT_EQ(remove_ret, 0) << "Could not remove file " << filename;
+}
 
 TEST(buffered_outputting, pstate_writer)
 {
@@ -71,3 +119,61 @@ TEST(buffered_outputting, pstate_writer)
     int remove_ret = remove(filename);
     EXPECT_EQ(remove_ret, 0) << "Could not remove file " << filename;
 }
+
+static std::string machine_states_row(double date, const Machines & machines)
+{
+    char buf[256];
+    snprintf(buf, sizeof(buf), "%g,%d,%d,%d,%d,%d\n", date,
+             machines.nb_machines_in_state(MachineState::SLEEPING),
+             machines.nb_machines_in_state(MachineState::TRANSITING_FROM_SLEEPING_TO_COMPUTING),
+             machines.nb_machines_in_state(MachineState::TRANSITING_FROM_COMPUTING_TO_SLEEPING),
+             machines.nb_machines_in_state(MachineState::IDLE),
+             machines.nb_machines_in_state(MachineState::COMPUTING));
+    return buf;
+}
+
+TEST(buffered_outputting, machine_state_writer)
+{
+    const char * filename = "/tmp/test_machine_states";
+    BatsimContext context;
+    MachineStateTracer * tracer = new MachineStateTracer;
+    tracer->set_context(&context);
+    tracer->set_filename(filename);
+    std::string expected_rows;
+
+    // One change at a date
+    context.machines.update_machines_in_each_state(0, MachineState::IDLE, MachineState::COMPUTING);
+    tracer->write_machine_states(0);
+    expected_rows += machine_states_row(0, context.machines);
+
+    // Several changes at a same date are coalesced into one row, which holds the state after the last change
+    for (int machine_id = 1; machine_id < 4; ++machine_id)
+    {
+        context.machines.update_machines_in_each_state(machine_id, MachineState::IDLE, MachineState::COMPUTING);
+        tracer->write_machine_states(1);
+    }
+    context.machines.update_machines_in_each_state(0, MachineState::COMPUTING, MachineState::TRANSITING_FROM_COMPUTING_TO_SLEEPING);
+    tracer->write_machine_states(1);
+    expected_rows += machine_states_row(1, context.machines);
+
+    // Distinct dates give distinct rows, even if the state did not change
+    tracer->write_machine_states(2);
+    expected_rows += machine_states_row(2, context.machines);
+    context.machines.update_machines_in_each_state(0, MachineState::TRANSITING_FROM_COMPUTING_TO_SLEEPING, MachineState::SLEEPING);
+    tracer->write_machine_states(2.5);
+    expected_rows += machine_states_row(2.5, context.machines);
+
+    // The last row is pending until the tracer is flushed
+    tracer->flush();
+    tracer->close_buffer();
+    delete tracer;
+
+    std::string content = read_file(filename);
+    const size_t header_end = content.find('\n');
+    ASSERT_NE(header_end, std::string::npos);
+    EXPECT_EQ(content.substr(header_end + 1), expected_rows);
+
+    // Remove temporary file
+    int remove_ret = remove(filename);
+    EXPECT_EQ(remove_ret, 0) << "Could not remove file " << filename;
+}
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "../columnar.hpp"
+
+static std::vector<char> read_file(const char * filename)
+{
+    std::ifstream f(filename, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+}
+
+template <typename T>
+static T read_value(const std::vector<char> & data, size_t & offset)
+{
+    T value;
+    memcpy(&value, data.data() + offset, sizeof(T));
+    offset += sizeof(T);
+    return value;
+}
+
+TEST(columnar, row_groups)
+{
+    const char * filename = "/tmp/test_columnar.batcol";
+    {
+        ColumnarWriter writer(filename, {{"id", ColumnType::INT64},
+                                         {"value", ColumnType::FLOAT64},
+                                         {"name", ColumnType::STRING},
+                                         {"state", ColumnType::DICTIONARY_STRING}}, 2);
+        const char * states[3] = {"ok", "ko", "ok"};
+        for (int i = 0; i < 3; ++i)
+        {
+            writer.append_int64(i);
+            writer.append_float64(i == 1 ? std::numeric_limits<double>::quiet_NaN() : i * 0.5);
+            writer.append_string("job" + std::to_string(i));
+            writer.append_string(states[i]);
+            writer.end_row();
+        }
+    }
+
+    const std::vector<char> data = read_file(filename);
+    ASSERT_GE(data.size(), 24u);
+    EXPECT_EQ(memcmp(data.data(), "BATCOL\0\0", 8), 0);
+
+    size_t offset = 8;
+    EXPECT_EQ(read_value<uint32_t>(data, offset), 1u); // format version
+    EXPECT_EQ(read_value<uint32_t>(data, offset), 0x01020304u); // byte order mark
+    EXPECT_EQ(read_value<uint32_t>(data, offset), 4u); // number of columns
+    offset += 4;
+
+    const char * names[4] = {"id", "value", "name", "state"};
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_EQ(read_value<uint8_t>(data, offset), i + 1); // column type
+        offset += 1;
+        const uint16_t name_size = read_value<uint16_t>(data, offset);
+        EXPECT_EQ(std::string(data.data() + offset, name_size), names[i]);
+        offset += name_size;
+    }
+
+    // First row group: 2 rows
+    EXPECT_EQ(read_value<uint32_t>(data, offset), 2u);
+    offset += 4;
+    EXPECT_EQ(read_value<uint64_t>(data, offset), 16u);
+    EXPECT_EQ(read_value<int64_t>(data, offset), 0);
+    EXPECT_EQ(read_value<int64_t>(data, offset), 1);
+    EXPECT_EQ(read_value<uint64_t>(data, offset), 16u);
+    EXPECT_EQ(read_value<double>(data, offset), 0.0);
+    EXPECT_TRUE(std::isnan(read_value<double>(data, offset)));
+    EXPECT_EQ(read_value<uint64_t>(data, offset), 2 * 4 + 8u);
+    EXPECT_EQ(read_value<uint32_t>(data, offset), 4u);
+    EXPECT_EQ(read_value<uint32_t>(data, offset), 4u);
+    EXPECT_EQ(std::string(data.data() + offset, 8), "job0job1");
+    offset += 8;
+    EXPECT_EQ(read_value<uint64_t>(data, offset), 4 + 2 * 4 + 4 + 2 * 4u);
+    EXPECT_EQ(read_value<uint32_t>(data, offset), 2u); // dictionary entries
+    EXPECT_EQ(read_value<uint32_t>(data, offset), 2u);
+    EXPECT_EQ(read_value<uint32_t>(data, offset), 2u);
+    EXPECT_EQ(std::string(data.data() + offset, 4), "okko");
+    offset += 4;
+    EXPECT_EQ(read_value<uint32_t>(data, offset), 0u);
+    EXPECT_EQ(read_value<uint32_t>(data, offset), 1u);
+
+    // Second row group: the last row, written when the writer is destroyed
+    EXPECT_EQ(read_value<uint32_t>(data, offset), 1u);
+    offset += 4;
+    EXPECT_EQ(read_value<uint64_t>(data, offset), 8u);
+    EXPECT_EQ(read_value<int64_t>(data, offset), 2);
+    EXPECT_EQ(read_value<uint64_t>(data, offset), 8u);
+    EXPECT_EQ(read_value<double>(data, offset), 1.0);
+    EXPECT_EQ(read_value<uint64_t>(data, offset), 4 + 4u);
+    offset += 8;
+    EXPECT_EQ(read_value<uint64_t>(data, offset), 4 + 4 + 2 + 4u);
+    offset += 14;
+    EXPECT_EQ(offset, data.size());
+
+    EXPECT_EQ(remove(filename), 0) << "Could not remove file " << filename;
+}
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#include <zlib.h>
+#include <zstd.h>
+
+#include "../compression.hpp"
+#include "../export.hpp"
+
+static std::string read_gzip_file(const char * filename)
+{
+    std::string content;
+    gzFile f = gzopen(filename, "rb");
+    EXPECT_NE(f, nullptr);
+    char buf[4096];
+    int nb_read;
+    while ((nb_read = gzread(f, buf, sizeof(buf))) > 0)
+    {
+        content.append(buf, static_cast<size_t>(nb_read));
+    }
+    gzclose(f);
+    return content;
+}
+
+static std::string read_zstd_file(const char * filename)
+{
+    std::string content;
+    FILE * f = fopen(filename, "rb");
+    EXPECT_NE(f, nullptr);
+    std::vector<char> in(ZSTD_DStreamInSize());
+    std::vector<char> out(ZSTD_DStreamOutSize());
+    ZSTD_DCtx * context = ZSTD_createDCtx();
+    size_t nb_read;
+    while ((nb_read = fread(in.data(), 1, in.size(), f)) > 0)
+    {
+        ZSTD_inBuffer input = {in.data(), nb_read, 0};
+        while (input.pos < input.size)
+        {
+            ZSTD_outBuffer output = {out.data(), out.size(), 0};
+            size_t ret = ZSTD_decompressStream(context, &output, &input);
+            EXPECT_FALSE(ZSTD_isError(ret));
+            content.append(out.data(), output.pos);
+        }
+    }
+    ZSTD_freeDCtx(context);
+    fclose(f);
+    return content;
+}
+
+static std::string write_lines(const char * filename, bool asynchronous)
+{
+    std::string expected;
+    WriteBuffer * buf = new WriteBuffer(filename, 64, asynchronous);
+    for (int i = 0; i < 10000; ++i)
+    {
+        std::string line = "line " + std::to_string(i) + ",some repetitive content\n";
+        buf->append_text(line.c_str());
+        expected += line;
+    }
+    delete buf;
+    return expected;
+}
+
+TEST(compression, codec_from_filename)
+{
+    EXPECT_EQ(compression_codec_from_filename("jobs.csv"), CompressionCodec::NONE);
+    EXPECT_EQ(compression_codec_from_filename("jobs.csv.gz"), CompressionCodec::GZIP);
+    EXPECT_EQ(compression_codec_from_filename("schedule.trace.zst"), CompressionCodec::ZSTD);
+    EXPECT_EQ(compression_codec_from_filename(std::string("out") + compression_codec_extension(CompressionCodec::ZSTD)), CompressionCodec::ZSTD);
+}
+
+TEST(compression, gzip_write_buffer)
+{
+    const char * filename = "/tmp/test_wbuf.csv.gz";
+    for (bool asynchronous : {false, true})
+    {
+        const std::string expected = write_lines(filename, asynchronous);
+        EXPECT_EQ(read_gzip_file(filename), expected);
+        EXPECT_EQ(remove(filename), 0) << "Could not remove file " << filename;
+    }
+}
+
+TEST(compression, zstd_write_buffer)
+{
+    const char * filename = "/tmp/test_wbuf.csv.zst";
+    for (bool asynchronous : {false, true})
+    {
+        const std::string expected = write_lines(filename, asynchronous);
+        EXPECT_EQ(read_zstd_file(filename), expected);
+        EXPECT_EQ(remove(filename), 0) << "Could not remove file " << filename;
+    }
+}
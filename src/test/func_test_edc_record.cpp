@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+
+#include <stdexcept>
+#include <string>
+
+#include "../edc_record.hpp"
+
+static const uint8_t * bytes(const std::string & str)
+{
+    return reinterpret_cast<const uint8_t *>(str.data());
+}
+
+static std::string as_string(const uint8_t * data, uint32_t size)
+{
+    return std::string(reinterpret_cast<const char *>(data), size);
+}
+
+TEST(edc_record, record_then_replay)
+{
+    const char * filename = "/tmp/test_edc_record_1.bin";
+    const std::string what_happened[3] = {"hello", "", "a somewhat longer message"};
+    const std::string decisions[3] = {"decisions #0", "", "abc"};
+
+    {
+        EDCDecisionRecorder recorder(filename, 0x2);
+        for (int i = 0; i < 3; ++i)
+        {
+            recorder.record(bytes(what_happened[i]), what_happened[i].size(), bytes(decisions[i]), decisions[i].size());
+        }
+        EXPECT_EQ(recorder.nb_records(), 3u);
+    }
+
+    EDCDecisionReplayer replayer(filename);
+    EXPECT_TRUE(replayer.json_format());
+    EXPECT_NO_THROW(replayer.check_init(0x2));
+    EXPECT_THROW(replayer.check_init(0x1), std::runtime_error);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        const uint8_t * replayed = nullptr;
+        uint32_t replayed_size = 0;
+        replayer.next_decisions(bytes(what_happened[i]), what_happened[i].size(), &replayed, &replayed_size);
+        EXPECT_EQ(as_string(replayed, replayed_size), decisions[i]);
+        EXPECT_EQ(replayed[replayed_size], 0u) << "decisions should be NUL-terminated";
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(replayed) % 8, 0u) << "decisions should be aligned";
+    }
+
+    // The recorded simulation is over
+    const uint8_t * replayed = nullptr;
+    uint32_t replayed_size = 0;
+    EXPECT_THROW(replayer.next_decisions(bytes(what_happened[0]), what_happened[0].size(), &replayed, &replayed_size), std::runtime_error);
+
+    EXPECT_EQ(remove(filename), 0) << "Could not remove file " << filename;
+}
+
+TEST(edc_record, divergence_is_detected)
+{
+    const char * filename = "/tmp/test_edc_record_2.bin";
+    const std::string what_happened = "what happened";
+    const std::string decisions = "decisions";
+
+    {
+        EDCDecisionRecorder recorder(filename, 0x1);
+        recorder.record(bytes(what_happened), what_happened.size(), bytes(decisions), decisions.size());
+        recorder.record(bytes(what_happened), what_happened.size(), bytes(decisions), decisions.size());
+    }
+
+    EDCDecisionReplayer replayer(filename);
+    EXPECT_FALSE(replayer.json_format());
+
+    const uint8_t * replayed = nullptr;
+    uint32_t replayed_size = 0;
+    EXPECT_NO_THROW(replayer.next_decisions(bytes(what_happened), what_happened.size(), &replayed, &replayed_size));
+
+    // Same size, different content
+    const std::string other = "what_happened";
+    EXPECT_THROW(replayer.next_decisions(bytes(other), other.size(), &replayed, &replayed_size), std::runtime_error);
+
+    EXPECT_EQ(remove(filename), 0) << "Could not remove file " << filename;
+}
@@ -0,0 +1,30 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "../object_pool.hpp"
+
+struct PooledThing : public PoolAllocated<PooledThing>
+{
+    std::string name;
+    double value = 0;
+};
+
+TEST(object_pool, memory_is_recycled)
+{
+    PooledThing * first = new PooledThing;
+    first->name = "first";
+    void * first_address = first;
+    delete first;
+
+    // The block that has just been released is the first one to be reused
+    PooledThing * second = new PooledThing;
+    EXPECT_EQ(static_cast<void *>(second), first_address);
+    EXPECT_EQ(second->value, 0);
+
+    PooledThing * third = new PooledThing;
+    EXPECT_NE(third, second);
+
+    delete second;
+    delete third;
+}
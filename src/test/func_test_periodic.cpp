@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "../periodic.hpp"
+
+TEST(periodic, first_fire_time)
+{
+    // Triggers fire at offset + k*period, strictly after their creation
+    EXPECT_EQ(periodic_first_fire_time(10, 0, 0), 10u);
+    EXPECT_EQ(periodic_first_fire_time(10, 0, 5), 10u);
+    EXPECT_EQ(periodic_first_fire_time(10, 0, 10), 20u);
+    EXPECT_EQ(periodic_first_fire_time(10, 3, 0), 3u);
+    EXPECT_EQ(periodic_first_fire_time(10, 3, 3), 13u);
+    EXPECT_EQ(periodic_first_fire_time(10, 3, 27.5), 33u);
+    EXPECT_EQ(periodic_first_fire_time(7, 100, 42), 100u);
+}
+
+TEST(periodic, timeline_order)
+{
+    PeriodicTimeline timeline;
+    EXPECT_TRUE(timeline.empty());
+
+    timeline.insert(PeriodicTriggerType::PROBE, "p1", 20);
+    timeline.insert(PeriodicTriggerType::PROBE, "p0", 10);
+    timeline.insert(PeriodicTriggerType::CALL_ME_LATER, "c1", 10);
+    timeline.insert(PeriodicTriggerType::CALL_ME_LATER, "c0", 30);
+    EXPECT_EQ(timeline.size(), 4u);
+    EXPECT_EQ(timeline.next_fire_time(), 10u);
+
+    // Triggers that fire at the same time are popped together, CallMeLater first
+    std::vector<PeriodicTimeline::Entry> entries;
+    timeline.pop_next(entries);
+    ASSERT_EQ(entries.size(), 2u);
+    EXPECT_EQ(entries[0].type, PeriodicTriggerType::CALL_ME_LATER);
+    EXPECT_EQ(entries[0].id, "c1");
+    EXPECT_EQ(entries[1].type, PeriodicTriggerType::PROBE);
+    EXPECT_EQ(entries[1].id, "p0");
+    EXPECT_EQ(timeline.next_fire_time(), 20u);
+
+    // Popped triggers can be inserted back at their next firing time
+    timeline.insert(PeriodicTriggerType::CALL_ME_LATER, "c1", 17);
+    EXPECT_EQ(timeline.next_fire_time(), 17u);
+
+    // Identifiers are specific to each type of trigger
+    EXPECT_FALSE(timeline.remove(PeriodicTriggerType::PROBE, "c1"));
+    EXPECT_TRUE(timeline.remove(PeriodicTriggerType::CALL_ME_LATER, "c1"));
+    EXPECT_FALSE(timeline.remove(PeriodicTriggerType::CALL_ME_LATER, "c1"));
+    EXPECT_EQ(timeline.next_fire_time(), 20u);
+
+    timeline.pop_next(entries);
+    ASSERT_EQ(entries.size(), 1u);
+    EXPECT_EQ(entries[0].id, "p1");
+    timeline.pop_next(entries);
+    ASSERT_EQ(entries.size(), 1u);
+    EXPECT_EQ(entries[0].id, "c0");
+    EXPECT_TRUE(timeline.empty());
+
+    timeline.pop_next(entries);
+    EXPECT_TRUE(entries.empty());
+}
+
+TEST(periodic, sum_probed_values)
+{
+    EXPECT_EQ(sum_probed_values(nullptr, 0), 0);
+
+    // Sizes that are not multiples of the unrolling factor must be fully summed
+    std::vector<double> values;
+    for (int nb_values = 1; nb_values <= 11; ++nb_values)
+    {
+        values.push_back(nb_values);
+        EXPECT_EQ(sum_probed_values(values.data(), values.size()), nb_values * (nb_values + 1) / 2.0) << "nb_values=" << nb_values;
+    }
+}
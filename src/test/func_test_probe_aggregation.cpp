@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "../probe_aggregation.hpp"
+
+// Values of each round for 3 resources
+static std::vector<std::vector<double>> generate_rounds(int nb_rounds)
+{
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> distribution(0, 100);
+
+    std::vector<std::vector<double>> rounds(nb_rounds, std::vector<double>(3));
+    for (auto & round : rounds)
+        for (auto & value : round)
+            value = distribution(generator);
+    return rounds;
+}
+
+TEST(probe_aggregation, none)
+{
+    TemporalAggregator aggregator;
+    aggregator.reset(TemporalAggregation(), 3);
+    EXPECT_FALSE(aggregator.is_enabled());
+
+    std::vector<double> values = {1, 2, 3};
+    aggregator.add_values(values.data());
+    EXPECT_EQ(values, std::vector<double>({1, 2, 3}));
+}
+
+TEST(probe_aggregation, exponential_moving_average)
+{
+    TemporalAggregation aggregation;
+    aggregation.type = TemporalAggregationType::EXPONENTIAL_MOVING_AVERAGE;
+    aggregation.ema_alpha = 0.25;
+
+    TemporalAggregator aggregator;
+    aggregator.reset(aggregation, 1);
+    EXPECT_TRUE(aggregator.is_enabled());
+
+    // The first value initializes the average
+    double value = 8;
+    aggregator.add_values(&value);
+    EXPECT_DOUBLE_EQ(value, 8);
+
+    value = 16;
+    aggregator.add_values(&value);
+    EXPECT_DOUBLE_EQ(value, 10);
+
+    value = 2;
+    aggregator.add_values(&value);
+    EXPECT_DOUBLE_EQ(value, 8);
+}
+
+TEST(probe_aggregation, sliding_windows)
+{
+    const auto rounds = generate_rounds(50);
+
+    for (auto type : {TemporalAggregationType::SLIDING_WINDOW_MEAN, TemporalAggregationType::SLIDING_WINDOW_MAX})
+    {
+        for (unsigned int window_size : {1u, 2u, 5u, 64u})
+        {
+            TemporalAggregation aggregation;
+            aggregation.type = type;
+            aggregation.window_size = window_size;
+
+            TemporalAggregator aggregator;
+            aggregator.reset(aggregation, 3);
+
+            for (size_t i = 0; i < rounds.size(); ++i)
+            {
+                std::vector<double> values = rounds[i];
+                aggregator.add_values(values.data());
+
+                // Compare with a direct computation over the window
+                const size_t first = (i + 1 >= window_size) ? i + 1 - window_size : 0;
+                for (size_t r = 0; r < 3; ++r)
+                {
+                    double expected = (type == TemporalAggregationType::SLIDING_WINDOW_MAX) ? rounds[first][r] : 0;
+                    for (size_t j = first; j <= i; ++j)
+                    {
+                        if (type == TemporalAggregationType::SLIDING_WINDOW_MAX)
+                            expected = std::max(expected, rounds[j][r]);
+                        else
+                            expected += rounds[j][r] / (i + 1 - first);
+                    }
+                    EXPECT_NEAR(values[r], expected, 1e-9) << "window_size=" << window_size << ", round=" << i << ", resource=" << r;
+                }
+            }
+        }
+    }
+}
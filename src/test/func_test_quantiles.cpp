@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "../quantiles.hpp"
+
+static double exact_quantile(std::vector<double> values, double q)
+{
+    std::sort(values.begin(), values.end());
+    return values[static_cast<size_t>(q * (values.size() - 1))];
+}
+
+TEST(quantiles, empty_and_single_value)
+{
+    TDigest digest;
+    EXPECT_TRUE(std::isnan(digest.quantile(0.5)));
+    EXPECT_EQ(digest.count(), 0);
+
+    digest.add(std::nan(""));
+    EXPECT_EQ(digest.count(), 0);
+
+    digest.add(42);
+    EXPECT_EQ(digest.count(), 1);
+    EXPECT_EQ(digest.quantile(0), 42);
+    EXPECT_EQ(digest.quantile(0.5), 42);
+    EXPECT_EQ(digest.quantile(1), 42);
+}
+
+TEST(quantiles, bounded_memory_and_accuracy)
+{
+    std::mt19937 generator(42);
+    std::exponential_distribution<double> distribution(1.0 / 3600);
+
+    TDigest digest;
+    std::vector<double> values;
+    for (int i = 0; i < 100000; ++i)
+    {
+        values.push_back(distribution(generator));
+        digest.add(values.back());
+    }
+
+    EXPECT_EQ(digest.count(), 100000);
+    EXPECT_LE(digest.nb_centroids(), 100u);
+    EXPECT_EQ(digest.quantile(0), *std::min_element(values.begin(), values.end()));
+    EXPECT_EQ(digest.quantile(1), *std::max_element(values.begin(), values.end()));
+
+    for (double q : {0.5, 0.9, 0.99})
+    {
+        const double exact = exact_quantile(values, q);
+        EXPECT_NEAR(digest.quantile(q), exact, 0.01 * exact) << "q=" << q;
+    }
+}
+
+TEST(quantiles, merge)
+{
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<double> distribution(0, 1000);
+
+    TDigest merged, first_half, second_half;
+    std::vector<double> values;
+    for (int i = 0; i < 20000; ++i)
+    {
+        values.push_back(distribution(generator));
+        (i % 2 == 0 ? first_half : second_half).add(values.back());
+    }
+    merged.merge(first_half);
+    merged.merge(second_half);
+    merged.merge(TDigest());
+
+    EXPECT_EQ(merged.count(), 20000);
+    for (double q : {0.5, 0.9, 0.99})
+    {
+        EXPECT_NEAR(merged.quantile(q), exact_quantile(values, q), 10) << "q=" << q;
+    }
+}
@@ -0,0 +1,34 @@
+#include <gtest/gtest.h>
+
+#include "../server_profiler.hpp"
+
+TEST(server_profiler, disabled_by_default)
+{
+    ServerProfiler profiler;
+    EXPECT_FALSE(profiler.is_enabled());
+    EXPECT_EQ(profiler.handler_counter(IPMessageType::JOB_SUBMITTED), nullptr);
+    EXPECT_EQ(profiler.phase_counter(ServerPhase::PARSE), nullptr);
+
+    // Scopes without counter do nothing
+    ProfilingScope scope(profiler.phase_counter(ServerPhase::PARSE));
+}
+
+TEST(server_profiler, scopes_update_counters)
+{
+    ServerProfiler profiler;
+    profiler.enable("/tmp/test_server_profiler.csv");
+    ASSERT_TRUE(profiler.is_enabled());
+
+    for (int i = 0; i < 3; ++i)
+    {
+        ProfilingScope scope(profiler.handler_counter(IPMessageType::JOB_SUBMITTED));
+    }
+    {
+        ProfilingScope scope(profiler.phase_counter(ServerPhase::SERIALIZE));
+    }
+
+    EXPECT_EQ(profiler.handler_counter(IPMessageType::JOB_SUBMITTED)->nb_calls, 3u);
+    EXPECT_EQ(profiler.handler_counter(IPMessageType::JOB_COMPLETED)->nb_calls, 0u);
+    EXPECT_EQ(profiler.phase_counter(ServerPhase::SERIALIZE)->nb_calls, 1u);
+    EXPECT_GE(profiler.phase_counter(ServerPhase::SERIALIZE)->elapsed.count(), 0);
+}
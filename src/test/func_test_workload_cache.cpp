@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/stat.h>
+
+#include <string>
+
+#include "../jobs.hpp"
+#include "../profiles.hpp"
+#include "../workload.hpp"
+#include "../workload_cache.hpp"
+
+static void write_file(const char * filename, const char * content)
+{
+    FILE * f = fopen(filename, "w");
+    ASSERT_NE(f, nullptr) << "Could not open file " << filename;
+    fputs(content, f);
+    fclose(f);
+}
+
+TEST(workload_cache, compile_then_load)
+{
+    const char * filename = "/tmp/test_workload_cache_1.json";
+    const std::string cache_filename = WorkloadCache::cache_filename(filename);
+    write_file(filename, R"({
+        "nb_res": 4,
+        "profiles": {
+            "delay10": {"type": "delay", "delay": 10},
+            "unused": {"type": "delay", "delay": 1}
+        },
+        "jobs": [
+            {"id": 2, "subtime": 5, "walltime": 100, "res": 4, "profile": "delay10", "extra_data": {"a": [1, "b"]}},
+            {"id": "1", "subtime": 0, "res": 1, "profile": "delay10"}
+        ]
+    })");
+
+    EXPECT_EQ(WorkloadCache::open_if_up_to_date(filename), nullptr) << "no cache has been compiled yet";
+    WorkloadCache::compile(filename, cache_filename, "w0");
+
+    WorkloadCache * cache = WorkloadCache::open_if_up_to_date(filename);
+    ASSERT_NE(cache, nullptr);
+    EXPECT_EQ(cache->nb_res(), 4);
+    ASSERT_EQ(cache->nb_jobs(), 2u);
+
+    Workload * workload = Workload::new_static_workload("w0", filename);
+    cache->load_profiles(workload);
+    EXPECT_EQ(workload->profiles->nb_profiles(), 2);
+
+    // Jobs are sorted by submission time
+    auto first = cache->build_job(0, workload);
+    EXPECT_EQ(first->id.to_string(), "w0!1");
+    EXPECT_EQ(first->submission_time, 0);
+    EXPECT_EQ(first->walltime, -1);
+    EXPECT_EQ(first->requested_nb_res, 1u);
+    EXPECT_EQ(first->profile->name, "delay10");
+
+    auto second = cache->build_job(1, workload);
+    EXPECT_EQ(second->id.to_string(), "w0!2");
+    EXPECT_EQ(second->submission_time, 5);
+    EXPECT_EQ(second->walltime, 100);
+    EXPECT_EQ(second->requested_nb_res, 4u);
+    EXPECT_EQ(second->extra_data, R"({"a":[1,"b"]})");
+
+    first = nullptr;
+    second = nullptr;
+    delete workload;
+    delete cache;
+
+    // Caches are ignored as soon as their JSON workload changes
+    write_file(filename, R"({"nb_res": 1, "profiles": {}, "jobs": []})");
+    EXPECT_EQ(WorkloadCache::open_if_up_to_date(filename), nullptr);
+
+    EXPECT_EQ(remove(filename), 0) << "Could not remove file " << filename;
+    EXPECT_EQ(remove(cache_filename.c_str()), 0) << "Could not remove file " << cache_filename;
+}
+
+static void set_modification_time(const char * filename, time_t seconds)
+{
+    struct timespec times[2];
+    times[0].tv_sec = seconds;
+    times[0].tv_nsec = 0;
+    times[1] = times[0];
+    ASSERT_EQ(utimensat(AT_FDCWD, filename, times, 0), 0) << "Could not set the modification time of " << filename;
+}
+
+TEST(workload_cache, modification_time)
+{
+    const char * filename = "/tmp/test_workload_cache_2.json";
+    const std::string cache_filename = WorkloadCache::cache_filename(filename);
+    write_file(filename, R"({"nb_res": 1, "profiles": {"d": {"type": "delay", "delay": 1}}, "jobs": []})");
+    set_modification_time(filename, 1000);
+    WorkloadCache::compile(filename, cache_filename, "w0");
+
+    // A file whose content did not change is still up to date after being touched
+    set_modification_time(filename, 2000);
+    WorkloadCache * cache = WorkloadCache::open_if_up_to_date(filename);
+    EXPECT_NE(cache, nullptr);
+    delete cache;
+
+    // A file of the same size but with another content is outdated
+    write_file(filename, R"({"nb_res": 2, "profiles": {"d": {"type": "delay", "delay": 1}}, "jobs": []})");
+    set_modification_time(filename, 3000);
+    EXPECT_EQ(WorkloadCache::open_if_up_to_date(filename), nullptr);
+
+    EXPECT_EQ(remove(filename), 0) << "Could not remove file " << filename;
+    EXPECT_EQ(remove(cache_filename.c_str()), 0) << "Could not remove file " << cache_filename;
+}
@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#include "../workload_reader.hpp"
+
+static void write_file(const char * filename, const char * content)
+{
+    FILE * f = fopen(filename, "w");
+    ASSERT_NE(f, nullptr) << "Could not open file " << filename;
+    fputs(content, f);
+    fclose(f);
+}
+
+TEST(workload_reader, profiles_then_jobs)
+{
+    const char * filename = "/tmp/test_workload_reader_1.json";
+    write_file(filename, R"({
+        "nb_res": 4,
+        "description": {"skipped": [1, 2, {"nested": true}]},
+        "profiles": {
+            "delay10": {"type": "delay", "delay": 10},
+            "delay20": {"type": "delay", "delay": 20.5}
+        },
+        "jobs": [
+            {"id": "1", "subtime": 0, "res": 1, "profile": "delay10"},
+            {"id": 2, "subtime": 1.5, "res": 4, "profile": "delay20", "extra_data": {"a": [1, "b"]}}
+        ]
+    })");
+
+    std::vector<std::string> profile_names;
+    std::vector<double> subtimes;
+
+    // A tiny read buffer forces many refills of the stream
+    WorkloadJsonReader reader(filename, 16);
+    reader.read(
+        [&](const std::string & name, const rapidjson::Value & desc)
+        {
+            EXPECT_TRUE(subtimes.empty()) << "profiles must be read before jobs";
+            EXPECT_TRUE(desc.IsObject());
+            EXPECT_TRUE(desc["delay"].IsNumber());
+            profile_names.push_back(name);
+        },
+        [&](const rapidjson::Value & desc)
+        {
+            EXPECT_TRUE(desc.IsObject());
+            subtimes.push_back(desc["subtime"].GetDouble());
+        });
+
+    EXPECT_EQ(reader.nb_res(), 4);
+    EXPECT_EQ(reader.nb_jobs_read(), 2u);
+    EXPECT_EQ(profile_names, std::vector<std::string>({"delay10", "delay20"}));
+    EXPECT_EQ(subtimes, std::vector<double>({0, 1.5}));
+
+    int remove_ret = remove(filename);
+    EXPECT_EQ(remove_ret, 0) << "Could not remove file " << filename;
+}
+
+TEST(workload_reader, jobs_then_profiles)
+{
+    const char * filename = "/tmp/test_workload_reader_2.json";
+    write_file(filename, R"({
+        "jobs": [
+            {"id": "a", "subtime": 3, "res": 1, "profile": "p"},
+            {"id": "b", "subtime": 4, "res": 1, "profile": "p"}
+        ],
+        "profiles": {"p": {"type": "delay", "delay": 1}},
+        "nb_res": 1
+    })");
+
+    unsigned int nb_profiles = 0;
+    std::vector<std::string> job_ids;
+
+    WorkloadJsonReader reader(filename);
+    reader.read(
+        [&](const std::string &, const rapidjson::Value &)
+        {
+            EXPECT_TRUE(job_ids.empty()) << "jobs must be deferred until profiles have been read";
+            ++nb_profiles;
+        },
+        [&](const rapidjson::Value & desc)
+        {
+            job_ids.push_back(desc["id"].GetString());
+        });
+
+    EXPECT_EQ(reader.nb_res(), 1);
+    EXPECT_EQ(nb_profiles, 1u);
+    EXPECT_EQ(job_ids, std::vector<std::string>({"a", "b"}));
+
+    int remove_ret = remove(filename);
+    EXPECT_EQ(remove_ret, 0) << "Could not remove file " << filename;
+}
@@ -5,11 +5,7 @@
 
 #include "workload.hpp"
 
-#include <fstream>
-#include <streambuf>
-
 #include <rapidjson/document.h>
-#include <rapidjson/error/en.h>
 
 #include <smpi/smpi.h>
 
@@ -17,6 +13,8 @@
 #include "jobs.hpp"
 #include "profiles.hpp"
 #include "jobs_execution.hpp"
+#include "workload_cache.hpp"
+#include "workload_reader.hpp"
 
 using namespace std;
 using namespace rapidjson;
@@ -53,51 +51,98 @@ Workload::~Workload()
 {
     delete jobs;
     delete profiles;
+    delete cache;
 
     jobs = nullptr;
     profiles = nullptr;
+    cache = nullptr;
 }
 
 void Workload::load_from_json(const std::string &json_filename, int &nb_machines)
 {
-    XBT_INFO("Loading JSON workload '%s'...", json_filename.c_str());
-    // Let the file content be placed in a string
-    ifstream ifile(json_filename);
-    xbt_assert(ifile.is_open(), "Cannot read file '%s'", json_filename.c_str());
-    string content;
-
-    ifile.seekg(0, ios::end);
-    content.reserve(static_cast<unsigned long>(ifile.tellg()));
-    ifile.seekg(0, ios::beg);
-
-    content.assign((std::istreambuf_iterator<char>(ifile)),
-                std::istreambuf_iterator<char>());
-
-    // JSON document creation
-    Document doc;
-    doc.Parse(content.c_str());
-    if (doc.HasParseError()) {
-        xbt_assert(false, "Invalid JSON file '%s': could not be parsed: (offset %u): %s",
-            json_filename.c_str(), (unsigned)doc.GetErrorOffset(), GetParseError_En(doc.GetParseError()));
+    cache = WorkloadCache::open_if_up_to_date(json_filename);
+    const bool loaded_from_cache = (cache != nullptr);
+    if (loaded_from_cache)
+    {
+        XBT_INFO("Loading JSON workload '%s' from its binary cache '%s'...",
+                 json_filename.c_str(), WorkloadCache::cache_filename(json_filename).c_str());
+        nb_machines = cache->nb_res();
+        cache->load_profiles(this);
+
+        if (!jobs_are_materialized_lazily())
+        {
+            for (size_t i = 0; i < cache->nb_jobs(); ++i)
+            {
+                jobs->add_job(cache->build_job(i, this));
+            }
+
+            // The cache is only kept when jobs are read from it during the simulation
+            delete cache;
+            cache = nullptr;
+        }
+    }
+    else
+    {
+        XBT_INFO("Loading JSON workload '%s'...", json_filename.c_str());
+        const string error_prefix = "Invalid JSON file '" + json_filename + "'";
+
+        // The file is streamed: profiles and jobs are built one by one, the whole document is never in memory
+        WorkloadJsonReader::JobCallback on_job = nullptr;
+        if (!jobs_are_materialized_lazily())
+        {
+            on_job = [this, &error_prefix](const Value & job_desc)
+            {
+                jobs->add_job_from_json(job_desc, error_prefix);
+            };
+        }
+
+        WorkloadJsonReader reader(json_filename);
+        reader.read(
+            [this, &error_prefix, &json_filename](const string & profile_name, const Value & profile_desc)
+            {
+                profiles->add_profile_from_json(profile_name, profile_desc, error_prefix, json_filename);
+            },
+            on_job);
+
+        nb_machines = reader.nb_res();
     }
-    xbt_assert(doc.IsObject(), "Invalid JSON file '%s': not a JSON object", json_filename.c_str());
 
-    // Let's try to read the number of machines in the JSON document
-    xbt_assert(doc.HasMember("nb_res"), "Invalid JSON file '%s': the 'nb_res' field is missing", json_filename.c_str());
-    const Value & nb_res_node = doc["nb_res"];
-    xbt_assert(nb_res_node.IsInt(), "Invalid JSON file '%s': the 'nb_res' field is not an integer", json_filename.c_str());
-    nb_machines = nb_res_node.GetInt();
     xbt_assert(nb_machines > 0, "Invalid JSON file '%s': the value of the 'nb_res' field is invalid (%d)",
                json_filename.c_str(), nb_machines);
 
-    profiles->load_from_json(doc, json_filename);
-    jobs->load_from_json(doc, json_filename);
+    if (jobs_are_materialized_lazily())
+    {
+        XBT_INFO("JSON workload parsed sucessfully. Read %d profiles. "
+                 "Jobs will be read during the simulation, %Lg seconds before their submission.",
+                 profiles->nb_profiles(), job_materialization_window);
+        XBT_INFO("Checking workload validity...");
+        check_validity();
+        for (const auto & mit : profiles->profiles())
+        {
+            xbt_assert(mit.second->type != ProfileType::REPLAY_SMPI,
+                       "Invalid workload '%s': profile '%s' is an SMPI profile, which is not supported "
+                       "when jobs are materialized during the simulation (SMPI applications must be registered "
+                       "before the simulation starts)", name.c_str(), mit.first.c_str());
+        }
+        XBT_INFO("Workload seems to be valid.");
+
+        // Unreferenced profiles are kept in memory, as the jobs that use them have not been read yet.
+        return;
+    }
 
     XBT_INFO("JSON workload parsed sucessfully. Read %d jobs and %d profiles.",
              jobs->nb_jobs(), profiles->nb_profiles());
-    XBT_INFO("Checking workload validity...");
-    check_validity();
-    XBT_INFO("Workload seems to be valid.");
+    if (loaded_from_cache)
+    {
+        // Jobs have been validated when the cache was compiled, only composed profiles must be resolved
+        check_profiles_validity();
+    }
+    else
+    {
+        XBT_INFO("Checking workload validity...");
+        check_validity();
+        XBT_INFO("Workload seems to be valid.");
+    }
 
     XBT_INFO("Removing unreferenced profiles from memory...");
     profiles->remove_unreferenced_profiles();
@@ -125,6 +170,17 @@ void Workload::register_smpi_applications()
 }
 
 void Workload::check_validity()
+{
+    check_profiles_validity();
+
+    // Let's check the profile validity of each job
+    for (const auto & mit : jobs->jobs())
+    {
+        check_single_job_validity(mit.second);
+    }
+}
+
+void Workload::check_profiles_validity()
 {
     // Let's check that every SEQUENCE-typed profile points to existing profiles
     // And update the refcounting of these profiles
@@ -149,12 +205,6 @@ void Workload::check_validity()
 
     // TODO : check that there are no circular calls between composed profiles...
     // TODO: compute the constraint of the profile number of resources, to check if it matches the jobs that use it
-
-    // Let's check the profile validity of each job
-    for (const auto & mit : jobs->jobs())
-    {
-        check_single_job_validity(mit.second);
-    }
 }
 
 void Workload::check_single_job_validity(const JobPtr job)
@@ -189,6 +239,11 @@ bool Workload::is_static() const
     return _is_static;
 }
 
+bool Workload::jobs_are_materialized_lazily() const
+{
+    return job_materialization_window >= 0;
+}
+
 Workloads::~Workloads()
 {
     for (auto mit : _workloads)
@@ -253,7 +308,10 @@ void Workloads::delete_jobs(const vector<JobIdentifier> & job_ids,
 {
     for (const JobIdentifier & job_id : job_ids)
     {
-        at(job_id.workload_name())->jobs->delete_job(job_id, garbage_collect_profiles);
+        Workload * workload = at(job_id.workload_name());
+
+        // Profiles of lazily materialized workloads may still be used by jobs that have not been read yet
+        workload->jobs->delete_job(job_id, garbage_collect_profiles && !workload->jobs_are_materialized_lazily());
     }
 }
 
@@ -16,6 +16,7 @@ class Jobs;
 struct Job;
 class Profiles;
 class JobIdentifier;
+class WorkloadCache;
 struct BatsimContext;
 
 /**
@@ -61,6 +62,9 @@ public:
 
     /**
      * @brief Loads a static workload from a JSON filename
+     * @details The binary cache of the JSON file is used instead of the JSON file if it is up to date.
+     *          If jobs are materialized lazily (job_materialization_window >= 0), only the profiles are loaded.
+     *          Jobs are then read during the simulation by the job submitter.
      * @param[in] json_filename The name of the JSON file
      * @param[out] nb_machines The number of machines described in the JSON file
      */
@@ -77,6 +81,12 @@ public:
      */
     void check_validity();
 
+    /**
+     * @brief Checks whether the profiles of a Workload are valid
+     * @details Also links composed profiles to the profiles they use
+     */
+    void check_profiles_validity();
+
     /**
      * @brief Checks whether a single job is valid
      * @param[in] job The job to examine
@@ -95,12 +105,20 @@ public:
      */
     bool is_static() const;
 
+    /**
+     * @brief Returns whether the jobs of the workload are read during the simulation instead of at load time
+     * @return Whether the jobs of the workload are materialized lazily
+     */
+    bool jobs_are_materialized_lazily() const;
+
 public:
     std::string name; //!< The Workload name
     std::string file = ""; //!< The Workload file if it exists
     Jobs * jobs = nullptr; //!< The Jobs of the Workload
     Profiles * profiles = nullptr; //!< The Profiles associated to the Jobs of the Workload
     bool _is_static = false; //!< Whether the workload is dynamic or not
+    long double job_materialization_window = -1; //!< If non-negative, jobs are only built this amount of simulated time (in seconds) before their submission. Otherwise they are all built at load time.
+    WorkloadCache * cache = nullptr; //!< The binary cache the jobs are read from during the simulation, if any
 };
 
 
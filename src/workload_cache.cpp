@@ -0,0 +1,425 @@
+/**
+ * @file workload_cache.cpp
+ * @brief Contains the binary cache of JSON workloads
+ */
+
+#include "workload_cache.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <simgrid/s4u.hpp>
+
+#include "jobs.hpp"
+#include "profiles.hpp"
+#include "workload.hpp"
+#include "workload_reader.hpp"
+
+using namespace std;
+using namespace rapidjson;
+
+XBT_LOG_NEW_DEFAULT_CATEGORY(workload_cache, "workload_cache"); //!< Logging
+
+static const char CACHE_MAGIC[8] = {'B', 'A', 'T', 'W', 'L', 'C', '\0', '\0'}; //!< Identifies workload cache files
+static const uint32_t CACHE_FORMAT_VERSION = 2; //!< The version of the cache format
+static const uint32_t CACHE_BYTE_ORDER_MARK = 0x01020304; //!< Detects caches written with another endianness
+
+/**
+ * @brief The fixed-size header of a workload cache file
+ */
+struct WorkloadCache::Header
+{
+    char magic[8];              //!< Identifies workload cache files
+    uint32_t format_version;    //!< The version of the cache format
+    uint32_t byte_order_mark;   //!< Detects caches written with another endianness
+    uint64_t source_size;       //!< The size of the JSON file the cache has been compiled from
+    int64_t source_mtime_ns;    //!< The modification time (in ns since the epoch) of the JSON file the cache has been compiled from
+    uint64_t source_hash;       //!< The hash of the JSON file the cache has been compiled from
+    uint64_t nb_profiles;       //!< The number of entries of the profile table
+    uint64_t nb_jobs;           //!< The number of entries of the job table
+    uint64_t strings_size;      //!< The size of the string table
+    int32_t nb_res;             //!< The 'nb_res' field of the workload
+    uint32_t padding;           //!< Unused
+};
+
+/**
+ * @brief An entry of the profile table of a workload cache file
+ */
+struct WorkloadCache::ProfileRecord
+{
+    uint64_t name_offset;       //!< The offset of the profile name in the string table
+    uint64_t desc_offset;       //!< The offset of the profile JSON description in the string table
+    uint32_t name_length;       //!< The length of the profile name
+    uint32_t desc_length;       //!< The length of the profile JSON description
+};
+
+/**
+ * @brief An entry of the job table of a workload cache file
+ */
+struct WorkloadCache::JobRecord
+{
+    double submission_time;     //!< The job submission time
+    double walltime;            //!< The job walltime (-1 if unset)
+    uint64_t id_offset;         //!< The offset of the job id (as written in the JSON file) in the string table
+    uint64_t extra_data_offset; //!< The offset of the job extra data in the string table
+    uint32_t id_length;         //!< The length of the job id
+    uint32_t extra_data_length; //!< The length of the job extra data
+    uint32_t requested_nb_res;  //!< The number of resources requested by the job
+    uint32_t profile_index;     //!< The index of the job profile in the profile table
+};
+
+/**
+ * @brief Returns the modification time of a file
+ * @param[in] file_stat The status of the file
+ * @return The modification time of the file, in nanoseconds since the epoch
+ */
+static int64_t modification_time_ns(const struct stat & file_stat)
+{
+    return static_cast<int64_t>(file_stat.st_mtim.tv_sec) * 1000000000 + static_cast<int64_t>(file_stat.st_mtim.tv_nsec);
+}
+
+/**
+ * @brief Computes the size and the (64-bit FNV-1a) hash of a file
+ * @param[in] filename The name of the file
+ * @param[out] size The size of the file
+ * @param[out] hash The hash of the file content
+ * @return Whether the file could be read
+ */
+static bool hash_file(const std::string & filename, uint64_t & size, uint64_t & hash)
+{
+    FILE * file = fopen(filename.c_str(), "rb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    vector<unsigned char> buffer(1 << 20);
+    size = 0;
+    hash = 0xcbf29ce484222325ULL;
+
+    size_t nb_read;
+    while ((nb_read = fread(buffer.data(), 1, buffer.size(), file)) > 0)
+    {
+        for (size_t i = 0; i < nb_read; ++i)
+        {
+            hash ^= buffer[i];
+            hash *= 0x100000001b3ULL;
+        }
+        size += nb_read;
+    }
+
+    bool success = !ferror(file);
+    fclose(file);
+    return success;
+}
+
+std::string WorkloadCache::cache_filename(const std::string & json_filename)
+{
+    return json_filename + ".cache";
+}
+
+void WorkloadCache::compile(const std::string & json_filename,
+                            const std::string & cache_filename,
+                            const std::string & workload_name)
+{
+    static_assert(sizeof(Header) == 72, "unexpected padding in workload cache header");
+    static_assert(sizeof(ProfileRecord) == 24, "unexpected padding in workload cache profile records");
+    static_assert(sizeof(JobRecord) == 48, "unexpected padding in workload cache job records");
+
+    XBT_INFO("Compiling JSON workload '%s' into '%s'...", json_filename.c_str(), cache_filename.c_str());
+    const string error_prefix = "Invalid JSON file '" + json_filename + "'";
+
+    // The modification time is read first, so that a file modified during the compilation is detected as outdated
+    struct stat source_stat;
+    int stat_ret = stat(json_filename.c_str(), &source_stat);
+    (void) stat_ret; // Avoids a warning if assertions are ignored
+    xbt_assert(stat_ret == 0, "Cannot read file '%s'", json_filename.c_str());
+
+    uint64_t source_size = 0;
+    uint64_t source_hash = 0;
+    bool hashed = hash_file(json_filename, source_size, source_hash);
+    (void) hashed; // Avoids a warning if assertions are ignored
+    xbt_assert(hashed, "Cannot read file '%s'", json_filename.c_str());
+
+    // Profiles and jobs are validated by building them in a temporary workload. Jobs are dropped right after.
+    Workload * workload = Workload::new_static_workload(workload_name, json_filename);
+
+    string strings;
+    vector<ProfileRecord> profile_records;
+    unordered_map<string, uint32_t> profile_indexes;
+    vector<JobRecord> job_records;
+    unordered_set<string> job_ids;
+
+    auto add_string = [&strings](const char * str, size_t length)
+    {
+        uint64_t offset = strings.size();
+        strings.append(str, length);
+        return offset;
+    };
+
+    WorkloadJsonReader reader(json_filename);
+    reader.read(
+        [&](const string & profile_name, const Value & profile_desc)
+        {
+            workload->profiles->add_profile_from_json(profile_name, profile_desc, error_prefix, json_filename);
+
+            StringBuffer buffer;
+            Writer<StringBuffer> writer(buffer);
+            profile_desc.Accept(writer);
+
+            ProfileRecord record;
+            record.name_offset = add_string(profile_name.c_str(), profile_name.size());
+            record.name_length = static_cast<uint32_t>(profile_name.size());
+            record.desc_offset = add_string(buffer.GetString(), buffer.GetSize());
+            record.desc_length = static_cast<uint32_t>(buffer.GetSize());
+
+            profile_indexes[profile_name] = static_cast<uint32_t>(profile_records.size());
+            profile_records.push_back(record);
+        },
+        [&](const Value & job_desc)
+        {
+            auto job = Job::from_json(job_desc, workload, error_prefix);
+            workload->check_single_job_validity(job);
+
+            // The id is stored as written in the file, as the final identifier depends on the workload name
+            const Value & id = job_desc["id"];
+            const string json_id = id.IsString() ? string(id.GetString(), id.GetStringLength()) : std::to_string(id.GetInt());
+            bool inserted = job_ids.insert(json_id).second;
+            (void) inserted; // Avoids a warning if assertions are ignored
+            xbt_assert(inserted, "%s: duplication of job id '%s'", error_prefix.c_str(), json_id.c_str());
+
+            JobRecord record;
+            record.submission_time = static_cast<double>(job->submission_time);
+            record.walltime = static_cast<double>(job->walltime);
+            record.id_offset = add_string(json_id.c_str(), json_id.size());
+            record.id_length = static_cast<uint32_t>(json_id.size());
+            record.extra_data_offset = add_string(job->extra_data.c_str(), job->extra_data.size());
+            record.extra_data_length = static_cast<uint32_t>(job->extra_data.size());
+            record.requested_nb_res = job->requested_nb_res;
+            record.profile_index = profile_indexes.at(job->profile->name);
+
+            job_records.push_back(record);
+        });
+
+    xbt_assert(reader.nb_res() > 0, "%s: the value of the 'nb_res' field is invalid (%d)",
+               error_prefix.c_str(), reader.nb_res());
+    workload->check_profiles_validity();
+    delete workload;
+
+    // Jobs are stored by ascending submission time, ties being broken by id
+    std::stable_sort(job_records.begin(), job_records.end(),
+        [&strings](const JobRecord & a, const JobRecord & b)
+        {
+            if (a.submission_time != b.submission_time)
+            {
+                return a.submission_time < b.submission_time;
+            }
+            return strings.compare(a.id_offset, a.id_length, strings, b.id_offset, b.id_length) < 0;
+        });
+
+    Header header;
+    memset(&header, 0, sizeof(Header));
+    memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.format_version = CACHE_FORMAT_VERSION;
+    header.byte_order_mark = CACHE_BYTE_ORDER_MARK;
+    header.source_size = source_size;
+    header.source_mtime_ns = modification_time_ns(source_stat);
+    header.source_hash = source_hash;
+    header.nb_profiles = profile_records.size();
+    header.nb_jobs = job_records.size();
+    header.strings_size = strings.size();
+    header.nb_res = reader.nb_res();
+
+    // The cache is written next to its final location then renamed, so that readers never see a partial file
+    const string tmp_filename = cache_filename + ".tmp";
+    ofstream out(tmp_filename, ios::binary | ios::trunc);
+    xbt_assert(out.is_open(), "Cannot write file '%s'", tmp_filename.c_str());
+    out.write(reinterpret_cast<const char *>(&header), sizeof(Header));
+    out.write(reinterpret_cast<const char *>(profile_records.data()), static_cast<streamsize>(profile_records.size() * sizeof(ProfileRecord)));
+    out.write(reinterpret_cast<const char *>(job_records.data()), static_cast<streamsize>(job_records.size() * sizeof(JobRecord)));
+    out.write(strings.data(), static_cast<streamsize>(strings.size()));
+    out.close();
+    xbt_assert(!out.fail(), "Could not write file '%s'", tmp_filename.c_str());
+
+    int rename_ret = rename(tmp_filename.c_str(), cache_filename.c_str());
+    (void) rename_ret; // Avoids a warning if assertions are ignored
+    xbt_assert(rename_ret == 0, "Cannot rename '%s' into '%s'", tmp_filename.c_str(), cache_filename.c_str());
+
+    XBT_INFO("JSON workload compiled sucessfully. Wrote %zu jobs and %zu profiles.",
+             job_records.size(), profile_records.size());
+}
+
+WorkloadCache * WorkloadCache::open_if_up_to_date(const std::string & json_filename)
+{
+    const string filename = cache_filename(json_filename);
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd == -1)
+    {
+        return nullptr;
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 || static_cast<size_t>(file_stat.st_size) < sizeof(Header))
+    {
+        close(fd);
+        XBT_WARN("Ignoring workload cache '%s': truncated file", filename.c_str());
+        return nullptr;
+    }
+
+    const size_t file_size = static_cast<size_t>(file_stat.st_size);
+    void * mapping = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        XBT_WARN("Ignoring workload cache '%s': cannot be mapped in memory", filename.c_str());
+        return nullptr;
+    }
+
+    WorkloadCache * cache = new WorkloadCache;
+    cache->_json_filename = json_filename;
+    cache->_mapping = mapping;
+    cache->_mapping_size = file_size;
+
+    const Header * header = static_cast<const Header *>(mapping);
+    const size_t tables_size = file_size - sizeof(Header);
+    string reason;
+
+    if (memcmp(header->magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0)
+    {
+        reason = "not a workload cache file";
+    }
+    else if (header->format_version != CACHE_FORMAT_VERSION || header->byte_order_mark != CACHE_BYTE_ORDER_MARK)
+    {
+        reason = "incompatible cache format (compiled by another Batsim version or on another architecture)";
+    }
+    else if (header->nb_profiles > tables_size / sizeof(ProfileRecord) ||
+             header->nb_jobs > tables_size / sizeof(JobRecord) ||
+             header->strings_size > tables_size ||
+             sizeof(Header) + header->nb_profiles * sizeof(ProfileRecord) +
+             header->nb_jobs * sizeof(JobRecord) + header->strings_size != file_size)
+    {
+        reason = "truncated file";
+    }
+    else
+    {
+        // The workload file is only hashed if its modification time has changed (e.g., it has been copied or touched),
+        // so that opening an up-to-date cache does not read the whole workload file
+        uint64_t source_size = 0;
+        uint64_t source_hash = 0;
+        struct stat source_stat;
+        if (stat(json_filename.c_str(), &source_stat) != 0)
+        {
+            reason = "cannot read the workload file";
+        }
+        else if (static_cast<uint64_t>(source_stat.st_size) != header->source_size)
+        {
+            reason = "the workload file has changed since the cache was compiled";
+        }
+        else if (modification_time_ns(source_stat) != header->source_mtime_ns &&
+                 (!hash_file(json_filename, source_size, source_hash) ||
+                  source_size != header->source_size ||
+                  source_hash != header->source_hash))
+        {
+            reason = "the workload file has changed since the cache was compiled";
+        }
+    }
+
+    if (!reason.empty())
+    {
+        XBT_WARN("Ignoring workload cache '%s': %s", filename.c_str(), reason.c_str());
+        delete cache;
+        return nullptr;
+    }
+
+    const char * base = static_cast<const char *>(mapping);
+    cache->_header = header;
+    cache->_profiles = reinterpret_cast<const ProfileRecord *>(base + sizeof(Header));
+    cache->_jobs = reinterpret_cast<const JobRecord *>(base + sizeof(Header) + header->nb_profiles * sizeof(ProfileRecord));
+    cache->_strings = base + sizeof(Header) + header->nb_profiles * sizeof(ProfileRecord) + header->nb_jobs * sizeof(JobRecord);
+
+    return cache;
+}
+
+WorkloadCache::~WorkloadCache()
+{
+    if (_mapping != nullptr)
+    {
+        munmap(_mapping, _mapping_size);
+        _mapping = nullptr;
+    }
+}
+
+int WorkloadCache::nb_res() const
+{
+    return _header->nb_res;
+}
+
+size_t WorkloadCache::nb_jobs() const
+{
+    return static_cast<size_t>(_header->nb_jobs);
+}
+
+void WorkloadCache::load_profiles(Workload * workload) const
+{
+    const string error_prefix = "Invalid workload cache of '" + _json_filename + "'";
+
+    for (uint64_t i = 0; i < _header->nb_profiles; ++i)
+    {
+        const ProfileRecord & record = _profiles[i];
+
+        Document profile_desc;
+        profile_desc.Parse(_strings + record.desc_offset, record.desc_length);
+        xbt_assert(!profile_desc.HasParseError(), "%s: the description of profile %lu cannot be parsed",
+                   error_prefix.c_str(), static_cast<unsigned long>(i));
+
+        workload->profiles->add_profile_from_json(string_at(record.name_offset, record.name_length),
+                                                  profile_desc, error_prefix, _json_filename);
+    }
+}
+
+JobPtr WorkloadCache::build_job(size_t job_index, Workload * workload) const
+{
+    xbt_assert(job_index < nb_jobs(), "Bad WorkloadCache::build_job call: job %zu does not exist (%zu jobs)",
+               job_index, nb_jobs());
+    const JobRecord & record = _jobs[job_index];
+    xbt_assert(record.profile_index < _header->nb_profiles, "Invalid workload cache of '%s': job %zu has an invalid profile",
+               _json_filename.c_str(), job_index);
+    const ProfileRecord & profile_record = _profiles[record.profile_index];
+
+    // Same initialization as Job::from_json, but from already validated data
+    auto j = std::make_shared<Job>();
+    j->workload = workload;
+    j->id = Job::identifier_from_json_id(string_at(record.id_offset, record.id_length), workload);
+    j->starting_time = -1;
+    j->runtime = -1;
+    j->state = JobState::JOB_STATE_NOT_SUBMITTED;
+    j->consumed_energy = -1;
+    j->submission_time = static_cast<long double>(record.submission_time);
+    j->walltime = static_cast<long double>(record.walltime);
+    j->requested_nb_res = record.requested_nb_res;
+    j->profile = workload->profiles->at(string_at(profile_record.name_offset, profile_record.name_length));
+    j->extra_data = string_at(record.extra_data_offset, record.extra_data_length);
+
+    return j;
+}
+
+std::string WorkloadCache::string_at(uint64_t offset, uint32_t length) const
+{
+    xbt_assert(offset + length <= _header->strings_size, "Invalid workload cache of '%s': string out of bounds",
+               _json_filename.c_str());
+    return string(_strings + offset, length);
+}
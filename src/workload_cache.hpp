@@ -0,0 +1,117 @@
+/**
+ * @file workload_cache.hpp
+ * @brief Contains the binary cache of JSON workloads
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "pointers.hpp"
+
+class Workload;
+
+/**
+ * @brief A pre-compiled binary version of a JSON workload, accessed via mmap
+ * @details A cache file is made of a fixed-size header, a profile table, a job table and a string table.
+ *          Jobs are sorted by submission time. Profiles are kept as (validated) JSON texts as there are
+ *          usually few of them, while jobs are fixed-size records that are built without any parsing.
+ *          The header stores the size, modification time and hash of the JSON file the cache has been compiled from,
+ *          so that outdated caches are detected and ignored. The JSON file is only hashed when its size matches
+ *          but its modification time does not. Cache files are not portable across architectures.
+ */
+class WorkloadCache
+{
+public:
+    /**
+     * @brief Returns the name of the cache file associated with a JSON workload file
+     * @param[in] json_filename The name of the JSON workload file
+     * @return The name of the cache file
+     */
+    static std::string cache_filename(const std::string & json_filename);
+
+    /**
+     * @brief Compiles a JSON workload into a binary cache file
+     * @details The JSON workload is fully validated during compilation.
+     * @param[in] json_filename The name of the JSON workload file
+     * @param[in] cache_filename The name of the cache file to write
+     * @param[in] workload_name The name the workload will have in the simulation (used to validate job identifiers)
+     * @pre The JSON workload is valid
+     */
+    static void compile(const std::string & json_filename,
+                        const std::string & cache_filename,
+                        const std::string & workload_name);
+
+    /**
+     * @brief Opens the cache of a JSON workload if it exists and is up to date
+     * @param[in] json_filename The name of the JSON workload file
+     * @return The newly allocated cache, or nullptr if there is no usable cache
+     */
+    static WorkloadCache * open_if_up_to_date(const std::string & json_filename);
+
+    /**
+     * @brief WorkloadCache cannot be copied.
+     * @param[in] other Another instance
+     */
+    WorkloadCache(const WorkloadCache & other) = delete;
+
+    /**
+     * @brief Unmaps the cache file
+     */
+    ~WorkloadCache();
+
+    /**
+     * @brief Returns the number of resources of the workload (its 'nb_res' field)
+     * @return The number of resources of the workload
+     */
+    int nb_res() const;
+
+    /**
+     * @brief Returns the number of jobs stored in the cache
+     * @return The number of jobs stored in the cache
+     */
+    size_t nb_jobs() const;
+
+    /**
+     * @brief Adds all the profiles stored in the cache into a workload
+     * @param[in,out] workload The workload
+     */
+    void load_profiles(Workload * workload) const;
+
+    /**
+     * @brief Builds one job stored in the cache
+     * @param[in] job_index The index of the job. Jobs are sorted by submission time.
+     * @param[in] workload The workload the job belongs to. Its profiles must have been loaded.
+     * @return The newly allocated Job
+     */
+    JobPtr build_job(size_t job_index, Workload * workload) const;
+
+private:
+    /**
+     * @brief Builds a WorkloadCache. Please refer to open_if_up_to_date.
+     */
+    WorkloadCache() = default;
+
+    /**
+     * @brief Returns a string of the string table
+     * @param[in] offset The offset of the string in the string table
+     * @param[in] length The length of the string
+     * @return The string
+     */
+    std::string string_at(uint64_t offset, uint32_t length) const;
+
+private:
+    struct Header;
+    struct ProfileRecord;
+    struct JobRecord;
+
+    std::string _json_filename; //!< The name of the JSON workload file the cache has been compiled from
+    void * _mapping = nullptr; //!< The address where the cache file is mapped
+    size_t _mapping_size = 0; //!< The size of the mapping
+    const Header * _header = nullptr; //!< The header of the cache
+    const ProfileRecord * _profiles = nullptr; //!< The profile table
+    const JobRecord * _jobs = nullptr; //!< The job table
+    const char * _strings = nullptr; //!< The string table
+};
@@ -0,0 +1,404 @@
+/**
+ * @file workload_reader.cpp
+ * @brief Contains the streaming reader of JSON workload files
+ */
+
+#include "workload_reader.hpp"
+
+#include <climits>
+#include <cstdio>
+
+#include <rapidjson/error/en.h>
+#include <rapidjson/filereadstream.h>
+
+#include <xbt/asserts.h>
+
+using namespace std;
+using namespace rapidjson;
+
+WorkloadJsonReader::WorkloadJsonReader(const std::string & json_filename,
+                                       size_t read_buffer_size) :
+    _filename(json_filename),
+    _error_prefix("Invalid JSON file '" + json_filename + "'"),
+    _read_buffer(read_buffer_size),
+    _pool_buffer(64*1024),
+    _pool(_pool_buffer.data(), _pool_buffer.size()),
+    _element_writer(_element_text)
+{
+    xbt_assert(read_buffer_size >= 4, "Invalid read_buffer_size (%zu): must be at least 4 bytes", read_buffer_size);
+}
+
+void WorkloadJsonReader::read(const ProfileCallback & on_profile,
+                              const JobCallback & on_job)
+{
+    _on_profile = &on_profile;
+    _on_job = &on_job;
+    _read_profiles = static_cast<bool>(on_profile);
+    _read_jobs = static_cast<bool>(on_job);
+
+    FILE * file = fopen(_filename.c_str(), "rb");
+    xbt_assert(file != nullptr, "Cannot read file '%s'", _filename.c_str());
+
+    FileReadStream stream(file, _read_buffer.data(), _read_buffer.size());
+    Reader reader;
+    ParseResult result = reader.Parse(stream, *this);
+    fclose(file);
+
+    xbt_assert(!result.IsError(), "%s: could not be parsed: (offset %u): %s",
+               _error_prefix.c_str(), (unsigned)result.Offset(), GetParseError_En(result.Code()));
+
+    xbt_assert(_nb_res_seen, "%s: the 'nb_res' field is missing", _error_prefix.c_str());
+    xbt_assert(_profiles_seen, "%s: the 'profiles' object is missing", _error_prefix.c_str());
+    xbt_assert(_jobs_seen, "%s: the 'jobs' array is missing", _error_prefix.c_str());
+    xbt_assert(_deferred_jobs.empty(), "Internal error: %zu jobs have not been handed to the job callback", _deferred_jobs.size());
+
+    _on_profile = nullptr;
+    _on_job = nullptr;
+}
+
+int WorkloadJsonReader::nb_res() const
+{
+    return _nb_res;
+}
+
+unsigned int WorkloadJsonReader::nb_jobs_read() const
+{
+    return _nb_jobs_read;
+}
+
+bool WorkloadJsonReader::Null()
+{
+    if (begin_value())
+    {
+        _element_writer.Null();
+        end_captured_scalar();
+    }
+    else
+    {
+        on_uncaptured_scalar();
+    }
+    return true;
+}
+
+bool WorkloadJsonReader::Bool(bool b)
+{
+    if (begin_value())
+    {
+        _element_writer.Bool(b);
+        end_captured_scalar();
+    }
+    else
+    {
+        on_uncaptured_scalar();
+    }
+    return true;
+}
+
+bool WorkloadJsonReader::Int(int i)
+{
+    if (begin_value())
+    {
+        _element_writer.Int(i);
+        end_captured_scalar();
+    }
+    else
+    {
+        on_uncaptured_scalar(true, i);
+    }
+    return true;
+}
+
+bool WorkloadJsonReader::Uint(unsigned u)
+{
+    if (begin_value())
+    {
+        _element_writer.Uint(u);
+        end_captured_scalar();
+    }
+    else
+    {
+        bool fits_int = u <= static_cast<unsigned>(INT_MAX);
+        on_uncaptured_scalar(fits_int, fits_int ? static_cast<int>(u) : 0);
+    }
+    return true;
+}
+
+bool WorkloadJsonReader::Int64(int64_t i)
+{
+    if (begin_value())
+    {
+        _element_writer.Int64(i);
+        end_captured_scalar();
+    }
+    else
+    {
+        on_uncaptured_scalar();
+    }
+    return true;
+}
+
+bool WorkloadJsonReader::Uint64(uint64_t u)
+{
+    if (begin_value())
+    {
+        _element_writer.Uint64(u);
+        end_captured_scalar();
+    }
+    else
+    {
+        on_uncaptured_scalar();
+    }
+    return true;
+}
+
+bool WorkloadJsonReader::Double(double d)
+{
+    if (begin_value())
+    {
+        _element_writer.Double(d);
+        end_captured_scalar();
+    }
+    else
+    {
+        on_uncaptured_scalar();
+    }
+    return true;
+}
+
+bool WorkloadJsonReader::String(const char * str, SizeType length, bool copy)
+{
+    if (begin_value())
+    {
+        _element_writer.String(str, length, copy);
+        end_captured_scalar();
+    }
+    else
+    {
+        on_uncaptured_scalar();
+    }
+    return true;
+}
+
+bool WorkloadJsonReader::StartObject()
+{
+    if (begin_value())
+    {
+        _element_writer.StartObject();
+        ++_capture_depth;
+    }
+    else if (_depth == 1)
+    {
+        xbt_assert(_section != Section::NB_RES, "%s: the 'nb_res' field is not an integer", _error_prefix.c_str());
+        xbt_assert(_section != Section::JOBS, "%s: the 'jobs' member is not an array", _error_prefix.c_str());
+    }
+
+    ++_depth;
+    return true;
+}
+
+bool WorkloadJsonReader::Key(const char * str, SizeType length, bool copy)
+{
+    if (_capturing)
+    {
+        _element_writer.Key(str, length, copy);
+    }
+    else if (_depth == 1)
+    {
+        const string key(str, length);
+        if (key == "nb_res")
+        {
+            xbt_assert(!_nb_res_seen, "%s: duplication of the 'nb_res' field", _error_prefix.c_str());
+            _nb_res_seen = true;
+            _section = Section::NB_RES;
+        }
+        else if (key == "profiles")
+        {
+            xbt_assert(!_profiles_seen, "%s: duplication of the 'profiles' object", _error_prefix.c_str());
+            _profiles_seen = true;
+            _section = Section::PROFILES;
+        }
+        else if (key == "jobs")
+        {
+            xbt_assert(!_jobs_seen, "%s: duplication of the 'jobs' array", _error_prefix.c_str());
+            _jobs_seen = true;
+            _section = Section::JOBS;
+        }
+        else
+        {
+            _section = Section::OTHER;
+        }
+    }
+    else if (_depth == 2 && _section == Section::PROFILES)
+    {
+        _profile_name.assign(str, length);
+    }
+
+    return true;
+}
+
+bool WorkloadJsonReader::EndObject(SizeType member_count)
+{
+    --_depth;
+
+    if (_capturing)
+    {
+        _element_writer.EndObject(member_count);
+        if (--_capture_depth == 0)
+        {
+            end_element();
+        }
+    }
+    else if (_depth == 1)
+    {
+        // A top-level member has been fully traversed
+        if (_section == Section::PROFILES)
+        {
+            _profiles_done = true;
+            flush_deferred_jobs();
+        }
+        _section = Section::NONE;
+    }
+
+    return true;
+}
+
+bool WorkloadJsonReader::StartArray()
+{
+    if (begin_value())
+    {
+        _element_writer.StartArray();
+        ++_capture_depth;
+    }
+    else if (_depth == 0)
+    {
+        xbt_assert(false, "%s: not a JSON object", _error_prefix.c_str());
+    }
+    else if (_depth == 1)
+    {
+        xbt_assert(_section != Section::NB_RES, "%s: the 'nb_res' field is not an integer", _error_prefix.c_str());
+        xbt_assert(_section != Section::PROFILES, "%s: the 'profiles' member is not an object", _error_prefix.c_str());
+    }
+
+    ++_depth;
+    return true;
+}
+
+bool WorkloadJsonReader::EndArray(SizeType element_count)
+{
+    --_depth;
+
+    if (_capturing)
+    {
+        _element_writer.EndArray(element_count);
+        if (--_capture_depth == 0)
+        {
+            end_element();
+        }
+    }
+    else if (_depth == 1)
+    {
+        _section = Section::NONE;
+    }
+
+    return true;
+}
+
+bool WorkloadJsonReader::begin_value()
+{
+    if (!_capturing && _depth == 2 &&
+        ((_section == Section::PROFILES && _read_profiles) || (_section == Section::JOBS && _read_jobs)))
+    {
+        _element_text.Clear();
+        _element_writer.Reset(_element_text);
+        _capturing = true;
+        _capture_depth = 0;
+    }
+
+    return _capturing;
+}
+
+void WorkloadJsonReader::end_captured_scalar()
+{
+    if (_capture_depth == 0)
+    {
+        end_element();
+    }
+}
+
+void WorkloadJsonReader::on_uncaptured_scalar(bool is_int, int int_value)
+{
+    xbt_assert(_depth > 0, "%s: not a JSON object", _error_prefix.c_str());
+
+    if (_depth == 1)
+    {
+        switch (_section)
+        {
+        case Section::NB_RES:
+            xbt_assert(is_int, "%s: the 'nb_res' field is not an integer", _error_prefix.c_str());
+            _nb_res = int_value;
+            break;
+        case Section::PROFILES:
+            xbt_assert(false, "%s: the 'profiles' member is not an object", _error_prefix.c_str());
+            break;
+        case Section::JOBS:
+            xbt_assert(false, "%s: the 'jobs' member is not an array", _error_prefix.c_str());
+            break;
+        case Section::NONE:
+        case Section::OTHER:
+            break;
+        }
+        _section = Section::NONE;
+    }
+}
+
+void WorkloadJsonReader::end_element()
+{
+    _capturing = false;
+
+    if (_section == Section::PROFILES)
+    {
+        dispatch_element(_element_text.GetString(), _element_text.GetSize(), &_profile_name);
+    }
+    else if (_profiles_done || !_read_profiles)
+    {
+        dispatch_element(_element_text.GetString(), _element_text.GetSize(), nullptr);
+    }
+    else
+    {
+        // Jobs reference profiles by name: they can only be built once all profiles are known
+        _deferred_jobs.emplace_back(_element_text.GetString(), _element_text.GetSize());
+    }
+}
+
+void WorkloadJsonReader::flush_deferred_jobs()
+{
+    for (const string & job_text : _deferred_jobs)
+    {
+        dispatch_element(job_text.c_str(), job_text.size(), nullptr);
+    }
+
+    vector<string>().swap(_deferred_jobs);
+}
+
+void WorkloadJsonReader::dispatch_element(const char * text, size_t length, const std::string * profile_name)
+{
+    {
+        Document element(&_pool);
+        element.Parse(text, length);
+        xbt_assert(!element.HasParseError(), "%s: internal error: a captured element could not be parsed back",
+                   _error_prefix.c_str());
+
+        if (profile_name != nullptr)
+        {
+            (*_on_profile)(*profile_name, element);
+        }
+        else
+        {
+            (*_on_job)(element);
+            ++_nb_jobs_read;
+        }
+    }
+
+    // Releases the memory of the element, but keeps the initial buffer for the next one
+    _pool.Clear();
+}
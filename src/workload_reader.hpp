@@ -0,0 +1,170 @@
+/**
+ * @file workload_reader.hpp
+ * @brief Contains the streaming reader of JSON workload files
+ */
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <rapidjson/document.h>
+#include <rapidjson/reader.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+/**
+ * @brief Reads a JSON workload file in a streaming fashion
+ * @details The file is traversed by a rapidjson SAX Reader through a fixed-size buffer.
+ *          Only the profile or job being read is materialized as a JSON value, which is handed
+ *          to a callback then released. Memory usage therefore does not depend on the workload size.
+ *          When both profiles and jobs are read, jobs that appear before the 'profiles' object are kept
+ *          (as compact JSON text) until all profiles have been read, as jobs reference profiles by name.
+ */
+class WorkloadJsonReader : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, WorkloadJsonReader>
+{
+public:
+    /**
+     * @brief The function called on each profile of the workload, in file order
+     * @param[in] profile_name The profile name (its key in the 'profiles' object)
+     * @param[in] profile_desc The JSON description of the profile
+     */
+    typedef std::function<void (const std::string & profile_name, const rapidjson::Value & profile_desc)> ProfileCallback;
+
+    /**
+     * @brief The function called on each job of the workload, after the profiles it may reference have been read
+     * @param[in] job_desc The JSON description of the job
+     */
+    typedef std::function<void (const rapidjson::Value & job_desc)> JobCallback;
+
+    /**
+     * @brief Builds a WorkloadJsonReader
+     * @param[in] json_filename The name of the JSON workload file to read
+     * @param[in] read_buffer_size The size of the buffer used to read the file
+     */
+    explicit WorkloadJsonReader(const std::string & json_filename,
+                                size_t read_buffer_size = 64*1024);
+
+    /**
+     * @brief WorkloadJsonReader cannot be copied.
+     * @param[in] other Another instance
+     */
+    WorkloadJsonReader(const WorkloadJsonReader & other) = delete;
+
+    /**
+     * @brief Reads the whole file, calling the callbacks on each profile and job
+     * @details An empty callback means that the corresponding elements are skipped without being materialized.
+     * @param[in] on_profile The function called on each profile
+     * @param[in] on_job The function called on each job
+     * @pre The file is a valid JSON workload
+     */
+    void read(const ProfileCallback & on_profile,
+              const JobCallback & on_job);
+
+    /**
+     * @brief Returns the number of resources of the workload (its 'nb_res' field)
+     * @return The number of resources of the workload
+     * @pre read() has been called
+     */
+    int nb_res() const;
+
+    /**
+     * @brief Returns the number of jobs read so far
+     * @return The number of jobs read so far
+     */
+    unsigned int nb_jobs_read() const;
+
+    // SAX handler interface, called by rapidjson::Reader. Do not call directly.
+    bool Null(); //!< SAX handler: null value
+    bool Bool(bool b); //!< SAX handler: boolean value
+    bool Int(int i); //!< SAX handler: int value
+    bool Uint(unsigned u); //!< SAX handler: unsigned value
+    bool Int64(int64_t i); //!< SAX handler: int64 value
+    bool Uint64(uint64_t u); //!< SAX handler: uint64 value
+    bool Double(double d); //!< SAX handler: double value
+    bool String(const char * str, rapidjson::SizeType length, bool copy); //!< SAX handler: string value
+    bool StartObject(); //!< SAX handler: object start
+    bool Key(const char * str, rapidjson::SizeType length, bool copy); //!< SAX handler: object key
+    bool EndObject(rapidjson::SizeType member_count); //!< SAX handler: object end
+    bool StartArray(); //!< SAX handler: array start
+    bool EndArray(rapidjson::SizeType element_count); //!< SAX handler: array end
+
+private:
+    /**
+     * @brief The top-level member of the workload object currently being traversed
+     */
+    enum class Section
+    {
+         NONE       //!< Not in a top-level member (or in the root object itself)
+        ,NB_RES     //!< In the 'nb_res' member
+        ,PROFILES   //!< In the 'profiles' object
+        ,JOBS       //!< In the 'jobs' array
+        ,OTHER      //!< In any other member, which is skipped
+    };
+
+    /**
+     * @brief Called at the beginning of every value. Starts capturing an element (a profile or a job) if the value is one.
+     * @return Whether the value belongs to an element being captured
+     */
+    bool begin_value();
+
+    /**
+     * @brief Called after a captured scalar value has been written. Ends the element if the scalar is the element itself.
+     */
+    void end_captured_scalar();
+
+    /**
+     * @brief Handles a scalar value which is not part of a captured element
+     * @param[in] is_int Whether the value is an integer that fits an int
+     * @param[in] int_value The value if is_int is true
+     */
+    void on_uncaptured_scalar(bool is_int = false, int int_value = 0);
+
+    /**
+     * @brief Hands the element that has just been captured to the right callback, or defers it
+     */
+    void end_element();
+
+    /**
+     * @brief Hands the jobs met before the profiles to the job callback
+     */
+    void flush_deferred_jobs();
+
+    /**
+     * @brief Parses a captured JSON text into a JSON value then hands it to a callback
+     * @param[in] text The JSON text of the element
+     * @param[in] length The length of the JSON text
+     * @param[in] profile_name The profile name if the element is a profile, nullptr for jobs
+     */
+    void dispatch_element(const char * text, size_t length, const std::string * profile_name);
+
+private:
+    std::string _filename; //!< The name of the file being read
+    std::string _error_prefix; //!< The prefix of error messages
+    std::vector<char> _read_buffer; //!< The buffer through which the file is read
+    std::vector<char> _pool_buffer; //!< The initial (reused) memory of _pool
+    rapidjson::MemoryPoolAllocator<> _pool; //!< The allocator of the element being materialized, cleared after each element
+
+    const ProfileCallback * _on_profile = nullptr; //!< The callback called on each profile
+    const JobCallback * _on_job = nullptr; //!< The callback called on each job
+    bool _read_profiles = false; //!< Whether profiles are handed to a callback or skipped
+    bool _read_jobs = false; //!< Whether jobs are handed to a callback or skipped
+
+    int _depth = 0; //!< The current nesting level (0 outside of the root value, 1 within the root object)
+    Section _section = Section::NONE; //!< The top-level member currently being traversed
+    bool _nb_res_seen = false; //!< Whether the 'nb_res' member has been met
+    int _nb_res = -1; //!< The value of the 'nb_res' member
+    bool _profiles_seen = false; //!< Whether the 'profiles' object has been met
+    bool _profiles_done = false; //!< Whether the 'profiles' object has been fully read
+    bool _jobs_seen = false; //!< Whether the 'jobs' array has been met
+
+    bool _capturing = false; //!< Whether an element is currently being captured
+    int _capture_depth = 0; //!< The nesting level within the element being captured
+    std::string _profile_name; //!< The name of the profile being captured
+    rapidjson::StringBuffer _element_text; //!< The JSON text of the element being captured
+    rapidjson::Writer<rapidjson::StringBuffer> _element_writer; //!< Writes the captured element into _element_text
+
+    std::vector<std::string> _deferred_jobs; //!< The jobs met before the profiles were read, as JSON texts
+    unsigned int _nb_jobs_read = 0; //!< The number of jobs handed to the job callback
+};
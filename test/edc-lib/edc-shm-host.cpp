@@ -0,0 +1,104 @@
+// Hosts an external decision component library in its own process, and serves it to Batsim via shared memory.
+// Usage: edc-shm-host <segment-name> <edc-library-path>
+// Batsim should then be called with an EDC socket endpoint set to 'shm://<segment-name>', for example:
+//   batsim -p platform.xml -w workload.json -s 'shm://<segment-name>' 0 ''
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "edc_shm.hpp"
+
+typedef uint8_t (*InitFunction)(const uint8_t *, uint32_t, uint32_t);
+typedef uint8_t (*DeinitFunction)();
+typedef uint8_t (*TakeDecisionsFunction)(const uint8_t *, uint32_t, uint8_t **, uint32_t *);
+
+static void * load_symbol(void * lib_handle, const char * symbol)
+{
+    void * address = dlsym(lib_handle, symbol);
+    if (address == nullptr)
+    {
+        fprintf(stderr, "Could not load symbol '%s': %s\n", symbol, dlerror());
+        exit(1);
+    }
+    return address;
+}
+
+int main(int argc, char ** argv)
+{
+    if (argc != 3)
+    {
+        fprintf(stderr, "usage: %s <segment-name> <edc-library-path>\n", argv[0]);
+        return 1;
+    }
+    const std::string segment_name = argv[1];
+    const std::string lib_path = argv[2];
+
+    void * lib_handle = dlopen(lib_path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (lib_handle == nullptr)
+    {
+        fprintf(stderr, "Could not load EDC library '%s': %s\n", lib_path.c_str(), dlerror());
+        return 1;
+    }
+    auto init = (InitFunction) load_symbol(lib_handle, "batsim_edc_init");
+    auto deinit = (DeinitFunction) load_symbol(lib_handle, "batsim_edc_deinit");
+    auto take_decisions = (TakeDecisionsFunction) load_symbol(lib_handle, "batsim_edc_take_decisions");
+
+    edc_shm::Channel * channel = nullptr;
+    try
+    {
+        channel = edc_shm::Channel::create(segment_name);
+    }
+    catch (const std::runtime_error & e)
+    {
+        fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    printf("Serving '%s' on shm://%s\n", lib_path.c_str(), segment_name.c_str());
+    fflush(stdout);
+
+    int return_code = 0;
+    std::vector<uint8_t> message;
+    try
+    {
+        // The first message is the initialization one: flags(uint32), data_size(uint32), data(data_size octets)
+        if (channel->receive(message) < 2 * sizeof(uint32_t))
+            throw std::runtime_error("invalid initialization message");
+        uint32_t flags, data_size;
+        memcpy(&flags, message.data(), sizeof(uint32_t));
+        memcpy(&data_size, message.data() + sizeof(uint32_t), sizeof(uint32_t));
+        if (init(message.data() + 2 * sizeof(uint32_t), data_size, flags) != 0)
+            throw std::runtime_error("batsim_edc_init failed");
+        channel->send(nullptr, 0);
+
+        // Then, every message asks for decisions, until Batsim closes the channel
+        while (true)
+        {
+            const uint32_t message_size = channel->receive(message);
+
+            uint8_t * decisions = nullptr;
+            uint32_t decisions_size = 0;
+            if (take_decisions(message.data(), message_size, &decisions, &decisions_size) != 0)
+                throw std::runtime_error("batsim_edc_take_decisions failed");
+            channel->send(decisions, decisions_size);
+        }
+    }
+    catch (const std::runtime_error & e)
+    {
+        // Batsim closing the channel is the normal way to end
+        if (!channel->is_closed())
+        {
+            fprintf(stderr, "%s\n", e.what());
+            return_code = 1;
+        }
+    }
+
+    deinit();
+    delete channel;
+    dlclose(lib_handle);
+    return return_code;
+}
@@ -0,0 +1,286 @@
+#include <cmath>
+#include <cstdint>
+#include <list>
+#include <map>
+
+#include <batprotocol.hpp>
+#include <intervalset.hpp>
+
+#include "batsim_edc.h"
+
+using namespace batprotocol;
+
+struct SchedJob
+{
+    std::string job_id;
+    uint8_t nb_hosts;
+};
+
+// The value(s) emitted by a probe in the current message
+struct EmittedData
+{
+    double timestamp = -1;
+    std::vector<double> values;
+};
+
+MessageBuilder * mb = nullptr;
+bool format_binary = true; // whether flatbuffers binary or json format should be used
+std::list<SchedJob*> * jobs = nullptr;
+SchedJob * currently_running_job = nullptr;
+uint32_t platform_nb_hosts = 0;
+bool probes_running = false;
+bool all_jobs_submitted = false;
+double epsilon = 1e-6; // relative
+uint64_t nb_checked_emissions = 0;
+
+// The probes created by this EDC, all of them emit at the same times
+const std::vector<std::string> probe_ids = {"energy-vec", "energy-sum", "energy-mean", "energy-delta", "energy-ema", "energy-window-mean"};
+std::map<std::string, EmittedData> emitted; // by probe_id
+std::vector<double> previous_host_energy;
+std::vector<double> host_energy_ema;
+const double ema_alpha = 0.5;
+
+uint8_t batsim_edc_init(const uint8_t * data, uint32_t size, uint32_t flags)
+{
+    (void) data;
+    (void) size;
+    format_binary = ((flags & BATSIM_EDC_FORMAT_BINARY) != 0);
+    if ((flags & (BATSIM_EDC_FORMAT_BINARY | BATSIM_EDC_FORMAT_JSON)) != flags)
+    {
+        printf("Unknown flags used, cannot initialize myself.\n");
+        return 1;
+    }
+
+    mb = new MessageBuilder(!format_binary);
+    jobs = new std::list<SchedJob*>();
+
+    return 0;
+}
+
+uint8_t batsim_edc_deinit()
+{
+    delete mb;
+    mb = nullptr;
+
+    emitted.clear();
+    previous_host_energy.clear();
+    host_energy_ema.clear();
+
+    if (jobs != nullptr)
+    {
+        for (auto * job : *jobs)
+        {
+            delete job;
+        }
+        delete jobs;
+        jobs = nullptr;
+    }
+
+    if (nb_checked_emissions == 0)
+    {
+        printf("probe-aggregation did not check any emission\n");
+        return 1;
+    }
+
+    return 0;
+}
+
+static void check_close(const std::string & what, double value, double expected_value)
+{
+    if (fabs(value - expected_value) > epsilon * std::max(1.0, fabs(expected_value)))
+    {
+        char * err_cstr;
+        asprintf(&err_cstr, "inconsistent probe data: %s is %.6f while %.6f is expected (tested with relative epsilon=%g)",
+            what.c_str(), value, expected_value, epsilon
+        );
+        std::string err(err_cstr);
+        free(err_cstr);
+        throw std::runtime_error(err);
+    }
+}
+
+// Checks the values emitted by all the probes at the same time against the ones of the vectorial probe
+static void check_emitted_data()
+{
+    const auto & host_energy = emitted["energy-vec"].values;
+    if (host_energy.size() != platform_nb_hosts)
+    {
+        throw std::runtime_error("probe 'energy-vec' sent an invalid vectorial data: empty or unexpected number of elements");
+    }
+
+    double sum_energy = 0;
+    for (const double & energy : host_energy)
+        sum_energy += energy;
+
+    check_close("the value of probe 'energy-sum'", emitted["energy-sum"].values[0], sum_energy);
+    check_close("the value of probe 'energy-mean'", emitted["energy-mean"].values[0], sum_energy / platform_nb_hosts);
+
+    // The probe with reset emits the energy consumed since its previous emission
+    const auto & delta_energy = emitted["energy-delta"].values;
+    if (delta_energy.size() != platform_nb_hosts)
+    {
+        throw std::runtime_error("probe 'energy-delta' sent an invalid vectorial data: empty or unexpected number of elements");
+    }
+    for (uint32_t i = 0; i < platform_nb_hosts; ++i)
+    {
+        check_close("the value of probe 'energy-delta' on host " + std::to_string(i), delta_energy[i], host_energy[i] - previous_host_energy[i]);
+    }
+
+    // The temporal aggregations are applied on the values of each host, the first emission only aggregates one value
+    const auto & ema_energy = emitted["energy-ema"].values;
+    const auto & window_mean_energy = emitted["energy-window-mean"].values;
+    if (ema_energy.size() != platform_nb_hosts || window_mean_energy.size() != platform_nb_hosts)
+    {
+        throw std::runtime_error("probe 'energy-ema' or 'energy-window-mean' sent an invalid vectorial data: empty or unexpected number of elements");
+    }
+    for (uint32_t i = 0; i < platform_nb_hosts; ++i)
+    {
+        if (nb_checked_emissions == 0)
+            host_energy_ema[i] = host_energy[i];
+        else
+            host_energy_ema[i] += ema_alpha * (host_energy[i] - host_energy_ema[i]);
+        check_close("the value of probe 'energy-ema' on host " + std::to_string(i), ema_energy[i], host_energy_ema[i]);
+
+        const double expected_window_mean = (nb_checked_emissions == 0) ? host_energy[i] : (host_energy[i] + previous_host_energy[i]) / 2;
+        check_close("the value of probe 'energy-window-mean' on host " + std::to_string(i), window_mean_energy[i], expected_window_mean);
+    }
+
+    previous_host_energy = host_energy;
+    ++nb_checked_emissions;
+}
+
+uint8_t batsim_edc_take_decisions(
+    const uint8_t * what_happened,
+    uint32_t what_happened_size,
+    uint8_t ** decisions,
+    uint32_t * decisions_size)
+{
+    (void) what_happened_size;
+    auto * parsed = deserialize_message(*mb, !format_binary, what_happened);
+    mb->clear(parsed->now());
+
+    auto nb_events = parsed->events()->size();
+    for (unsigned int i = 0; i < nb_events; ++i) {
+        auto event = (*parsed->events())[i];
+        printf("probe-aggregation received event type='%s'\n", batprotocol::fb::EnumNamesEvent()[event->event_type()]);
+        switch (event->event_type())
+        {
+        case fb::Event_BatsimHelloEvent: {
+            mb->add_edc_hello("probe-aggregation", "0.1.0");
+        } break;
+        case fb::Event_SimulationBeginsEvent: {
+            auto simu_begins = event->event_as_SimulationBeginsEvent();
+            platform_nb_hosts = simu_begins->computation_host_number();
+            previous_host_energy.resize(platform_nb_hosts, 0.0);
+            host_energy_ema.resize(platform_nb_hosts, 0.0);
+
+            // Run energy probes on all hosts each second, which only differ by how they aggregate data
+            IntervalSet all_hosts = IntervalSet::ClosedInterval(0, platform_nb_hosts-1);
+            auto when = TemporalTrigger::make_periodic(1);
+            auto make_probe = [&]() {
+                auto cp = batprotocol::CreateProbe::make_temporal_triggerred(when);
+                cp->set_resources_as_hosts(all_hosts.to_string_hyphen());
+                return cp;
+            };
+
+            auto cp = make_probe();
+            cp->enable_accumulation_no_reset();
+            mb->add_create_probe("energy-vec", batprotocol::fb::Metrics_Power, cp);
+
+            cp = make_probe();
+            cp->enable_accumulation_no_reset();
+            cp->set_resource_aggregation_as_sum();
+            mb->add_create_probe("energy-sum", batprotocol::fb::Metrics_Power, cp);
+
+            cp = make_probe();
+            cp->enable_accumulation_no_reset();
+            cp->set_resource_aggregation_as_arithmetic_mean();
+            mb->add_create_probe("energy-mean", batprotocol::fb::Metrics_Power, cp);
+
+            cp = make_probe();
+            cp->enable_accumulation_with_reset(0.0);
+            mb->add_create_probe("energy-delta", batprotocol::fb::Metrics_Power, cp);
+
+            cp = make_probe();
+            cp->enable_accumulation_no_reset();
+            cp->set_temporal_aggregation_as_exponential_moving_average(ema_alpha);
+            mb->add_create_probe("energy-ema", batprotocol::fb::Metrics_Power, cp);
+
+            cp = make_probe();
+            cp->enable_accumulation_no_reset();
+            cp->set_temporal_aggregation_as_sliding_window_mean(2);
+            mb->add_create_probe("energy-window-mean", batprotocol::fb::Metrics_Power, cp);
+
+            probes_running = true;
+        } break;
+        case fb::Event_JobSubmittedEvent: {
+            auto parsed_job = event->event_as_JobSubmittedEvent();
+            auto job = new SchedJob();
+            job->job_id = parsed_job->job_id()->str();
+
+            job->nb_hosts = parsed_job->job()->resource_request();
+            if (job->nb_hosts > platform_nb_hosts) {
+                mb->add_reject_job(job->job_id);
+                delete job;
+            }
+            else {
+                jobs->push_back(job);
+            }
+        } break;
+        case fb::Event_JobCompletedEvent: {
+            delete currently_running_job;
+            currently_running_job = nullptr;
+        } break;
+        case fb::Event_AllStaticJobsHaveBeenSubmittedEvent: {
+            all_jobs_submitted = true;
+        } break;
+        case fb::Event_ProbeDataEmittedEvent: {
+            auto e = event->event_as_ProbeDataEmittedEvent();
+            auto & data = emitted[e->probe_id()->str()];
+            data.timestamp = event->timestamp();
+            data.values.clear();
+            if (e->data_type() == fb::ProbeData_VectorialProbeData) {
+                auto vec = e->data_as_VectorialProbeData()->data();
+                for (unsigned int j = 0; vec != nullptr && j < vec->size(); ++j)
+                    data.values.push_back(vec->Get(j));
+            } else {
+                data.values.push_back(e->data_as_AggregatedProbeData()->data());
+            }
+        } break;
+        default: break;
+        }
+    }
+
+    // check the data of the probes once all of them have emitted at the same time
+    if (emitted.size() == probe_ids.size()) {
+        const double timestamp = emitted[probe_ids[0]].timestamp;
+        bool same_timestamp = true;
+        for (const auto & probe_id : probe_ids)
+            same_timestamp = same_timestamp && emitted[probe_id].timestamp == timestamp;
+
+        if (same_timestamp) {
+            check_emitted_data();
+            emitted.clear();
+        }
+    }
+
+    // execute jobs one by one
+    if (currently_running_job == nullptr && !jobs->empty()) {
+        currently_running_job = jobs->front();
+        jobs->pop_front();
+        auto hosts = IntervalSet(IntervalSet::ClosedInterval(0, currently_running_job->nb_hosts-1));
+        mb->add_execute_job(currently_running_job->job_id, hosts.to_string_hyphen());
+    }
+
+    // stop probes when all jobs have been executed, so the simulation can finish
+    if (probes_running && all_jobs_submitted && currently_running_job == nullptr && jobs->empty()) {
+        printf("probe-aggregation stopping probes\n");
+        for (const auto & probe_id : probe_ids)
+            mb->add_stop_probe(probe_id);
+        probes_running = false;
+    }
+
+    mb->finish_message(parsed->now());
+    serialize_message(*mb, !format_binary, const_cast<const uint8_t **>(decisions), decisions_size);
+    return 0;
+}
@@ -34,6 +34,15 @@ std::string behavior = "unset";
 
 double all_hosts_energy = 0.0;
 std::vector<double> host_energy;
+uint32_t hosts_vec_nb_emitted = 0;
+
+uint64_t oneshot_probe_time = 2; // the one-shot probe measures the energy of all the hosts once, at this time (in seconds)
+bool oneshot_probe_emitted = false;
+
+// another one-shot probe is created with a target time that is already reached: it should emit in the reply to the message that created it
+double oneshot_now_creation_time = -1;
+bool oneshot_now_expected = false;
+bool oneshot_now_emitted = false;
 
 uint8_t batsim_edc_init(const uint8_t * data, uint32_t size, uint32_t flags)
 {
@@ -76,6 +85,18 @@ uint8_t batsim_edc_deinit()
         jobs = nullptr;
     }
 
+    if (!oneshot_probe_emitted)
+    {
+        printf("probe 'hosts-oneshot' never emitted its data\n");
+        return 1;
+    }
+
+    if (!oneshot_now_emitted)
+    {
+        printf("probe 'hosts-oneshot-now' never emitted its data\n");
+        return 1;
+    }
+
     return 0;
 }
 
@@ -89,6 +110,10 @@ uint8_t batsim_edc_take_decisions(
     auto * parsed = deserialize_message(*mb, !format_binary, what_happened);
     mb->clear(parsed->now());
 
+    // the one-shot probe created in the previous call with an already reached target time must emit in this message
+    const bool oneshot_now_expected_in_this_message = oneshot_now_expected;
+    oneshot_now_expected = false;
+
     double new_probe_call_time = -1;
 
     auto nb_events = parsed->events()->size();
@@ -116,6 +141,26 @@ uint8_t batsim_edc_take_decisions(
             cp->set_resource_aggregation_as_sum();
             mb->add_create_probe("hosts-agg", batprotocol::fb::Metrics_Power, cp);
 
+            // Also run a one-shot probe that gives the sum of the energy of all the hosts once
+            auto oneshot_when = TemporalTrigger::make_one_shot(oneshot_probe_time);
+            oneshot_when->set_time_unit(fb::TimeUnit_Second);
+            auto oneshot_cp = batprotocol::CreateProbe::make_temporal_triggerred(oneshot_when);
+            oneshot_cp->set_resources_as_hosts(all_hosts.to_string_hyphen());
+            oneshot_cp->enable_accumulation_no_reset();
+            oneshot_cp->set_resource_aggregation_as_sum();
+            mb->add_create_probe("hosts-oneshot", batprotocol::fb::Metrics_Power, oneshot_cp);
+
+            // And a one-shot probe whose target time is already reached, which should be measured right away
+            auto oneshot_now_when = TemporalTrigger::make_one_shot(0);
+            oneshot_now_when->set_time_unit(fb::TimeUnit_Second);
+            auto oneshot_now_cp = batprotocol::CreateProbe::make_temporal_triggerred(oneshot_now_when);
+            oneshot_now_cp->set_resources_as_hosts(all_hosts.to_string_hyphen());
+            oneshot_now_cp->enable_accumulation_no_reset();
+            oneshot_now_cp->set_resource_aggregation_as_sum();
+            mb->add_create_probe("hosts-oneshot-now", batprotocol::fb::Metrics_Power, oneshot_now_cp);
+            oneshot_now_creation_time = parsed->now();
+            oneshot_now_expected = true;
+
             probes_running = true;
         } break;
         case fb::Event_JobSubmittedEvent: {
@@ -143,7 +188,65 @@ uint8_t batsim_edc_take_decisions(
             auto e = event->event_as_ProbeDataEmittedEvent();
             double per_host_minimum_energy_increase = (event->timestamp() - last_call_time) * min_power;
             double per_host_maximum_energy_increase = (event->timestamp() - last_call_time) * max_power;
-            if (e->probe_id()->str() == "hosts-vec") {
+            if (e->probe_id()->str() == "hosts-oneshot") {
+                // the one-shot probe is never triggered by a period, it emits once at its target time
+                if (oneshot_probe_emitted || fabs(event->timestamp() - oneshot_probe_time) > epsilon) {
+                    throw std::runtime_error("probe 'hosts-oneshot' emitted data more than once or at an unexpected time (" + std::to_string(event->timestamp()) + ")");
+                }
+                if (!e->manually_triggered() || e->nb_triggered() != 0 || e->nb_emitted() != 1) {
+                    throw std::runtime_error("probe 'hosts-oneshot' emitted invalid counters: manually_triggered=" + std::to_string(e->manually_triggered()) +
+                        ", nb_triggered=" + std::to_string(e->nb_triggered()) + ", nb_emitted=" + std::to_string(e->nb_emitted()));
+                }
+                double energy = e->data_as_AggregatedProbeData()->data();
+                double minimum_energy = oneshot_probe_time * min_power * platform_nb_hosts;
+                double maximum_energy = oneshot_probe_time * max_power * platform_nb_hosts;
+                if (energy + epsilon < minimum_energy || energy - epsilon > maximum_energy) {
+                    char * err_cstr;
+                    asprintf(&err_cstr, "probe 'hosts-oneshot' sent an invalid aggregated data: "
+                        "the hosts consumed %.6f while it should be in the [%.6f, %.6f] range (tested with epsilon=%.6f)",
+                        energy, minimum_energy, maximum_energy, epsilon
+                    );
+                    std::string err(err_cstr);
+                    free(err_cstr);
+                    throw std::runtime_error(err);
+                }
+                oneshot_probe_emitted = true;
+                continue; // the one-shot probe does not take part in the consistency checks of the periodic probes
+            }
+            else if (e->probe_id()->str() == "hosts-oneshot-now") {
+                // the one-shot probe with an already reached target time emits once, right after its creation
+                if (oneshot_now_emitted || !oneshot_now_expected_in_this_message || fabs(event->timestamp() - oneshot_now_creation_time) > epsilon) {
+                    throw std::runtime_error("probe 'hosts-oneshot-now' emitted data more than once, in an unexpected message or at an unexpected time (" + std::to_string(event->timestamp()) + ")");
+                }
+                if (!e->manually_triggered() || e->nb_triggered() != 0 || e->nb_emitted() != 1) {
+                    throw std::runtime_error("probe 'hosts-oneshot-now' emitted invalid counters: manually_triggered=" + std::to_string(e->manually_triggered()) +
+                        ", nb_triggered=" + std::to_string(e->nb_triggered()) + ", nb_emitted=" + std::to_string(e->nb_emitted()));
+                }
+                double energy = e->data_as_AggregatedProbeData()->data();
+                double minimum_energy = oneshot_now_creation_time * min_power * platform_nb_hosts;
+                double maximum_energy = oneshot_now_creation_time * max_power * platform_nb_hosts;
+                if (energy + epsilon < minimum_energy || energy - epsilon > maximum_energy) {
+                    char * err_cstr;
+                    asprintf(&err_cstr, "probe 'hosts-oneshot-now' sent an invalid aggregated data: "
+                        "the hosts consumed %.6f while it should be in the [%.6f, %.6f] range (tested with epsilon=%.6f)",
+                        energy, minimum_energy, maximum_energy, epsilon
+                    );
+                    std::string err(err_cstr);
+                    free(err_cstr);
+                    throw std::runtime_error(err);
+                }
+                oneshot_now_emitted = true;
+                continue; // the one-shot probe does not take part in the consistency checks of the periodic probes
+            }
+            else if (e->probe_id()->str() == "hosts-vec") {
+                // periodic probes are triggered once to be initialized, then emit at each trigger
+                ++hosts_vec_nb_emitted;
+                if (e->manually_triggered() || e->nb_emitted() != hosts_vec_nb_emitted || e->nb_triggered() != hosts_vec_nb_emitted + 1) {
+                    throw std::runtime_error("probe 'hosts-vec' emitted invalid counters: manually_triggered=" + std::to_string(e->manually_triggered()) +
+                        ", nb_triggered=" + std::to_string(e->nb_triggered()) + ", nb_emitted=" + std::to_string(e->nb_emitted()) +
+                        " while it emitted " + std::to_string(hosts_vec_nb_emitted) + " times");
+                }
+
                 auto data = e->data_as_VectorialProbeData()->data();
                 if (data == nullptr || data->size() != platform_nb_hosts) {
                     throw std::runtime_error("probe 'hosts-vec' sent an invalid vectorial data: empty or unexpected number of elements");
@@ -178,6 +281,10 @@ uint8_t batsim_edc_take_decisions(
         }
     }
 
+    if (oneshot_now_expected_in_this_message && !oneshot_now_emitted) {
+        throw std::runtime_error("probe 'hosts-oneshot-now' did not emit its data in the reply to the message that created it");
+    }
+
     // if probe data has been received, update time & check energy consistency
     if (new_probe_call_time != -1) {
         if (last_call_time != -1) {
@@ -0,0 +1,287 @@
+#include <cmath>
+#include <cstdint>
+#include <list>
+
+#include <batprotocol.hpp>
+#include <intervalset.hpp>
+
+#include "batsim_edc.h"
+
+using namespace batprotocol;
+
+struct SchedJob
+{
+    std::string job_id;
+    uint8_t nb_hosts;
+};
+
+MessageBuilder * mb = nullptr;
+bool format_binary = true; // whether flatbuffers binary or json format should be used
+std::list<SchedJob*> * jobs = nullptr;
+SchedJob * currently_running_job = nullptr;
+uint32_t platform_nb_hosts = 0;
+bool probes_running = false;
+bool all_jobs_submitted = false;
+double min_power = 10.0; // the power of each link when it is idle, as set in the platform
+double max_power = 20.0; // the power of each link when it is fully used, as set in the platform
+double last_call_time = 0;
+double epsilon = 1e-3;
+bool some_link_has_been_used = false;
+double last_load_call_time = 0;
+bool some_host_has_computed = false;
+bool some_link_has_had_traffic = false;
+
+const std::vector<std::string> links = {"0", "1", "2", "3", "4", "5", "6", "7", "8", "9"};
+std::vector<double> link_energy;
+double all_links_energy = 0.0;
+std::vector<double> host_computing_time;
+
+uint8_t batsim_edc_init(const uint8_t * data, uint32_t size, uint32_t flags)
+{
+    (void) data;
+    (void) size;
+    format_binary = ((flags & BATSIM_EDC_FORMAT_BINARY) != 0);
+    if ((flags & (BATSIM_EDC_FORMAT_BINARY | BATSIM_EDC_FORMAT_JSON)) != flags)
+    {
+        printf("Unknown flags used, cannot initialize myself.\n");
+        return 1;
+    }
+
+    mb = new MessageBuilder(!format_binary);
+    jobs = new std::list<SchedJob*>();
+    link_energy.resize(links.size(), 0.0);
+
+    return 0;
+}
+
+uint8_t batsim_edc_deinit()
+{
+    delete mb;
+    mb = nullptr;
+
+    link_energy.clear();
+    host_computing_time.clear();
+
+    if (jobs != nullptr)
+    {
+        for (auto * job : *jobs)
+        {
+            delete job;
+        }
+        delete jobs;
+        jobs = nullptr;
+    }
+
+    // network jobs have been executed, so at least one link should have consumed more than its idle power
+    if (!some_link_has_been_used)
+    {
+        printf("probe 'links-vec' never measured a link consuming more than its idle power\n");
+        return 1;
+    }
+
+    // jobs have been executed, so at least one host should have computed
+    if (!some_host_has_computed)
+    {
+        printf("probe 'hosts-load' never measured a host spending time computing\n");
+        return 1;
+    }
+
+    // network jobs have been executed, so at least one link should have had some traffic
+    if (!some_link_has_had_traffic)
+    {
+        printf("probe 'links-traffic' never measured a link with some traffic\n");
+        return 1;
+    }
+
+    return 0;
+}
+
+uint8_t batsim_edc_take_decisions(
+    const uint8_t * what_happened,
+    uint32_t what_happened_size,
+    uint8_t ** decisions,
+    uint32_t * decisions_size)
+{
+    (void) what_happened_size;
+    auto * parsed = deserialize_message(*mb, !format_binary, what_happened);
+    mb->clear(parsed->now());
+
+    double new_probe_call_time = -1;
+
+    auto nb_events = parsed->events()->size();
+    for (unsigned int i = 0; i < nb_events; ++i) {
+        auto event = (*parsed->events())[i];
+        printf("probe-links received event type='%s'\n", batprotocol::fb::EnumNamesEvent()[event->event_type()]);
+        switch (event->event_type())
+        {
+        case fb::Event_BatsimHelloEvent: {
+            mb->add_edc_hello("probe-links", "0.1.0");
+        } break;
+        case fb::Event_SimulationBeginsEvent: {
+            auto simu_begins = event->event_as_SimulationBeginsEvent();
+            platform_nb_hosts = simu_begins->computation_host_number();
+            host_computing_time.resize(platform_nb_hosts, 0.0);
+
+            // Run two energy probes on the links between computation hosts: one that gives the energy of each link every 10 seconds, and one that gives their sum
+            auto when = TemporalTrigger::make_periodic(10);
+            auto cp = batprotocol::CreateProbe::make_temporal_triggerred(when);
+            cp->set_resources_as_links(links);
+            cp->enable_accumulation_no_reset();
+            mb->add_create_probe("links-vec", batprotocol::fb::Metrics_Power, cp);
+
+            cp->set_resource_aggregation_as_sum();
+            mb->add_create_probe("links-agg", batprotocol::fb::Metrics_Power, cp);
+
+            // Also probe the time spent computing by each host every 10 seconds, and the current traffic of the links each second
+            cp = batprotocol::CreateProbe::make_temporal_triggerred(when);
+            cp->set_resources_as_hosts(IntervalSet(IntervalSet::ClosedInterval(0, platform_nb_hosts-1)).to_string_hyphen());
+            cp->enable_accumulation_no_reset();
+            mb->add_create_probe("hosts-load", batprotocol::fb::Metrics_Load, cp);
+
+            cp = batprotocol::CreateProbe::make_temporal_triggerred(TemporalTrigger::make_periodic(1));
+            cp->set_resources_as_links(links);
+            mb->add_create_probe("links-traffic", batprotocol::fb::Metrics_Traffic, cp);
+
+            probes_running = true;
+        } break;
+        case fb::Event_JobSubmittedEvent: {
+            auto parsed_job = event->event_as_JobSubmittedEvent();
+            auto job = new SchedJob();
+            job->job_id = parsed_job->job_id()->str();
+
+            job->nb_hosts = parsed_job->job()->resource_request();
+            if (job->nb_hosts > platform_nb_hosts) {
+                mb->add_reject_job(job->job_id);
+                delete job;
+            }
+            else {
+                jobs->push_back(job);
+            }
+        } break;
+        case fb::Event_JobCompletedEvent: {
+            delete currently_running_job;
+            currently_running_job = nullptr;
+        } break;
+        case fb::Event_AllStaticJobsHaveBeenSubmittedEvent: {
+            all_jobs_submitted = true;
+        } break;
+        case fb::Event_ProbeDataEmittedEvent: {
+            auto e = event->event_as_ProbeDataEmittedEvent();
+            double per_link_minimum_energy_increase = (event->timestamp() - last_call_time) * min_power;
+            double per_link_maximum_energy_increase = (event->timestamp() - last_call_time) * max_power;
+            if (e->probe_id()->str() == "links-vec") {
+                auto data = e->data_as_VectorialProbeData()->data();
+                if (data == nullptr || data->size() != links.size()) {
+                    throw std::runtime_error("probe 'links-vec' sent an invalid vectorial data: empty or unexpected number of elements");
+                }
+                // check energy increase consistency of each link
+                for (uint32_t i = 0; i < links.size(); ++i) {
+                    double link_energy_diff = data->Get(i) - link_energy[i];
+                    if ((link_energy_diff + epsilon < per_link_minimum_energy_increase) ||
+                        (link_energy_diff - epsilon > per_link_maximum_energy_increase)) {
+                        char * err_cstr;
+                        asprintf(&err_cstr, "probe 'links-vec' sent an invalid vectorial data: "
+                            "link '%s' energy increased by %.6f while it should be in the [%.6f, %.6f] range (tested with epsilon=%.6f)",
+                            links[i].c_str(), link_energy_diff,
+                            per_link_minimum_energy_increase, per_link_maximum_energy_increase,
+                            epsilon
+                        );
+                        std::string err(err_cstr);
+                        free(err_cstr);
+                        throw std::runtime_error(err);
+                    }
+                    if (link_energy_diff - epsilon > per_link_minimum_energy_increase) {
+                        some_link_has_been_used = true;
+                    }
+                    link_energy[i] = data->Get(i);
+                }
+                new_probe_call_time = event->timestamp();
+            } else if (e->probe_id()->str() == "links-agg") {
+                all_links_energy = e->data_as_AggregatedProbeData()->data();
+                new_probe_call_time = event->timestamp();
+            } else if (e->probe_id()->str() == "hosts-load") {
+                auto data = e->data_as_VectorialProbeData()->data();
+                if (data == nullptr || data->size() != platform_nb_hosts) {
+                    throw std::runtime_error("probe 'hosts-load' sent an invalid vectorial data: empty or unexpected number of elements");
+                }
+                // a host cannot spend more time computing than the time elapsed since the previous emission
+                double elapsed_time = event->timestamp() - last_load_call_time;
+                for (uint32_t i = 0; i < platform_nb_hosts; ++i) {
+                    double computing_time_diff = data->Get(i) - host_computing_time[i];
+                    if (computing_time_diff + epsilon < 0 || computing_time_diff - epsilon > elapsed_time) {
+                        char * err_cstr;
+                        asprintf(&err_cstr, "probe 'hosts-load' sent an invalid vectorial data: "
+                            "host %u computing time increased by %.6f while it should be in the [0, %.6f] range (tested with epsilon=%.6f)",
+                            i, computing_time_diff, elapsed_time, epsilon
+                        );
+                        std::string err(err_cstr);
+                        free(err_cstr);
+                        throw std::runtime_error(err);
+                    }
+                    if (computing_time_diff > epsilon) {
+                        some_host_has_computed = true;
+                    }
+                    host_computing_time[i] = data->Get(i);
+                }
+                last_load_call_time = event->timestamp();
+            } else if (e->probe_id()->str() == "links-traffic") {
+                auto data = e->data_as_VectorialProbeData()->data();
+                if (data == nullptr || data->size() != links.size()) {
+                    throw std::runtime_error("probe 'links-traffic' sent an invalid vectorial data: empty or unexpected number of elements");
+                }
+                for (uint32_t i = 0; i < links.size(); ++i) {
+                    if (data->Get(i) < 0) {
+                        throw std::runtime_error("probe 'links-traffic' sent a negative traffic for link '" + links[i] + "'");
+                    }
+                    if (data->Get(i) > 0) {
+                        some_link_has_had_traffic = true;
+                    }
+                }
+            }
+        } break;
+        default: break;
+        }
+    }
+
+    // if probe data has been received, update time & check energy consistency
+    if (new_probe_call_time != -1) {
+        double my_sum_energy = 0.0;
+        for (auto & e : link_energy)
+            my_sum_energy += e;
+
+        double total_energy_diff = all_links_energy - my_sum_energy;
+        if (fabs(total_energy_diff) > epsilon) {
+            char * err_cstr;
+            asprintf(&err_cstr, "inconsistent energy state: the aggregated probe last value is %.6f, while the sum the vectorial probe last value is %.6f (tested with epsilon=%.6f)",
+                all_links_energy, my_sum_energy,
+                epsilon
+            );
+            std::string err(err_cstr);
+            free(err_cstr);
+            throw std::runtime_error(err);
+        }
+        last_call_time = new_probe_call_time;
+    }
+
+    // execute jobs one by one
+    if (currently_running_job == nullptr && !jobs->empty()) {
+        currently_running_job = jobs->front();
+        jobs->pop_front();
+        auto hosts = IntervalSet(IntervalSet::ClosedInterval(0, currently_running_job->nb_hosts-1));
+        mb->add_execute_job(currently_running_job->job_id, hosts.to_string_hyphen());
+    }
+
+    // stop probes when all jobs have been executed, so the simulation can finish
+    if (probes_running && all_jobs_submitted && currently_running_job == nullptr && jobs->empty()) {
+        printf("probe-links stopping probes\n");
+        mb->add_stop_probe("links-vec");
+        mb->add_stop_probe("links-agg");
+        mb->add_stop_probe("hosts-load");
+        mb->add_stop_probe("links-traffic");
+        probes_running = false;
+    }
+
+    mb->finish_message(parsed->now());
+    serialize_message(*mb, !format_binary, const_cast<const uint8_t **>(decisions), decisions_size);
+    return 0;
+}
@@ -23,6 +23,10 @@ def behavior(request):
 def inter_stop_probe_delay(request):
     return request.param
 
+@pytest.fixture(scope="module", params=[False, True])
+def use_json(request):
+    return request.param
+
 def test_energy(test_root_dir, behavior, inter_stop_probe_delay):
     platform = 'cluster_energy_128'
     workload = 'test_homo_ptasks'
@@ -38,3 +42,25 @@ def test_energy(test_root_dir, behavior, inter_stop_probe_delay):
     batcmd, outdir, _ = prepare_instance(instance_name, test_root_dir, platform, 'probe-energy', workload, edc_init_content=json.dumps(edc_init_args, allow_nan=False, sort_keys=True), batsim_extra_args=batargs)
     p = run_batsim(batcmd, outdir)
     assert p.returncode == 0
+
+def test_aggregation(test_root_dir, use_json):
+    platform = 'cluster_energy_128'
+    workload = 'test_homo_ptasks'
+    func_name = inspect.currentframe().f_code.co_name.replace('test_', '', 1)
+    instance_name = f'{MOD_NAME}-{func_name}-' + str(int(use_json))
+
+    batargs = ["--energy-host"]
+    batcmd, outdir, _ = prepare_instance(instance_name, test_root_dir, platform, 'probe-aggregation', workload, use_json=use_json, batsim_extra_args=batargs)
+    p = run_batsim(batcmd, outdir)
+    assert p.returncode == 0
+
+def test_link_energy(test_root_dir, use_json):
+    platform = 'energy_platform_homogeneous_links'
+    workload = 'test_ptasks'
+    func_name = inspect.currentframe().f_code.co_name.replace('test_', '', 1)
+    instance_name = f'{MOD_NAME}-{func_name}-' + str(int(use_json))
+
+    batargs = ["--energy-link"]
+    batcmd, outdir, _ = prepare_instance(instance_name, test_root_dir, platform, 'probe-links', workload, use_json=use_json, batsim_extra_args=batargs)
+    p = run_batsim(batcmd, outdir)
+    assert p.returncode == 0
@@ -121,3 +121,26 @@ def test_extra_data(test_root_dir, extra_data_workload, use_json):
             print('All jobs are valid!')
             printable_df = df[['job_id', 'expected_allocation', 'allocated_resources']]
             print(printable_df)
+
+def test_fcfs_shm(test_root_dir, use_json):
+    platform = 'small_platform'
+    workload = 'test_delays'
+    func_name = inspect.currentframe().f_code.co_name.replace('test_', '', 1)
+    instance_name = f'{MOD_NAME}-{func_name}-' + str(int(use_json))
+
+    batcmd, outdir, _ = prepare_instance(instance_name, test_root_dir, platform, 'fcfs', workload, use_json=use_json)
+    segment_name = f'batsim-test-{os.getpid()}-{int(use_json)}'
+    edc_index = batcmd.index('--edc-library-file')
+    edc_lib = batcmd[edc_index+1]
+    batcmd[edc_index:edc_index+2] = ['--edc-socket-file', f'shm://{segment_name}']
+
+    with open(f'{outdir}/edc-shm-host.stdout', 'w') as outfile:
+        host = subprocess.Popen(['edc-shm-host', segment_name, edc_lib], stdout=outfile, stderr=subprocess.STDOUT)
+        try:
+            p = run_batsim(batcmd, outdir)
+            assert p.returncode == 0
+            assert host.wait(timeout=5) == 0
+        finally:
+            if host.poll() is None:
+                host.kill()
+            host.wait()
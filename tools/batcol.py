@@ -0,0 +1,197 @@
+#!/usr/bin/env python3
+
+"""Reads Batsim's columnar output files (.batcol)."""
+
+import argparse
+import csv
+import itertools
+import math
+import struct
+import sys
+from enum import Enum, unique
+
+MAGIC = b'BATCOL\0\0'
+FORMAT_VERSION = 1
+BYTE_ORDER_MARK = 0x01020304
+
+
+@unique
+class ColumnType(Enum):
+    """Maps column type codes and their meaning."""
+
+    INT64 = 1
+    FLOAT64 = 2
+    STRING = 3
+    DICTIONARY_STRING = 4
+
+
+def _read_exactly(f, size, filename):
+    data = f.read(size)
+    if len(data) != size:
+        raise ValueError('Invalid columnar file {}: truncated file'.format(filename))
+    return data
+
+
+def _decode_strings(data, offset, lengths):
+    values = []
+    for length in lengths:
+        values.append(data[offset:offset + length].decode('utf-8'))
+        offset += length
+    return values, offset
+
+
+def _decode_column(column_type, data, nb_rows, byte_order):
+    if column_type == ColumnType.INT64:
+        return list(struct.unpack('{}{}q'.format(byte_order, nb_rows), data))
+    if column_type == ColumnType.FLOAT64:
+        return list(struct.unpack('{}{}d'.format(byte_order, nb_rows), data))
+    if column_type == ColumnType.STRING:
+        lengths = struct.unpack_from('{}{}I'.format(byte_order, nb_rows), data)
+        values, _ = _decode_strings(data, 4 * nb_rows, lengths)
+        return values
+    # DICTIONARY_STRING
+    (nb_entries,) = struct.unpack_from('{}I'.format(byte_order), data)
+    lengths = struct.unpack_from('{}{}I'.format(byte_order, nb_entries), data, 4)
+    entries, offset = _decode_strings(data, 4 + 4 * nb_entries, lengths)
+    codes = struct.unpack_from('{}{}I'.format(byte_order, nb_rows), data, offset)
+    return [entries[code] for code in codes]
+
+
+def _decode_column_array(column_type, data, nb_rows, byte_order):
+    import numpy as np
+    if column_type == ColumnType.INT64:
+        return np.frombuffer(data, dtype=byte_order + 'i8', count=nb_rows).astype(np.int64, copy=False)
+    if column_type == ColumnType.FLOAT64:
+        return np.frombuffer(data, dtype=byte_order + 'f8', count=nb_rows).astype(np.float64, copy=False)
+    if column_type == ColumnType.STRING:
+        lengths = np.frombuffer(data, dtype=byte_order + 'u4', count=nb_rows)
+        values, _ = _decode_strings(data, 4 * nb_rows, lengths.tolist())
+        return np.array(values, dtype=object)
+    # DICTIONARY_STRING: only the entries are decoded one by one, values are gathered from their codes
+    (nb_entries,) = struct.unpack_from('{}I'.format(byte_order), data)
+    lengths = np.frombuffer(data, dtype=byte_order + 'u4', count=nb_entries, offset=4)
+    entries, offset = _decode_strings(data, 4 + 4 * nb_entries, lengths.tolist())
+    codes = np.frombuffer(data, dtype=byte_order + 'u4', count=nb_rows, offset=offset)
+    return np.array(entries, dtype=object)[codes]
+
+
+def _read_column_chunks(filename, decode_column):
+    """Read a columnar file, decoding each column of each row group with decode_column.
+
+    Return a list of (column name, column type) and a dict that maps each
+    column name to the list of its decoded chunks (one per row group).
+    """
+    with open(filename, 'rb') as f:
+        header = _read_exactly(f, 24, filename)
+        if header[0:8] != MAGIC:
+            raise ValueError('Invalid columnar file {}: not a columnar file'.format(filename))
+
+        # The byte order mark tells the byte order of the whole file
+        if struct.unpack('<I', header[12:16])[0] == BYTE_ORDER_MARK:
+            byte_order = '<'
+        elif struct.unpack('>I', header[12:16])[0] == BYTE_ORDER_MARK:
+            byte_order = '>'
+        else:
+            raise ValueError('Invalid columnar file {}: unknown byte order'.format(filename))
+
+        format_version, _, nb_columns, _ = struct.unpack(byte_order + 'IIII', header[8:24])
+        if format_version != FORMAT_VERSION:
+            raise ValueError('Unsupported columnar file {}: format version {}'.format(filename, format_version))
+
+        columns = []
+        for _ in range(nb_columns):
+            column_type, _, name_size = struct.unpack(byte_order + 'BBH', _read_exactly(f, 4, filename))
+            name = _read_exactly(f, name_size, filename).decode('utf-8')
+            columns.append((name, ColumnType(column_type)))
+
+        chunks = {name: [] for name, _ in columns}
+        while True:
+            row_group_header = f.read(8)
+            if len(row_group_header) == 0:
+                break
+            if len(row_group_header) != 8:
+                raise ValueError('Invalid columnar file {}: truncated file'.format(filename))
+            nb_rows, _ = struct.unpack(byte_order + 'II', row_group_header)
+
+            for name, column_type in columns:
+                (data_size,) = struct.unpack(byte_order + 'Q', _read_exactly(f, 8, filename))
+                data = _read_exactly(f, data_size, filename)
+                chunks[name].append(decode_column(column_type, data, nb_rows, byte_order))
+
+    return columns, chunks
+
+
+def read_batcol(filename):
+    """Read a columnar file.
+
+    Return a list of (column name, column type) and a dict that maps each
+    column name to the list of its values. Missing floating-point values are NaN.
+    """
+    columns, chunks = _read_column_chunks(filename, _decode_column)
+    values = {name: list(itertools.chain.from_iterable(chunks[name])) for name, _ in columns}
+    return columns, values
+
+
+def read_batcol_as_dataframe(filename):
+    """Read a columnar file into a pandas DataFrame (requires numpy and pandas).
+
+    Numeric columns and dictionary codes are decoded as numpy arrays directly from the file data.
+    """
+    import numpy as np
+    import pandas as pd
+    empty_dtypes = {
+        ColumnType.INT64: np.int64,
+        ColumnType.FLOAT64: np.float64,
+        ColumnType.STRING: object,
+        ColumnType.DICTIONARY_STRING: object,
+    }
+    columns, chunks = _read_column_chunks(filename, _decode_column_array)
+    arrays = {}
+    for name, column_type in columns:
+        if chunks[name]:
+            arrays[name] = np.concatenate(chunks[name])
+        else:
+            arrays[name] = np.empty(0, dtype=empty_dtypes[column_type])
+    return pd.DataFrame(arrays)
+
+
+def _format_csv_value(value):
+    if isinstance(value, float):
+        return '' if math.isnan(value) else repr(value)
+    return value
+
+
+def write_csv(filename, output):
+    """Convert a columnar file into CSV."""
+    columns, values = read_batcol(filename)
+    writer = csv.writer(output, lineterminator='\n')
+    writer.writerow([name for name, _ in columns])
+    nb_rows = len(values[columns[0][0]]) if columns else 0
+    for i in range(nb_rows):
+        writer.writerow([_format_csv_value(values[name][i]) for name, _ in columns])
+
+
+def main():
+    """Convert a columnar file into CSV, or describe its columns."""
+    parser = argparse.ArgumentParser(description='Reads Batsim columnar output files (.batcol).')
+    parser.add_argument('input_file', help='The columnar file to read')
+    parser.add_argument('-o', '--output-file', help='The CSV file to write (standard output if unset)')
+    parser.add_argument('--describe', action='store_true',
+                        help='Print the columns and the number of rows instead of converting to CSV')
+    args = parser.parse_args()
+
+    if args.describe:
+        columns, values = read_batcol(args.input_file)
+        nb_rows = len(values[columns[0][0]]) if columns else 0
+        print('{} rows'.format(nb_rows))
+        for name, column_type in columns:
+            print('{}: {}'.format(name, column_type.name))
+    elif args.output_file is not None:
+        with open(args.output_file, 'w', newline='') as output:
+            write_csv(args.input_file, output)
+    else:
+        write_csv(args.input_file, sys.stdout)
+
+
+if __name__ == '__main__':
+    main()